@@ -3,4 +3,4 @@
 # clash with the log4cxx_VERSION* variables automatically
 # defined by the project() command.
 set(log4cxx_VER 1.2.0.0)
-set(log4cxx_ABI_VER 15)
+set(log4cxx_ABI_VER 16)
@@ -21,6 +21,7 @@
 #include <algorithm>
 #include <log4cxx/helpers/pool.h>
 #include <mutex>
+#include <log4cxx/private/atomic_shared_ptr.h>
 
 using namespace log4cxx;
 using namespace log4cxx::helpers;
@@ -28,11 +29,36 @@ using namespace log4cxx::spi;
 
 IMPLEMENT_LOG4CXX_OBJECT(AppenderAttachableImpl)
 
+namespace
+{
+typedef std::shared_ptr<const AppenderList> AppenderListPtr;
+}
+
 struct AppenderAttachableImpl::priv_data
 {
-	/** Array of appenders. */
-	AppenderList  appenderList;
-	mutable std::recursive_mutex m_mutex;
+	priv_data() : appenderList(std::make_shared<const AppenderList>()) {}
+
+	/** Array of appenders. Replaced, never modified, while holding m_mutex. */
+	AtomicSharedPtr<const AppenderList> appenderList;
+
+	/** Serializes changes to appenderList. */
+	std::mutex m_mutex;
+
+	/**
+	 * The current list of appenders.
+	 */
+	AppenderListPtr getAppenders() const
+	{
+		return appenderList.load();
+	}
+
+	/**
+	 * Make \c newList the current list of appenders.
+	 */
+	void setAppenders(const AppenderListPtr& newList)
+	{
+		appenderList.store(newList);
+	}
 };
 
 
@@ -54,13 +80,16 @@ void AppenderAttachableImpl::addAppender(const AppenderPtr newAppender)
 		return;
 	}
 
-	std::lock_guard<std::recursive_mutex> lock( m_priv->m_mutex );
-	AppenderList::iterator it = std::find(
-			m_priv->appenderList.begin(), m_priv->appenderList.end(), newAppender);
+	std::lock_guard<std::mutex> lock( m_priv->m_mutex );
+	AppenderListPtr current = m_priv->getAppenders();
+	AppenderList::const_iterator it = std::find(
+			current->begin(), current->end(), newAppender);
 
-	if (it == m_priv->appenderList.end())
+	if (it == current->end())
 	{
-		m_priv->appenderList.push_back(newAppender);
+		auto newList = std::make_shared<AppenderList>(*current);
+		newList->push_back(newAppender);
+		m_priv->setAppenders(newList);
 	}
 }
 
@@ -69,13 +98,11 @@ int AppenderAttachableImpl::appendLoopOnAppenders(
 	Pool& p)
 {
 	int numberAppended = 0;
-	std::lock_guard<std::recursive_mutex> lock( m_priv->m_mutex );
 	// FallbackErrorHandler::error() may modify our list of appenders
 	// while we are iterating over them (if it holds the same logger).
-	// So, make a local copy of the appenders that we want to iterate over
-	// before actually iterating over them.
-	AppenderList allAppenders = m_priv->appenderList;
-	for (auto appender : allAppenders)
+	// Changes replace the list, so the snapshot remains valid.
+	AppenderListPtr allAppenders = m_priv->getAppenders();
+	for (auto& appender : *allAppenders)
 	{
 		appender->doAppend(event, p);
 		numberAppended++;
@@ -84,10 +111,24 @@ int AppenderAttachableImpl::appendLoopOnAppenders(
 	return numberAppended;
 }
 
+int AppenderAttachableImpl::appendLoopOnAppenders(
+	const spi::LoggingEventList& events,
+	Pool& p)
+{
+	int numberAppended = 0;
+	AppenderListPtr allAppenders = m_priv->getAppenders();
+	for (auto& appender : *allAppenders)
+	{
+		appender->doAppend(events, p);
+		numberAppended++;
+	}
+
+	return numberAppended;
+}
+
 AppenderList AppenderAttachableImpl::getAllAppenders() const
 {
-	std::lock_guard<std::recursive_mutex> lock( m_priv->m_mutex );
-	return m_priv->appenderList;
+	return *m_priv->getAppenders();
 }
 
 AppenderPtr AppenderAttachableImpl::getAppender(const LogString& name) const
@@ -97,14 +138,10 @@ AppenderPtr AppenderAttachableImpl::getAppender(const LogString& name) const
 		return 0;
 	}
 
-	std::lock_guard<std::recursive_mutex> lock( m_priv->m_mutex );
-	AppenderList::const_iterator it, itEnd = m_priv->appenderList.end();
-	AppenderPtr appender;
+	AppenderListPtr current = m_priv->getAppenders();
 
-	for (it = m_priv->appenderList.begin(); it != itEnd; it++)
+	for (auto& appender : *current)
 	{
-		appender = *it;
-
 		if (name == appender->getName())
 		{
 			return appender;
@@ -121,26 +158,27 @@ bool AppenderAttachableImpl::isAttached(const AppenderPtr appender) const
 		return false;
 	}
 
-	std::lock_guard<std::recursive_mutex> lock( m_priv->m_mutex );
+	AppenderListPtr current = m_priv->getAppenders();
 	AppenderList::const_iterator it = std::find(
-			m_priv->appenderList.begin(), m_priv->appenderList.end(), appender);
+			current->begin(), current->end(), appender);
 
-	return it != m_priv->appenderList.end();
+	return it != current->end();
 }
 
 void AppenderAttachableImpl::removeAllAppenders()
 {
-	std::lock_guard<std::recursive_mutex> lock( m_priv->m_mutex );
-	AppenderList::iterator it, itEnd = m_priv->appenderList.end();
-	AppenderPtr a;
+	AppenderListPtr removed;
+	{
+		std::lock_guard<std::mutex> lock( m_priv->m_mutex );
+		removed = m_priv->getAppenders();
+		m_priv->setAppenders(std::make_shared<AppenderList>());
+	}
 
-	for (it = m_priv->appenderList.begin(); it != itEnd; it++)
+	// Closing an appender may call back into this object
+	for (auto& a : *removed)
 	{
-		a = *it;
 		a->close();
 	}
-
-	m_priv->appenderList.clear();
 }
 
 void AppenderAttachableImpl::removeAppender(const AppenderPtr appender)
@@ -150,13 +188,16 @@ void AppenderAttachableImpl::removeAppender(const AppenderPtr appender)
 		return;
 	}
 
-	std::lock_guard<std::recursive_mutex> lock( m_priv->m_mutex );
-	AppenderList::iterator it = std::find(
-			m_priv->appenderList.begin(), m_priv->appenderList.end(), appender);
+	std::lock_guard<std::mutex> lock( m_priv->m_mutex );
+	AppenderListPtr current = m_priv->getAppenders();
+	AppenderList::const_iterator it = std::find(
+			current->begin(), current->end(), appender);
 
-	if (it != m_priv->appenderList.end())
+	if (it != current->end())
 	{
-		m_priv->appenderList.erase(it);
+		auto newList = std::make_shared<AppenderList>(*current);
+		newList->erase(newList->begin() + (it - current->begin()));
+		m_priv->setAppenders(newList);
 	}
 }
 
@@ -167,20 +208,18 @@ void AppenderAttachableImpl::removeAppender(const LogString& name)
 		return;
 	}
 
-	std::lock_guard<std::recursive_mutex> lock( m_priv->m_mutex );
-	AppenderList::iterator it, itEnd = m_priv->appenderList.end();
-	AppenderPtr appender;
+	std::lock_guard<std::mutex> lock( m_priv->m_mutex );
+	AppenderListPtr current = m_priv->getAppenders();
 
-	for (it = m_priv->appenderList.begin(); it != itEnd; it++)
+	for (AppenderList::const_iterator it = current->begin(); it != current->end(); it++)
 	{
-		appender = *it;
-
-		if (name == appender->getName())
+		if (name == (*it)->getName())
 		{
-			m_priv->appenderList.erase(it);
+			auto newList = std::make_shared<AppenderList>(*current);
+			newList->erase(newList->begin() + (it - current->begin()));
+			m_priv->setAppenders(newList);
 			return;
 		}
 	}
 }
 
-
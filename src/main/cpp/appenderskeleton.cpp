@@ -30,6 +30,65 @@ using namespace log4cxx::helpers;
 
 IMPLEMENT_LOG4CXX_OBJECT(AppenderSkeleton)
 
+namespace
+{
+/**
+ * Does the filter chain starting at \c f allow \c event to be logged?
+ */
+bool isAccepted(FilterPtr f, const LoggingEventPtr& event)
+{
+	while (f != 0)
+	{
+		switch (f->decide(event))
+		{
+			case Filter::DENY:
+				return false;
+
+			case Filter::ACCEPT:
+				return true;
+
+			case Filter::NEUTRAL:
+				f = f->getNext();
+		}
+	}
+
+	return true;
+}
+
+/**
+ * Does the filter chain \c filters allow \c event to be logged?
+ */
+bool isAccepted(const std::vector<FilterPtr>& filters, const LoggingEventPtr& event)
+{
+	for (auto& f : filters)
+	{
+		switch (f->decide(event))
+		{
+			case Filter::DENY:
+				return false;
+
+			case Filter::ACCEPT:
+				return true;
+
+			case Filter::NEUTRAL:
+				break;
+		}
+	}
+
+	return true;
+}
+
+/**
+ * Is \c event at or above \c threshold and allowed by \c filters?
+ */
+template <class Filters>
+bool isAppendable(const LevelPtr& threshold, const Filters& filters, const LoggingEventPtr& event)
+{
+	const LevelPtr& level = event->getLevel();
+	return (!level || level->isGreaterOrEqual(threshold)) && isAccepted(filters, event);
+}
+}
+
 AppenderSkeleton::AppenderSkeleton( std::unique_ptr<AppenderSkeletonPrivate> priv )
 	:   m_priv(std::move(priv))
 {
@@ -75,21 +134,30 @@ void AppenderSkeleton::addFilter(const spi::FilterPtr newFilter)
 		m_priv->tailFilter->setNext(newFilter);
 		m_priv->tailFilter = newFilter;
 	}
+
+	m_priv->publishSettings();
 }
 
 void AppenderSkeleton::clearFilters()
 {
 	std::lock_guard<std::recursive_mutex> lock(m_priv->mutex);
 	m_priv->headFilter = m_priv->tailFilter = nullptr;
+	m_priv->publishSettings();
 }
 
 bool AppenderSkeleton::isAsSevereAsThreshold(const LevelPtr& level) const
 {
-	return ((level == 0) || level->isGreaterOrEqual(m_priv->threshold));
+	return ((level == 0) || level->isGreaterOrEqual(m_priv->snapshot.load()->threshold));
 }
 
 void AppenderSkeleton::doAppend(const spi::LoggingEventPtr& event, Pool& pool1)
 {
+	if (m_priv->concurrent)
+	{
+		doAppendImpl(event, pool1);
+		return;
+	}
+
 	std::lock_guard<std::recursive_mutex> lock(m_priv->mutex);
 
 	doAppendImpl(event, pool1);
@@ -104,31 +172,94 @@ void AppenderSkeleton::doAppendImpl(const spi::LoggingEventPtr& event, Pool& poo
 		return;
 	}
 
-	if (!isAsSevereAsThreshold(event->getLevel()))
+	if (m_priv->concurrent)
+	{
+		auto snapshot = m_priv->snapshot.load();
+
+		if (!isAppendable(snapshot->threshold, snapshot->filters, event))
+		{
+			return;
+		}
+	}
+	else if (!isAppendable(m_priv->threshold, m_priv->headFilter, event))
+	{
+		return;
+	}
+
+	append(event, pool1);
+}
+
+void AppenderSkeleton::doAppend(const spi::LoggingEventList& events, Pool& pool1)
+{
+	if (m_priv->concurrent)
 	{
+		doAppendImpl(events, pool1);
 		return;
 	}
 
-	FilterPtr f = m_priv->headFilter;
+	std::lock_guard<std::recursive_mutex> lock(m_priv->mutex);
 
+	doAppendImpl(events, pool1);
+}
 
-	while (f != 0)
+void AppenderSkeleton::doAppendImpl(const spi::LoggingEventList& events, Pool& pool1)
+{
+	if (m_priv->closed)
 	{
-		switch (f->decide(event))
-		{
-			case Filter::DENY:
-				return;
+		LogLog::error(((LogString) LOG4CXX_STR("Attempted to append to closed appender named ["))
+			+ m_priv->name + LOG4CXX_STR("]."));
+		return;
+	}
 
-			case Filter::ACCEPT:
-				f = nullptr;
-				break;
+	LoggingEventList accepted;
+	accepted.reserve(events.size());
 
-			case Filter::NEUTRAL:
-				f = f->getNext();
+	if (m_priv->concurrent)
+	{
+		auto snapshot = m_priv->snapshot.load();
+
+		for (auto& event : events)
+		{
+			if (isAppendable(snapshot->threshold, snapshot->filters, event))
+			{
+				accepted.push_back(event);
+			}
+		}
+	}
+	else
+	{
+		for (auto& event : events)
+		{
+			if (isAppendable(m_priv->threshold, m_priv->headFilter, event))
+			{
+				accepted.push_back(event);
+			}
 		}
 	}
 
-	append(event, pool1);
+	if (!accepted.empty())
+	{
+		append(accepted, pool1);
+	}
+}
+
+void AppenderSkeleton::append(const spi::LoggingEventList& events, Pool& pool1)
+{
+	for (auto& event : events)
+	{
+		append(event, pool1);
+	}
+}
+
+void AppenderSkeleton::setConcurrent(bool value)
+{
+	std::lock_guard<std::recursive_mutex> lock(m_priv->mutex);
+	m_priv->concurrent = value;
+}
+
+bool AppenderSkeleton::isConcurrent() const
+{
+	return m_priv->concurrent;
 }
 
 void AppenderSkeleton::setErrorHandler(const spi::ErrorHandlerPtr errorHandler1)
@@ -144,6 +275,7 @@ void AppenderSkeleton::setErrorHandler(const spi::ErrorHandlerPtr errorHandler1)
 	else
 	{
 		m_priv->errorHandler = errorHandler1;
+		m_priv->publishSettings();
 	}
 }
 
@@ -151,6 +283,7 @@ void AppenderSkeleton::setThreshold(const LevelPtr& threshold1)
 {
 	std::lock_guard<std::recursive_mutex> lock(m_priv->mutex);
 	m_priv->threshold = threshold1;
+	m_priv->publishSettings();
 }
 
 void AppenderSkeleton::setOption(const LogString& option,
@@ -165,17 +298,19 @@ void AppenderSkeleton::setOption(const LogString& option,
 
 const spi::ErrorHandlerPtr AppenderSkeleton::getErrorHandler() const
 {
-	return m_priv->errorHandler;
+	return m_priv->snapshot.load()->errorHandler;
 }
 
 spi::FilterPtr AppenderSkeleton::getFilter() const
 {
-	return m_priv->headFilter;
+	auto snapshot = m_priv->snapshot.load();
+	return snapshot->filters.empty() ? spi::FilterPtr() : snapshot->filters.front();
 }
 
 const spi::FilterPtr AppenderSkeleton::getFirstFilter() const
 {
-	return m_priv->headFilter;
+	auto snapshot = m_priv->snapshot.load();
+	return snapshot->filters.empty() ? spi::FilterPtr() : snapshot->filters.front();
 }
 
 LayoutPtr AppenderSkeleton::getLayout() const
@@ -190,7 +325,7 @@ LogString AppenderSkeleton::getName() const
 
 const LevelPtr AppenderSkeleton::getThreshold() const
 {
-	return m_priv->threshold;
+	return m_priv->snapshot.load()->threshold;
 }
 
 void AppenderSkeleton::setLayout(const LayoutPtr layout1)
@@ -0,0 +1,563 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <log4cxx/private/asciirun.h>
+
+#if defined(__x86_64__) || defined(_M_X64) || (defined(_M_IX86_FP) && 2 <= _M_IX86_FP) || defined(__SSE2__)
+	#define LOG4CXX_ASCII_RUN_SSE2 1
+	#include <emmintrin.h>
+	#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+		#define LOG4CXX_ASCII_RUN_AVX2 1
+		#include <immintrin.h>
+	#endif
+#elif defined(__aarch64__) || defined(_M_ARM64)
+	#define LOG4CXX_ASCII_RUN_NEON 1
+	#include <arm_neon.h>
+#endif
+#if defined(_MSC_VER)
+	#include <intrin.h>
+#endif
+
+using namespace log4cxx::helpers;
+
+namespace
+{
+
+#if LOG4CXX_ASCII_RUN_SSE2 || LOG4CXX_ASCII_RUN_AVX2
+/** The index of the lowest set bit of the non-zero \c mask. */
+inline size_t lowestBit(unsigned int mask)
+{
+#if defined(_MSC_VER)
+	unsigned long index;
+	_BitScanForward(&index, mask);
+	return index;
+#else
+	return __builtin_ctz(mask);
+#endif
+}
+#endif
+
+template <class Unit>
+size_t scalarLength(const Unit* src, size_t count)
+{
+	size_t i = 0;
+
+	while (i < count && src[i] < 0x80)
+	{
+		++i;
+	}
+
+	return i;
+}
+
+#if LOG4CXX_ASCII_RUN_SSE2
+size_t sse2Length(const uint8_t* src, size_t count)
+{
+	size_t i = 0;
+
+	for (; i + 16 <= count; i += 16)
+	{
+		__m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+		unsigned int mask = _mm_movemask_epi8(v);
+
+		if (mask)
+		{
+			return i + lowestBit(mask);
+		}
+	}
+
+	return i + scalarLength(src + i, count - i);
+}
+
+size_t sse2Length(const uint16_t* src, size_t count)
+{
+	const __m128i high = _mm_set1_epi16(static_cast<short>(0xFF80));
+	const __m128i zero = _mm_setzero_si128();
+	size_t i = 0;
+
+	for (; i + 8 <= count; i += 8)
+	{
+		__m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+		__m128i ascii = _mm_cmpeq_epi16(_mm_and_si128(v, high), zero);
+		unsigned int mask = ~_mm_movemask_epi8(ascii) & 0xFFFF;
+
+		if (mask)
+		{
+			return i + lowestBit(mask) / 2;
+		}
+	}
+
+	return i + scalarLength(src + i, count - i);
+}
+
+size_t sse2Length(const uint32_t* src, size_t count)
+{
+	const __m128i high = _mm_set1_epi32(static_cast<int>(0xFFFFFF80));
+	const __m128i zero = _mm_setzero_si128();
+	size_t i = 0;
+
+	for (; i + 4 <= count; i += 4)
+	{
+		__m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+		__m128i ascii = _mm_cmpeq_epi32(_mm_and_si128(v, high), zero);
+		unsigned int mask = ~_mm_movemask_epi8(ascii) & 0xFFFF;
+
+		if (mask)
+		{
+			return i + lowestBit(mask) / 4;
+		}
+	}
+
+	return i + scalarLength(src + i, count - i);
+}
+#endif
+
+#if LOG4CXX_ASCII_RUN_AVX2
+__attribute__((target("avx2")))
+size_t avx2Length(const uint8_t* src, size_t count)
+{
+	size_t i = 0;
+
+	for (; i + 32 <= count; i += 32)
+	{
+		__m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i));
+		unsigned int mask = _mm256_movemask_epi8(v);
+
+		if (mask)
+		{
+			return i + lowestBit(mask);
+		}
+	}
+
+	return i + sse2Length(src + i, count - i);
+}
+
+__attribute__((target("avx2")))
+size_t avx2Length(const uint16_t* src, size_t count)
+{
+	const __m256i high = _mm256_set1_epi16(static_cast<short>(0xFF80));
+	const __m256i zero = _mm256_setzero_si256();
+	size_t i = 0;
+
+	for (; i + 16 <= count; i += 16)
+	{
+		__m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i));
+		__m256i ascii = _mm256_cmpeq_epi16(_mm256_and_si256(v, high), zero);
+		unsigned int mask = ~static_cast<unsigned int>(_mm256_movemask_epi8(ascii));
+
+		if (mask)
+		{
+			return i + lowestBit(mask) / 2;
+		}
+	}
+
+	return i + sse2Length(src + i, count - i);
+}
+
+__attribute__((target("avx2")))
+size_t avx2Length(const uint32_t* src, size_t count)
+{
+	const __m256i high = _mm256_set1_epi32(static_cast<int>(0xFFFFFF80));
+	const __m256i zero = _mm256_setzero_si256();
+	size_t i = 0;
+
+	for (; i + 8 <= count; i += 8)
+	{
+		__m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i));
+		__m256i ascii = _mm256_cmpeq_epi32(_mm256_and_si256(v, high), zero);
+		unsigned int mask = ~static_cast<unsigned int>(_mm256_movemask_epi8(ascii));
+
+		if (mask)
+		{
+			return i + lowestBit(mask) / 4;
+		}
+	}
+
+	return i + sse2Length(src + i, count - i);
+}
+
+bool hasAVX2()
+{
+	static const bool result = (__builtin_cpu_init(), __builtin_cpu_supports("avx2"));
+	return result;
+}
+#endif
+
+#if LOG4CXX_ASCII_RUN_NEON
+template <class Unit>
+size_t neonBlockLength(const Unit* src, size_t count, size_t i, size_t blockSize)
+{
+	return i + scalarLength(src + i, (i + blockSize < count ? i + blockSize : count) - i);
+}
+
+size_t neonLength(const uint8_t* src, size_t count)
+{
+	size_t i = 0;
+
+	for (; i + 16 <= count; i += 16)
+	{
+		if (0x80 <= vmaxvq_u8(vld1q_u8(src + i)))
+		{
+			return neonBlockLength(src, count, i, 16);
+		}
+	}
+
+	return i + scalarLength(src + i, count - i);
+}
+
+size_t neonLength(const uint16_t* src, size_t count)
+{
+	size_t i = 0;
+
+	for (; i + 8 <= count; i += 8)
+	{
+		if (0x80 <= vmaxvq_u16(vld1q_u16(src + i)))
+		{
+			return neonBlockLength(src, count, i, 8);
+		}
+	}
+
+	return i + scalarLength(src + i, count - i);
+}
+
+size_t neonLength(const uint32_t* src, size_t count)
+{
+	size_t i = 0;
+
+	for (; i + 4 <= count; i += 4)
+	{
+		if (0x80 <= vmaxvq_u32(vld1q_u32(src + i)))
+		{
+			return neonBlockLength(src, count, i, 4);
+		}
+	}
+
+	return i + scalarLength(src + i, count - i);
+}
+#endif
+
+template <class Unit>
+size_t selectLength(const Unit* src, size_t count)
+{
+#if LOG4CXX_ASCII_RUN_AVX2
+	if (hasAVX2())
+	{
+		return avx2Length(src, count);
+	}
+#endif
+#if LOG4CXX_ASCII_RUN_SSE2
+	return sse2Length(src, count);
+#elif LOG4CXX_ASCII_RUN_NEON
+	return neonLength(src, count);
+#else
+	return scalarLength(src, count);
+#endif
+}
+
+template <class Unit>
+bool isEscaped(Unit ch)
+{
+	return ch == 0x22 || ch == 0x5C || (0x08 <= ch && ch <= 0x0D && ch != 0x0B);
+}
+
+template <class Unit>
+size_t scalarUnescapedLength(const Unit* src, size_t count)
+{
+	size_t i = 0;
+
+	while (i < count && !isEscaped(src[i]))
+	{
+		++i;
+	}
+
+	return i;
+}
+
+#if LOG4CXX_ASCII_RUN_SSE2
+/*
+ * The lanes of \c v holding a character escaped in a JSON string.
+ * The comparisons are signed, so lanes of 0x80 and above are not in 0x08-0x0D.
+ */
+inline __m128i escapedLanes8(__m128i v)
+{
+	__m128i special = _mm_or_si128
+		( _mm_cmpeq_epi8(v, _mm_set1_epi8(0x22))
+		, _mm_cmpeq_epi8(v, _mm_set1_epi8(0x5C))
+		);
+	__m128i control = _mm_andnot_si128
+		( _mm_cmpeq_epi8(v, _mm_set1_epi8(0x0B))
+		, _mm_and_si128(_mm_cmpgt_epi8(v, _mm_set1_epi8(0x07)), _mm_cmplt_epi8(v, _mm_set1_epi8(0x0E)))
+		);
+	return _mm_or_si128(special, control);
+}
+
+inline __m128i escapedLanes16(__m128i v)
+{
+	__m128i special = _mm_or_si128
+		( _mm_cmpeq_epi16(v, _mm_set1_epi16(0x22))
+		, _mm_cmpeq_epi16(v, _mm_set1_epi16(0x5C))
+		);
+	__m128i control = _mm_andnot_si128
+		( _mm_cmpeq_epi16(v, _mm_set1_epi16(0x0B))
+		, _mm_and_si128(_mm_cmpgt_epi16(v, _mm_set1_epi16(0x07)), _mm_cmplt_epi16(v, _mm_set1_epi16(0x0E)))
+		);
+	return _mm_or_si128(special, control);
+}
+
+inline __m128i escapedLanes32(__m128i v)
+{
+	__m128i special = _mm_or_si128
+		( _mm_cmpeq_epi32(v, _mm_set1_epi32(0x22))
+		, _mm_cmpeq_epi32(v, _mm_set1_epi32(0x5C))
+		);
+	__m128i control = _mm_andnot_si128
+		( _mm_cmpeq_epi32(v, _mm_set1_epi32(0x0B))
+		, _mm_and_si128(_mm_cmpgt_epi32(v, _mm_set1_epi32(0x07)), _mm_cmplt_epi32(v, _mm_set1_epi32(0x0E)))
+		);
+	return _mm_or_si128(special, control);
+}
+
+template <class Unit>
+size_t sse2UnescapedLength(const Unit* src, size_t count, __m128i (*escapedLanes)(__m128i))
+{
+	const size_t blockSize = 16 / sizeof(Unit);
+	size_t i = 0;
+
+	for (; i + blockSize <= count; i += blockSize)
+	{
+		__m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+		unsigned int mask = _mm_movemask_epi8(escapedLanes(v));
+
+		if (mask)
+		{
+			return i + lowestBit(mask) / sizeof(Unit);
+		}
+	}
+
+	return i + scalarUnescapedLength(src + i, count - i);
+}
+#elif LOG4CXX_ASCII_RUN_NEON
+inline uint8x16_t escapedLanes(uint8x16_t v)
+{
+	uint8x16_t special = vorrq_u8(vceqq_u8(v, vdupq_n_u8(0x22)), vceqq_u8(v, vdupq_n_u8(0x5C)));
+	uint8x16_t control = vbicq_u8
+		( vcleq_u8(vsubq_u8(v, vdupq_n_u8(0x08)), vdupq_n_u8(0x05))
+		, vceqq_u8(v, vdupq_n_u8(0x0B))
+		);
+	return vorrq_u8(special, control);
+}
+
+inline uint16x8_t escapedLanes(uint16x8_t v)
+{
+	uint16x8_t special = vorrq_u16(vceqq_u16(v, vdupq_n_u16(0x22)), vceqq_u16(v, vdupq_n_u16(0x5C)));
+	uint16x8_t control = vbicq_u16
+		( vcleq_u16(vsubq_u16(v, vdupq_n_u16(0x08)), vdupq_n_u16(0x05))
+		, vceqq_u16(v, vdupq_n_u16(0x0B))
+		);
+	return vorrq_u16(special, control);
+}
+
+inline uint32x4_t escapedLanes(uint32x4_t v)
+{
+	uint32x4_t special = vorrq_u32(vceqq_u32(v, vdupq_n_u32(0x22)), vceqq_u32(v, vdupq_n_u32(0x5C)));
+	uint32x4_t control = vbicq_u32
+		( vcleq_u32(vsubq_u32(v, vdupq_n_u32(0x08)), vdupq_n_u32(0x05))
+		, vceqq_u32(v, vdupq_n_u32(0x0B))
+		);
+	return vorrq_u32(special, control);
+}
+
+inline bool anyLane(uint8x16_t v) { return 0 != vmaxvq_u8(v); }
+inline bool anyLane(uint16x8_t v) { return 0 != vmaxvq_u16(v); }
+inline bool anyLane(uint32x4_t v) { return 0 != vmaxvq_u32(v); }
+inline uint8x16_t load(const uint8_t* p) { return vld1q_u8(p); }
+inline uint16x8_t load(const uint16_t* p) { return vld1q_u16(p); }
+inline uint32x4_t load(const uint32_t* p) { return vld1q_u32(p); }
+
+template <class Unit>
+size_t neonUnescapedLength(const Unit* src, size_t count)
+{
+	const size_t blockSize = 16 / sizeof(Unit);
+	size_t i = 0;
+
+	for (; i + blockSize <= count; i += blockSize)
+	{
+		if (anyLane(escapedLanes(load(src + i))))
+		{
+			return i + scalarUnescapedLength(src + i, blockSize);
+		}
+	}
+
+	return i + scalarUnescapedLength(src + i, count - i);
+}
+#endif
+
+template <class Src, class Dst>
+void scalarCopy(const Src* src, size_t count, Dst* dst)
+{
+	for (size_t i = 0; i < count; ++i)
+	{
+		dst[i] = static_cast<Dst>(src[i]);
+	}
+}
+
+} // namespace
+
+size_t AsciiRun::length(const uint8_t* src, size_t count)
+{
+	return selectLength(src, count);
+}
+
+size_t AsciiRun::length(const uint16_t* src, size_t count)
+{
+	return selectLength(src, count);
+}
+
+size_t AsciiRun::length(const uint32_t* src, size_t count)
+{
+	return selectLength(src, count);
+}
+
+size_t AsciiRun::unescapedLength(const uint8_t* src, size_t count)
+{
+#if LOG4CXX_ASCII_RUN_SSE2
+	return sse2UnescapedLength(src, count, escapedLanes8);
+#elif LOG4CXX_ASCII_RUN_NEON
+	return neonUnescapedLength(src, count);
+#else
+	return scalarUnescapedLength(src, count);
+#endif
+}
+
+size_t AsciiRun::unescapedLength(const uint16_t* src, size_t count)
+{
+#if LOG4CXX_ASCII_RUN_SSE2
+	return sse2UnescapedLength(src, count, escapedLanes16);
+#elif LOG4CXX_ASCII_RUN_NEON
+	return neonUnescapedLength(src, count);
+#else
+	return scalarUnescapedLength(src, count);
+#endif
+}
+
+size_t AsciiRun::unescapedLength(const uint32_t* src, size_t count)
+{
+#if LOG4CXX_ASCII_RUN_SSE2
+	return sse2UnescapedLength(src, count, escapedLanes32);
+#elif LOG4CXX_ASCII_RUN_NEON
+	return neonUnescapedLength(src, count);
+#else
+	return scalarUnescapedLength(src, count);
+#endif
+}
+
+void AsciiRun::copy(const uint8_t* src, size_t count, uint16_t* dst)
+{
+	size_t i = 0;
+#if LOG4CXX_ASCII_RUN_SSE2
+	const __m128i zero = _mm_setzero_si128();
+
+	for (; i + 16 <= count; i += 16)
+	{
+		__m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), _mm_unpacklo_epi8(v, zero));
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i + 8), _mm_unpackhi_epi8(v, zero));
+	}
+#elif LOG4CXX_ASCII_RUN_NEON
+	for (; i + 16 <= count; i += 16)
+	{
+		uint8x16_t v = vld1q_u8(src + i);
+		vst1q_u16(dst + i, vmovl_u8(vget_low_u8(v)));
+		vst1q_u16(dst + i + 8, vmovl_u8(vget_high_u8(v)));
+	}
+#endif
+	scalarCopy(src + i, count - i, dst + i);
+}
+
+void AsciiRun::copy(const uint8_t* src, size_t count, uint32_t* dst)
+{
+	size_t i = 0;
+#if LOG4CXX_ASCII_RUN_SSE2
+	const __m128i zero = _mm_setzero_si128();
+
+	for (; i + 16 <= count; i += 16)
+	{
+		__m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+		__m128i lo = _mm_unpacklo_epi8(v, zero);
+		__m128i hi = _mm_unpackhi_epi8(v, zero);
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), _mm_unpacklo_epi16(lo, zero));
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i + 4), _mm_unpackhi_epi16(lo, zero));
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i + 8), _mm_unpacklo_epi16(hi, zero));
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i + 12), _mm_unpackhi_epi16(hi, zero));
+	}
+#elif LOG4CXX_ASCII_RUN_NEON
+	for (; i + 16 <= count; i += 16)
+	{
+		uint8x16_t v = vld1q_u8(src + i);
+		uint16x8_t lo = vmovl_u8(vget_low_u8(v));
+		uint16x8_t hi = vmovl_u8(vget_high_u8(v));
+		vst1q_u32(dst + i, vmovl_u16(vget_low_u16(lo)));
+		vst1q_u32(dst + i + 4, vmovl_u16(vget_high_u16(lo)));
+		vst1q_u32(dst + i + 8, vmovl_u16(vget_low_u16(hi)));
+		vst1q_u32(dst + i + 12, vmovl_u16(vget_high_u16(hi)));
+	}
+#endif
+	scalarCopy(src + i, count - i, dst + i);
+}
+
+void AsciiRun::copy(const uint16_t* src, size_t count, uint8_t* dst)
+{
+	size_t i = 0;
+#if LOG4CXX_ASCII_RUN_SSE2
+	for (; i + 16 <= count; i += 16)
+	{
+		__m128i lo = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+		__m128i hi = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i + 8));
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), _mm_packus_epi16(lo, hi));
+	}
+#elif LOG4CXX_ASCII_RUN_NEON
+	for (; i + 16 <= count; i += 16)
+	{
+		uint8x8_t lo = vmovn_u16(vld1q_u16(src + i));
+		uint8x8_t hi = vmovn_u16(vld1q_u16(src + i + 8));
+		vst1q_u8(dst + i, vcombine_u8(lo, hi));
+	}
+#endif
+	scalarCopy(src + i, count - i, dst + i);
+}
+
+void AsciiRun::copy(const uint32_t* src, size_t count, uint8_t* dst)
+{
+	size_t i = 0;
+#if LOG4CXX_ASCII_RUN_SSE2
+	for (; i + 16 <= count; i += 16)
+	{
+		const __m128i* in = reinterpret_cast<const __m128i*>(src + i);
+		__m128i lo = _mm_packs_epi32(_mm_loadu_si128(in), _mm_loadu_si128(in + 1));
+		__m128i hi = _mm_packs_epi32(_mm_loadu_si128(in + 2), _mm_loadu_si128(in + 3));
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), _mm_packus_epi16(lo, hi));
+	}
+#elif LOG4CXX_ASCII_RUN_NEON
+	for (; i + 16 <= count; i += 16)
+	{
+		uint16x8_t lo = vcombine_u16(vmovn_u32(vld1q_u32(src + i)), vmovn_u32(vld1q_u32(src + i + 4)));
+		uint16x8_t hi = vcombine_u16(vmovn_u32(vld1q_u32(src + i + 8)), vmovn_u32(vld1q_u32(src + i + 12)));
+		vst1q_u8(dst + i, vcombine_u8(vmovn_u16(lo), vmovn_u16(hi)));
+	}
+#endif
+	scalarCopy(src + i, count - i, dst + i);
+}
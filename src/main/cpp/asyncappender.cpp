@@ -26,9 +26,15 @@
 #include <apr_thread_cond.h>
 #include <log4cxx/helpers/stringhelper.h>
 #include <apr_atomic.h>
+#include <apr_pools.h>
 #include <log4cxx/helpers/optionconverter.h>
 #include <log4cxx/helpers/threadutility.h>
 #include <log4cxx/private/appenderskeleton_priv.h>
+#include <log4cxx/private/atomic_shared_ptr.h>
+#include <atomic>
+#include <deque>
+#include <functional>
+#include <thread>
 
 using namespace log4cxx;
 using namespace log4cxx::helpers;
@@ -39,6 +45,11 @@ using namespace log4cxx::spi;
 */
 enum { DEFAULT_BUFFER_SIZE = 128 };
 
+/**
+ * The default time a producer waits for space under the BoundedWait policy.
+*/
+enum { DEFAULT_MAX_BLOCKING_TIME = 100 };
+
 class DiscardSummary
 {
 	private:
@@ -85,69 +96,891 @@ class DiscardSummary
 
 typedef std::map<LogString, DiscardSummary> DiscardMap;
 
+/**
+ * A bounded multi-producer queue of events.
+ *
+ * Each slot carries a sequence number which tells a producer
+ * whether the slot is free for the current lap and tells
+ * a consumer whether the slot has been published.
+ * Producers claim a position with a compare-and-swap on the tail,
+ * so no lock is taken unless the queue is full.
+ * The dispatcher is the usual consumer, but a producer may also
+ * remove the oldest event to make room for a new one.
+*/
+class EventRingBuffer
+{
+	private:
+		struct Slot
+		{
+			std::atomic<size_t> sequence;
+			LoggingEventPtr event;
+		};
+
+		std::vector<Slot> slots;
+		const size_t capacity;
+
+		/**
+		 * Next position to be claimed by a producer.
+		*/
+		alignas(64) std::atomic<size_t> tail;
+
+		/**
+		 * Next position to be read by the consumer.
+		*/
+		alignas(64) std::atomic<size_t> head;
+
+	public:
+		EventRingBuffer(size_t size) :
+			slots(size),
+			capacity(size),
+			tail(0),
+			head(0)
+		{
+			for (size_t i = 0; i < capacity; ++i)
+			{
+				slots[i].sequence.store(i, std::memory_order_relaxed);
+			}
+		}
+
+		size_t getCapacity() const
+		{
+			return capacity;
+		}
+
+		/**
+		 * Add \c event to the queue.
+		 *
+		 * @return false if the queue is full.
+		*/
+		bool tryPush(const LoggingEventPtr& event)
+		{
+			size_t pos = tail.load(std::memory_order_relaxed);
+
+			while (true)
+			{
+				Slot& slot = slots[pos % capacity];
+				size_t seq = slot.sequence.load(std::memory_order_acquire);
+				std::ptrdiff_t diff = (std::ptrdiff_t)seq - (std::ptrdiff_t)pos;
+
+				if (diff == 0)
+				{
+					if (tail.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+					{
+						slot.event = event;
+						slot.sequence.store(pos + 1, std::memory_order_release);
+						return true;
+					}
+				}
+				else if (diff < 0)
+				{
+					return false;
+				}
+				else
+				{
+					pos = tail.load(std::memory_order_relaxed);
+				}
+			}
+		}
+
+		/**
+		 * Remove the oldest event from the queue.
+		 *
+		 * @return false if no event has been published.
+		*/
+		bool tryPop(LoggingEventPtr& event)
+		{
+			size_t pos = head.load(std::memory_order_relaxed);
+
+			while (true)
+			{
+				Slot& slot = slots[pos % capacity];
+				size_t seq = slot.sequence.load(std::memory_order_acquire);
+				std::ptrdiff_t diff = (std::ptrdiff_t)seq - (std::ptrdiff_t)(pos + 1);
+
+				if (diff == 0)
+				{
+					if (head.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+					{
+						event = std::move(slot.event);
+						slot.event.reset();
+						slot.sequence.store(pos + capacity, std::memory_order_release);
+						return true;
+					}
+				}
+				else if (diff < 0)
+				{
+					return false;
+				}
+				else
+				{
+					pos = head.load(std::memory_order_relaxed);
+				}
+			}
+		}
+
+		/**
+		 * The approximate number of events in the queue.
+		*/
+		size_t size() const
+		{
+			size_t first = head.load(std::memory_order_relaxed);
+			size_t last = tail.load(std::memory_order_relaxed);
+			return first < last ? last - first : 0;
+		}
+
+		/**
+		 * Is there an event ready for the consumer?
+		*/
+		bool hasPublished() const
+		{
+			size_t pos = head.load(std::memory_order_relaxed);
+			return slots[pos % capacity].sequence.load(std::memory_order_acquire) == pos + 1;
+		}
+};
+
+namespace
+{
+/**
+ * The owner of the DispatchQueue served by the current thread.
+ * A dispatcher thread must not wait for space in its owner's buffers.
+*/
+thread_local const void* dispatchingFor = nullptr;
+}
+
+/**
+ * Settings shared by all the event queues of an AsyncAppender.
+*/
+struct OverflowSettings
+{
+	OverflowSettings() :
+		bufferSize(DEFAULT_BUFFER_SIZE),
+		policy(AsyncAppender::OverflowPolicy::Block),
+		lowWatermark(-1),
+		dropThreshold(Level::WARN_INT),
+		maxBlockingTime(DEFAULT_MAX_BLOCKING_TIME) {}
+
+	/**
+	 * Buffer size.
+	*/
+	std::atomic<int> bufferSize;
+
+	/**
+	 * What to do with an event when the buffer is full.
+	*/
+	std::atomic<AsyncAppender::OverflowPolicy> policy;
+
+	/**
+	 * A waiting producer continues once the buffer holds no more than this many events,
+	 * or half the buffer size when negative (not set).
+	*/
+	std::atomic<int> lowWatermark;
+
+	/**
+	 * Events at this level or above are not discarded by the DropBelowLevel policy.
+	*/
+	std::atomic<int> dropThreshold;
+
+	/**
+	 * Milliseconds a producer waits under the BoundedWait policy.
+	*/
+	std::atomic<int> maxBlockingTime;
+};
+
+/**
+ * A bounded event buffer served by its own dispatcher thread.
+*/
+class DispatchQueue
+{
+	public:
+		/**
+		 * Output a group of events.
+		 * @return false if the dispatcher should stop.
+		*/
+		typedef std::function<bool(const LoggingEventList&, Pool&)> Deliver;
+
+		DispatchQueue(const void* owner, const OverflowSettings& settings,
+			bool ringBuffer, const Deliver& deliver) :
+			owner(owner),
+			settings(settings),
+			deliver(deliver),
+			takenCount(0),
+			discardedCount(0),
+			dispatcherWaiting(false),
+			closed(false)
+		{
+			if (ringBuffer)
+			{
+				ring = std::make_unique<EventRingBuffer>(settings.bufferSize);
+			}
+		}
+
+		~DispatchQueue()
+		{
+			close();
+		}
+
+		void start()
+		{
+			dispatcher = ThreadUtility::instance()->createThread( LOG4CXX_STR("AsyncAppender"), &DispatchQueue::run, this );
+		}
+
+		/**
+		 * Add \c event to the buffer applying the overflow policy when it is full.
+		*/
+		void push(const LoggingEventPtr& event)
+		{
+			if (ring)
+			{
+				pushToRing(event);
+				return;
+			}
+
+			std::unique_lock<std::mutex> lock(bufferMutex);
+			std::chrono::steady_clock::time_point deadline;
+
+			while (true)
+			{
+				size_t previousSize = buffer.size();
+
+				if (previousSize < (size_t)settings.bufferSize)
+				{
+					buffer.push_back(event);
+
+					if (previousSize == 0)
+					{
+						bufferNotEmpty.notify_all();
+					}
+
+					break;
+				}
+
+				//
+				//   Following code is only reachable if buffer is full
+				//
+				if (!handleOverflow(event, lock, deadline))
+				{
+					break;
+				}
+			}
+		}
+
+		/**
+		 * Stop the dispatcher after it has delivered the buffered events.
+		*/
+		void close()
+		{
+			{
+				std::lock_guard<std::mutex> lock(bufferMutex);
+				closed = true;
+				bufferNotEmpty.notify_all();
+				bufferNotFull.notify_all();
+			}
+
+			if (!dispatcher.joinable())
+			{
+				return;
+			}
+
+			if (dispatcher.get_id() == std::this_thread::get_id())
+			{
+				dispatcher.detach();
+			}
+			else
+			{
+				dispatcher.join();
+			}
+		}
+
+		/**
+		 * Let waiting producers re-evaluate the overflow settings.
+		*/
+		void settingsChanged()
+		{
+			std::lock_guard<std::mutex> lock(bufferMutex);
+			bufferNotFull.notify_all();
+		}
+
+		size_t getDiscardedCount() const
+		{
+			return discardedCount;
+		}
+
+	private:
+		const void* owner;
+		const OverflowSettings& settings;
+		Deliver deliver;
+
+		/**
+		 * Event buffer. A deque so the DropOldest policy can remove its front cheaply.
+		*/
+		std::deque<LoggingEventPtr> buffer;
+
+		/**
+		 * Lock-free event buffer, used in place of buffer when the ring buffer is selected.
+		*/
+		std::unique_ptr<EventRingBuffer> ring;
+
+		/**
+		 *  Mutex used to guard access to buffer and discardMap.
+		 */
+		std::mutex bufferMutex;
+
+		std::condition_variable bufferNotFull;
+		std::condition_variable bufferNotEmpty;
+
+		/**
+		  * Map of DiscardSummary objects keyed by logger name.
+		*/
+		DiscardMap discardMap;
+
+		/**
+		 * The number of events the dispatcher has taken but not yet delivered.
+		*/
+		size_t takenCount;
+
+		/**
+		 * The number of events discarded from this queue.
+		*/
+		std::atomic<size_t> discardedCount;
+
+		/**
+		 * Is the dispatcher waiting on bufferNotEmpty for a ring buffer event.
+		*/
+		std::atomic<bool> dispatcherWaiting;
+
+		bool closed;
+
+		/**
+		 *  Dispatcher.
+		 */
+		std::thread dispatcher;
+
+		/**
+		 * The number of events waiting for the dispatcher.
+		*/
+		size_t queuedCount() const
+		{
+			return ring ? ring->size() : buffer.size();
+		}
+
+		/**
+		 * Has the buffer drained enough for a waiting producer to continue?
+		 *
+		 * The dispatcher takes all queued events at once, so a non-zero
+		 * low watermark also counts the events it has not yet delivered.
+		*/
+		bool hasSpace() const
+		{
+			int lowWatermark = settings.lowWatermark;
+
+			if (lowWatermark < 0)
+			{
+				return queuedCount() <= (size_t)(settings.bufferSize / 2);
+			}
+
+			if (0 < lowWatermark && lowWatermark < settings.bufferSize)
+			{
+				return queuedCount() + takenCount <= (size_t)lowWatermark;
+			}
+
+			return queuedCount() == 0;
+		}
+
+		void pushToRing(const LoggingEventPtr& event)
+		{
+			if (ring->tryPush(event))
+			{
+				// Pairs with the fence in the dispatcher's wait predicate
+				std::atomic_thread_fence(std::memory_order_seq_cst);
+
+				if (dispatcherWaiting.load(std::memory_order_relaxed))
+				{
+					std::lock_guard<std::mutex> lock(bufferMutex);
+					bufferNotEmpty.notify_all();
+				}
+
+				return;
+			}
+
+			//
+			//   Following code is only reachable if buffer was full
+			//
+			std::unique_lock<std::mutex> lock(bufferMutex);
+			std::chrono::steady_clock::time_point deadline;
+
+			while (true)
+			{
+				if (ring->tryPush(event))
+				{
+					if (dispatcherWaiting.load())
+					{
+						bufferNotEmpty.notify_all();
+					}
+
+					break;
+				}
+
+				if (!handleOverflow(event, lock, deadline))
+				{
+					break;
+				}
+			}
+		}
+
+		/**
+		 *  Apply the overflow policy to \c event which did not fit in the buffer.
+		 *
+		 *  @return true if adding \c event to the buffer should be retried.
+		 */
+		bool handleOverflow(const LoggingEventPtr& event,
+			std::unique_lock<std::mutex>& lock,
+			std::chrono::steady_clock::time_point& deadline)
+		{
+			//
+			//   Only wait when the queue is open and this is not a dispatcher,
+			//   otherwise the event could never be removed from the buffer.
+			//
+			bool mayWait = !closed && dispatchingFor != owner;
+			auto hasSpace = [this]() -> bool
+			{
+				return this->hasSpace() || closed;
+			};
+
+			switch (settings.policy.load())
+			{
+				case AsyncAppender::OverflowPolicy::Block:
+					if (mayWait)
+					{
+						bufferNotFull.wait(lock, hasSpace);
+						return true;
+					}
+
+					break;
+
+				case AsyncAppender::OverflowPolicy::DropBelowLevel:
+					if (mayWait && settings.dropThreshold <= event->getLevel()->toInt())
+					{
+						bufferNotFull.wait(lock, hasSpace);
+						return true;
+					}
+
+					break;
+
+				case AsyncAppender::OverflowPolicy::BoundedWait:
+					if (mayWait)
+					{
+						if (deadline == std::chrono::steady_clock::time_point())
+						{
+							deadline = std::chrono::steady_clock::now()
+								+ std::chrono::milliseconds(settings.maxBlockingTime);
+						}
+
+						if (bufferNotFull.wait_until(lock, deadline, hasSpace))
+						{
+							return true;
+						}
+					}
+
+					break;
+
+				case AsyncAppender::OverflowPolicy::DropOldest:
+				{
+					LoggingEventPtr oldest;
+
+					if (ring)
+					{
+						if (!ring->tryPop(oldest))
+						{
+							// A producer has claimed the oldest slot but not yet filled it
+							lock.unlock();
+							std::this_thread::yield();
+							lock.lock();
+							return true;
+						}
+					}
+					else
+					{
+						oldest = std::move(buffer.front());
+						buffer.pop_front();
+					}
+
+					discard(oldest);
+					return true;
+				}
+
+				case AsyncAppender::OverflowPolicy::DropNewest:
+					break;
+			}
+
+			discard(event);
+			return false;
+		}
+
+		/**
+		 *  Add \c event to the discard summary.
+		 */
+		void discard(const LoggingEventPtr& event)
+		{
+			++discardedCount;
+			LogString loggerName = event->getLoggerName();
+			DiscardMap::iterator iter = discardMap.find(loggerName);
+
+			if (iter == discardMap.end())
+			{
+				DiscardSummary summary(event);
+				discardMap.insert(DiscardMap::value_type(loggerName, summary));
+			}
+			else
+			{
+				(*iter).second.add(event);
+			}
+		}
+
+		/**
+		 *  Move buffered events and discard summaries into \c events,
+		 *  waiting when there are none.
+		 *
+		 *  @return false when the queue is closed.
+		 */
+		bool takeFromList(LoggingEventList& events, Pool& p)
+		{
+			std::unique_lock<std::mutex> lock(bufferMutex);
+			bufferNotEmpty.wait(lock, [this]() -> bool
+				{ return 0 < buffer.size() || closed; }
+			);
+			bool isActive = !closed;
+
+			events.assign(std::make_move_iterator(buffer.begin()), std::make_move_iterator(buffer.end()));
+			buffer.clear();
+			takenCount = events.size();
+
+			for (DiscardMap::iterator discardIter = discardMap.begin();
+				discardIter != discardMap.end();
+				discardIter++)
+			{
+				events.push_back(discardIter->second.createEvent(p));
+			}
+
+			discardMap.clear();
+			bufferNotFull.notify_all();
+			return isActive;
+		}
+
+		/**
+		 *  Move pending ring buffer events and discard summaries into \c events,
+		 *  waiting when there are none.
+		 *
+		 *  @return false when the queue is closed and no events remain.
+		 */
+		bool takeFromRing(LoggingEventList& events, Pool& p)
+		{
+			LoggingEventPtr event;
+
+			// Take at most one lap so a busy producer cannot starve the appenders
+			while (events.size() < ring->getCapacity() && ring->tryPop(event))
+			{
+				events.push_back(event);
+			}
+
+			std::unique_lock<std::mutex> lock(bufferMutex);
+
+			if (events.empty() && discardMap.empty())
+			{
+				if (closed)
+				{
+					return false;
+				}
+
+				dispatcherWaiting = true;
+				bufferNotEmpty.wait(lock, [this]() -> bool
+					{
+						// Pairs with the fence after a successful push in pushToRing
+						std::atomic_thread_fence(std::memory_order_seq_cst);
+						return ring->hasPublished() || !discardMap.empty() || closed;
+					});
+				dispatcherWaiting = false;
+				return true;
+			}
+
+			takenCount = events.size();
+
+			for (DiscardMap::iterator discardIter = discardMap.begin();
+				discardIter != discardMap.end();
+				discardIter++)
+			{
+				events.push_back(discardIter->second.createEvent(p));
+			}
+
+			discardMap.clear();
+			bufferNotFull.notify_all();
+			return true;
+		}
+
+		/**
+		 *  Let producers waiting for the low watermark count the taken events as delivered.
+		 */
+		void delivered()
+		{
+			std::lock_guard<std::mutex> lock(bufferMutex);
+
+			if (takenCount != 0)
+			{
+				takenCount = 0;
+				bufferNotFull.notify_all();
+			}
+		}
+
+		/**
+		 *  Dispatch routine.
+		 */
+		void run()
+		{
+			dispatchingFor = owner;
+			bool isActive = true;
+			Pool p;
+			LoggingEventList events;
+
+			while (isActive)
+			{
+				//
+				//   process events after lock on buffer is released.
+				//
+				isActive = ring ? takeFromRing(events, p) : takeFromList(events, p);
+
+				if (!events.empty() && !deliver(events, p))
+				{
+					isActive = false;
+				}
+
+				delivered();
+
+				// Reuse the memory for the next group of events
+				events.clear();
+				apr_pool_clear(p.getAPRPool());
+			}
+		}
+};
+
+typedef std::shared_ptr<DispatchQueue> DispatchQueuePtr;
+
+/**
+ * A queue and the appender it serves, which is null when it serves all appenders.
+*/
+typedef std::pair<AppenderPtr, DispatchQueuePtr> AppenderQueue;
+typedef std::vector<AppenderQueue> AppenderQueueList;
+typedef std::shared_ptr<const AppenderQueueList> AppenderQueueListPtr;
+
 struct AsyncAppender::AsyncAppenderPriv : public AppenderSkeleton::AppenderSkeletonPrivate
 {
 	AsyncAppenderPriv() :
 		AppenderSkeletonPrivate(),
-		buffer(),
-		bufferSize(DEFAULT_BUFFER_SIZE),
 		appenders(std::make_shared<AppenderAttachableImpl>(pool)),
-		dispatcher(),
+		started(false),
 		locationInfo(false),
-		blocking(true) {}
+		dropThreshold(Level::getWarn()),
+		ringBuffer(false),
+		dispatchPerAppender(false) {}
+
+	/**
+	 * Settings shared by all queues.
+	*/
+	OverflowSettings settings;
+
+	/**
+	 * Nested appenders.
+	*/
+	helpers::AppenderAttachableImplPtr appenders;
 
 	/**
-	 * Event buffer.
+	 * The event queues. Replaced, never modified, while holding queueMutex
+	 * and read by logging threads without locking.
 	*/
-#if defined(NON_BLOCKING)
-	boost::lockfree::queue<log4cxx::spi::LoggingEvent* > buffer;
-	std::atomic<size_t> discardedCount;
-#else
-	LoggingEventList buffer;
-#endif
+	helpers::AtomicSharedPtr<const AppenderQueueList> queues;
 
 	/**
-	 *  Mutex used to guard access to buffer and discardMap.
+	 *  Mutex used to serialize changes to queues.
 	 */
-	std::mutex bufferMutex;
+	mutable std::mutex queueMutex;
 
-#if defined(NON_BLOCKING)
-	::log4cxx::helpers::Semaphore bufferNotFull;
-	::log4cxx::helpers::Semaphore bufferNotEmpty;
-#else
-	std::condition_variable bufferNotFull;
-	std::condition_variable bufferNotEmpty;
-#endif
+	/**
+	 * Have the dispatchers been started.
+	*/
+	std::atomic<bool> started;
 
 	/**
-	  * Map of DiscardSummary objects keyed by logger name.
+	 * Should location info be included in dispatched messages.
 	*/
-	DiscardMap discardMap;
+	bool locationInfo;
 
 	/**
-	 * Buffer size.
+	 * The value of settings.dropThreshold as a level.
 	*/
-	int bufferSize;
+	LevelPtr dropThreshold;
 
 	/**
-	 * Nested appenders.
+	 * Should the lock-free ring buffer be used.
 	*/
-	helpers::AppenderAttachableImplPtr appenders;
+	bool ringBuffer;
 
 	/**
-	 *  Dispatcher.
-	 */
-	std::thread dispatcher;
+	 * Should each nested appender have its own queue and dispatcher.
+	*/
+	bool dispatchPerAppender;
+
+	AppenderQueueListPtr getQueues() const
+	{
+		return queues.load();
+	}
 
 	/**
-	 * Should location info be included in dispatched messages.
+	 * Create a started queue which delivers to \c appender,
+	 * or to all nested appenders if \c appender is null.
 	*/
-	bool locationInfo;
+	DispatchQueuePtr createQueue(const AppenderPtr& appender)
+	{
+		DispatchQueue::Deliver deliver = [this, appender](const LoggingEventList& events, Pool& p) -> bool
+		{
+			try
+			{
+				if (appender)
+				{
+					appender->doAppend(events, p);
+				}
+				else
+				{
+					appenders->appendLoopOnAppenders(events, p);
+				}
+			}
+			catch (std::exception& ex)
+			{
+				snapshot.load()->errorHandler->error(LOG4CXX_STR("async dispatcher"), ex, 0);
+				return false;
+			}
+			catch (...)
+			{
+				snapshot.load()->errorHandler->error(LOG4CXX_STR("async dispatcher"));
+				return false;
+			}
+
+			return true;
+		};
+		auto result = std::make_shared<DispatchQueue>(this, settings, ringBuffer, deliver);
+		result->start();
+		return result;
+	}
+
+	/**
+	 * Create the queues if not already done and the appender is not closed.
+	*/
+	void start()
+	{
+		if (started)
+		{
+			return;
+		}
+
+		std::lock_guard<std::mutex> lock(queueMutex);
+
+		if (started || closed)
+		{
+			return;
+		}
+
+		auto newQueues = std::make_shared<AppenderQueueList>();
+
+		if (dispatchPerAppender)
+		{
+			for (auto& appender : appenders->getAllAppenders())
+			{
+				newQueues->push_back(AppenderQueue(appender, createQueue(appender)));
+			}
+		}
+		else
+		{
+			newQueues->push_back(AppenderQueue(AppenderPtr(), createQueue(AppenderPtr())));
+		}
+
+		queues.store(newQueues);
+		started = true;
+	}
+
+	/**
+	 * Add a queue for \c appender if each appender has its own dispatcher.
+	*/
+	void addQueue(const AppenderPtr& appender)
+	{
+		std::lock_guard<std::mutex> lock(queueMutex);
+
+		if (!started || closed || !dispatchPerAppender)
+		{
+			return;
+		}
+
+		auto newQueues = std::make_shared<AppenderQueueList>(*queues.load());
+
+		for (auto& item : *newQueues)
+		{
+			if (item.first == appender)
+			{
+				return;
+			}
+		}
+
+		newQueues->push_back(AppenderQueue(appender, createQueue(appender)));
+		queues.store(newQueues);
+	}
+
+	/**
+	 * Stop dispatching to the appenders for which \c isRemoved is true.
+	*/
+	template <class Predicate>
+	void removeQueues(Predicate isRemoved)
+	{
+		AppenderQueueList removed;
+		{
+			std::lock_guard<std::mutex> lock(queueMutex);
+
+			if (!started || !dispatchPerAppender)
+			{
+				return;
+			}
+
+			auto newQueues = std::make_shared<AppenderQueueList>();
+
+			for (auto& item : *queues.load())
+			{
+				if (isRemoved(item.first))
+				{
+					removed.push_back(item);
+				}
+				else
+				{
+					newQueues->push_back(item);
+				}
+			}
+
+			queues.store(newQueues);
+		}
+
+		for (auto& item : removed)
+		{
+			item.second->close();
+		}
+	}
 
 	/**
-	 * Does appender block when buffer is full.
+	 * Let waiting producers re-evaluate the overflow settings.
 	*/
-	bool blocking;
+	void settingsChanged()
+	{
+		if (auto currentQueues = getQueues())
+		{
+			for (auto& item : *currentQueues)
+			{
+				item.second->settingsChanged();
+			}
+		}
+	}
 };
 
 
@@ -158,6 +991,8 @@ IMPLEMENT_LOG4CXX_OBJECT(AsyncAppender)
 AsyncAppender::AsyncAppender()
 	: AppenderSkeleton(std::make_unique<AsyncAppenderPriv>())
 {
+	// Logging threads only synchronize on the event buffer
+	setConcurrent(true);
 }
 
 AsyncAppender::~AsyncAppender()
@@ -168,6 +1003,7 @@ AsyncAppender::~AsyncAppender()
 void AsyncAppender::addAppender(const AppenderPtr newAppender)
 {
 	priv->appenders->addAppender(newAppender);
+	priv->addQueue(newAppender);
 }
 
 
@@ -188,6 +1024,30 @@ void AsyncAppender::setOption(const LogString& option,
 	{
 		setBlocking(OptionConverter::toBoolean(value, true));
 	}
+	else if (StringHelper::equalsIgnoreCase(option, LOG4CXX_STR("RINGBUFFER"), LOG4CXX_STR("ringbuffer")))
+	{
+		setRingBuffer(OptionConverter::toBoolean(value, false));
+	}
+	else if (StringHelper::equalsIgnoreCase(option, LOG4CXX_STR("DISPATCHPERAPPENDER"), LOG4CXX_STR("dispatchperappender")))
+	{
+		setDispatchPerAppender(OptionConverter::toBoolean(value, false));
+	}
+	else if (StringHelper::equalsIgnoreCase(option, LOG4CXX_STR("OVERFLOWPOLICY"), LOG4CXX_STR("overflowpolicy")))
+	{
+		setOverflowPolicy(value);
+	}
+	else if (StringHelper::equalsIgnoreCase(option, LOG4CXX_STR("LOWWATERMARK"), LOG4CXX_STR("lowwatermark")))
+	{
+		setLowWatermark(OptionConverter::toInt(value, 0));
+	}
+	else if (StringHelper::equalsIgnoreCase(option, LOG4CXX_STR("DROPTHRESHOLD"), LOG4CXX_STR("dropthreshold")))
+	{
+		setDropThreshold(OptionConverter::toLevel(value, Level::getWarn()));
+	}
+	else if (StringHelper::equalsIgnoreCase(option, LOG4CXX_STR("MAXBLOCKINGTIME"), LOG4CXX_STR("maxblockingtime")))
+	{
+		setMaxBlockingTime(OptionConverter::toInt(value, DEFAULT_MAX_BLOCKING_TIME));
+	}
 	else
 	{
 		AppenderSkeleton::setOption(option, value);
@@ -195,22 +1055,21 @@ void AsyncAppender::setOption(const LogString& option,
 }
 
 
-void AsyncAppender::doAppend(const spi::LoggingEventPtr& event, Pool& pool1)
-{
-	std::lock_guard<std::recursive_mutex> lock(priv->mutex);
-
-	doAppendImpl(event, pool1);
-}
-
 void AsyncAppender::append(const spi::LoggingEventPtr& event, Pool& p)
 {
-	if (priv->bufferSize <= 0)
+	if (priv->settings.bufferSize <= 0)
 	{
 		priv->appenders->appendLoopOnAppenders(event, p);
 	}
-	if (!priv->dispatcher.joinable())
+
+	priv->start();
+
+	// No queues are created once the appender is closed
+	auto queues = priv->getQueues();
+
+	if (!queues)
 	{
-		priv->dispatcher = ThreadUtility::instance()->createThread( LOG4CXX_STR("AsyncAppender"), &AsyncAppender::dispatch, this );
+		return;
 	}
 
 	// Set the NDC and MDC for the calling thread as these
@@ -220,84 +1079,29 @@ void AsyncAppender::append(const spi::LoggingEventPtr& event, Pool& p)
 	// Get a copy of this thread's MDC.
 	event->getMDCCopy();
 
-
+	for (auto& item : *queues)
 	{
-		std::unique_lock<std::mutex> lock(priv->bufferMutex);
-
-		while (true)
-		{
-			size_t previousSize = priv->buffer.size();
-
-			if (previousSize < (size_t)priv->bufferSize)
-			{
-				priv->buffer.push_back(event);
-
-				if (previousSize == 0)
-				{
-					priv->bufferNotEmpty.notify_all();
-				}
-
-				break;
-			}
-
-			//
-			//   Following code is only reachable if buffer is full
-			//
-			//
-			//   if blocking and thread is not already interrupted
-			//      and not the dispatcher then
-			//      wait for a buffer notification
-			bool discard = true;
-
-			if (priv->blocking
-				&& !priv->closed
-				&& (priv->dispatcher.get_id() != std::this_thread::get_id()) )
-			{
-				priv->bufferNotFull.wait(lock, [this]()
-				{
-					return priv->buffer.empty();
-				});
-				discard = false;
-			}
-
-			//
-			//   if blocking is false or thread has been interrupted
-			//   add event to discard map.
-			//
-			if (discard)
-			{
-				LogString loggerName = event->getLoggerName();
-				DiscardMap::iterator iter = priv->discardMap.find(loggerName);
-
-				if (iter == priv->discardMap.end())
-				{
-					DiscardSummary summary(event);
-					priv->discardMap.insert(DiscardMap::value_type(loggerName, summary));
-				}
-				else
-				{
-					(*iter).second.add(event);
-				}
-
-				break;
-			}
-		}
+		item.second->push(event);
 	}
 }
 
 
 void AsyncAppender::close()
 {
+	AppenderQueueListPtr queues;
 	{
-		std::lock_guard<std::mutex> lock(priv->bufferMutex);
+		// Taking the lock of start() ensures no dispatcher starts after this
+		std::lock_guard<std::mutex> lock(priv->queueMutex);
 		priv->closed = true;
-		priv->bufferNotEmpty.notify_all();
-		priv->bufferNotFull.notify_all();
+		queues = priv->getQueues();
 	}
 
-	if ( priv->dispatcher.joinable() )
+	if (queues)
 	{
-		priv->dispatcher.join();
+		for (auto& item : *queues)
+		{
+			item.second->close();
+		}
 	}
 
 	{
@@ -334,16 +1138,19 @@ bool AsyncAppender::requiresLayout() const
 
 void AsyncAppender::removeAllAppenders()
 {
+	priv->removeQueues([](const AppenderPtr&) { return true; });
 	priv->appenders->removeAllAppenders();
 }
 
 void AsyncAppender::removeAppender(const AppenderPtr appender)
 {
+	priv->removeQueues([&appender](const AppenderPtr& item) { return item == appender; });
 	priv->appenders->removeAppender(appender);
 }
 
 void AsyncAppender::removeAppender(const LogString& n)
 {
+	priv->removeQueues([&n](const AppenderPtr& item) { return item->getName() == n; });
 	priv->appenders->removeAppender(n);
 }
 
@@ -365,26 +1172,157 @@ void AsyncAppender::setBufferSize(int size)
 		throw IllegalArgumentException(LOG4CXX_STR("size argument must be non-negative"));
 	}
 
-	std::lock_guard<std::mutex> lock(priv->bufferMutex);
-	priv->bufferSize = (size < 1) ? 1 : size;
-	priv->bufferNotFull.notify_all();
+	priv->settings.bufferSize = (size < 1) ? 1 : size;
+	priv->settingsChanged();
 }
 
 int AsyncAppender::getBufferSize() const
 {
-	return priv->bufferSize;
+	return priv->settings.bufferSize;
 }
 
 void AsyncAppender::setBlocking(bool value)
 {
-	std::lock_guard<std::mutex> lock(priv->bufferMutex);
-	priv->blocking = value;
-	priv->bufferNotFull.notify_all();
+	setOverflowPolicy(value ? OverflowPolicy::Block : OverflowPolicy::DropNewest);
 }
 
 bool AsyncAppender::getBlocking() const
 {
-	return priv->blocking;
+	return priv->settings.policy == OverflowPolicy::Block;
+}
+
+void AsyncAppender::setRingBuffer(bool value)
+{
+	priv->ringBuffer = value;
+}
+
+bool AsyncAppender::getRingBuffer() const
+{
+	return priv->ringBuffer;
+}
+
+void AsyncAppender::setDispatchPerAppender(bool value)
+{
+	priv->dispatchPerAppender = value;
+}
+
+bool AsyncAppender::getDispatchPerAppender() const
+{
+	return priv->dispatchPerAppender;
+}
+
+void AsyncAppender::setOverflowPolicy(OverflowPolicy policy)
+{
+	priv->settings.policy = policy;
+	priv->settingsChanged();
+}
+
+void AsyncAppender::setOverflowPolicy(const LogString& policy)
+{
+	if (StringHelper::equalsIgnoreCase(policy, LOG4CXX_STR("BLOCK"), LOG4CXX_STR("block")))
+	{
+		setOverflowPolicy(OverflowPolicy::Block);
+	}
+	else if (StringHelper::equalsIgnoreCase(policy, LOG4CXX_STR("DROPNEWEST"), LOG4CXX_STR("dropnewest")))
+	{
+		setOverflowPolicy(OverflowPolicy::DropNewest);
+	}
+	else if (StringHelper::equalsIgnoreCase(policy, LOG4CXX_STR("DROPOLDEST"), LOG4CXX_STR("dropoldest")))
+	{
+		setOverflowPolicy(OverflowPolicy::DropOldest);
+	}
+	else if (StringHelper::equalsIgnoreCase(policy, LOG4CXX_STR("DROPBELOWLEVEL"), LOG4CXX_STR("dropbelowlevel")))
+	{
+		setOverflowPolicy(OverflowPolicy::DropBelowLevel);
+	}
+	else if (StringHelper::equalsIgnoreCase(policy, LOG4CXX_STR("BOUNDEDWAIT"), LOG4CXX_STR("boundedwait")))
+	{
+		setOverflowPolicy(OverflowPolicy::BoundedWait);
+	}
+	else
+	{
+		LogLog::warn(LOG4CXX_STR("Unknown AsyncAppender OverflowPolicy [") + policy + LOG4CXX_STR("]"));
+	}
+}
+
+AsyncAppender::OverflowPolicy AsyncAppender::getOverflowPolicy() const
+{
+	return priv->settings.policy;
+}
+
+void AsyncAppender::setLowWatermark(int value)
+{
+	if (value < 0)
+	{
+		throw IllegalArgumentException(LOG4CXX_STR("low watermark must be non-negative"));
+	}
+
+	priv->settings.lowWatermark = value;
+	priv->settingsChanged();
+}
+
+int AsyncAppender::getLowWatermark() const
+{
+	int value = priv->settings.lowWatermark;
+	return value < 0 ? priv->settings.bufferSize / 2 : value;
+}
+
+void AsyncAppender::setDropThreshold(const LevelPtr& level)
+{
+	priv->dropThreshold = level ? level : Level::getWarn();
+	priv->settings.dropThreshold = priv->dropThreshold->toInt();
+	priv->settingsChanged();
+}
+
+LevelPtr AsyncAppender::getDropThreshold() const
+{
+	return priv->dropThreshold;
+}
+
+void AsyncAppender::setMaxBlockingTime(int milliseconds)
+{
+	if (milliseconds < 0)
+	{
+		throw IllegalArgumentException(LOG4CXX_STR("maximum blocking time must be non-negative"));
+	}
+
+	priv->settings.maxBlockingTime = milliseconds;
+}
+
+int AsyncAppender::getMaxBlockingTime() const
+{
+	return priv->settings.maxBlockingTime;
+}
+
+size_t AsyncAppender::getDiscardedCount() const
+{
+	size_t result = 0;
+
+	if (auto queues = priv->getQueues())
+	{
+		for (auto& item : *queues)
+		{
+			result += item.second->getDiscardedCount();
+		}
+	}
+
+	return result;
+}
+
+size_t AsyncAppender::getDiscardedCount(const AppenderPtr& appender) const
+{
+	if (auto queues = priv->getQueues())
+	{
+		for (auto& item : *queues)
+		{
+			if (item.first == appender)
+			{
+				return item.second->getDiscardedCount();
+			}
+		}
+	}
+
+	return 0;
 }
 
 DiscardSummary::DiscardSummary(const LoggingEventPtr& event) :
@@ -442,62 +1380,3 @@ DiscardSummary::createEvent(::log4cxx::helpers::Pool& p,
 				LocationInfo::getLocationUnavailable() );
 }
 
-void AsyncAppender::dispatch()
-{
-	bool isActive = true;
-
-	while (isActive)
-	{
-		//
-		//   process events after lock on buffer is released.
-		//
-		Pool p;
-		LoggingEventList events;
-		{
-			std::unique_lock<std::mutex> lock(priv->bufferMutex);
-			priv->bufferNotEmpty.wait(lock, [this]() -> bool
-				{ return 0 < priv->buffer.size() || priv->closed; }
-			);
-			isActive = !priv->closed;
-
-			for (LoggingEventList::iterator eventIter = priv->buffer.begin();
-				eventIter != priv->buffer.end();
-				eventIter++)
-			{
-				events.push_back(*eventIter);
-			}
-
-			for (DiscardMap::iterator discardIter = priv->discardMap.begin();
-				discardIter != priv->discardMap.end();
-				discardIter++)
-			{
-				events.push_back(discardIter->second.createEvent(p));
-			}
-
-			priv->buffer.clear();
-			priv->discardMap.clear();
-			priv->bufferNotFull.notify_all();
-		}
-
-		for (LoggingEventList::iterator iter = events.begin();
-			iter != events.end();
-			iter++)
-		{
-			try
-			{
-				priv->appenders->appendLoopOnAppenders(*iter, p);
-			}
-			catch (std::exception& ex)
-			{
-				priv->errorHandler->error(LOG4CXX_STR("async dispatcher"), ex, 0, *iter);
-				isActive = false;
-			}
-			catch (...)
-			{
-				priv->errorHandler->error(LOG4CXX_STR("async dispatcher"));
-				isActive = false;
-			}
-		}
-	}
-
-}
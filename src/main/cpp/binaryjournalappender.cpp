@@ -0,0 +1,548 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <log4cxx/binaryjournalappender.h>
+#include <log4cxx/spi/loggingevent.h>
+#include <log4cxx/helpers/loglog.h>
+#include <log4cxx/helpers/stringhelper.h>
+#include <log4cxx/helpers/optionconverter.h>
+#include <log4cxx/helpers/fileoutputstream.h>
+#include <log4cxx/helpers/bytebuffer.h>
+#include <log4cxx/helpers/transcoder.h>
+#include <log4cxx/helpers/exception.h>
+#include <log4cxx/file.h>
+#include <log4cxx/private/appenderskeleton_priv.h>
+#include <log4cxx/private/binaryjournal.h>
+#include <unordered_map>
+#include <map>
+#include <cstring>
+
+using namespace log4cxx;
+using namespace log4cxx::helpers;
+using namespace log4cxx::spi;
+using namespace log4cxx::helpers::BinaryJournal;
+
+namespace
+{
+const int DEFAULT_BUFFER_SIZE = 8 * 1024;
+
+/**
+ * Append \c src to \c dest as a UTF-8 string field.
+ */
+void putLogString(std::string& dest, const LogString& src, std::string& scratch)
+{
+#if LOG4CXX_LOGCHAR_IS_UTF8
+	(void)scratch;
+	putString(dest, src.data(), src.size());
+#else
+	scratch.clear();
+	Transcoder::encodeUTF8(src, scratch);
+	putString(dest, scratch.data(), scratch.size());
+#endif
+}
+
+const char* nonNull(const char* value)
+{
+	return value ? value : "";
+}
+}
+
+struct BinaryJournalAppender::BinaryJournalAppenderPriv : public AppenderSkeleton::AppenderSkeletonPrivate
+{
+	BinaryJournalAppenderPriv() :
+		fileAppend(true),
+		immediateFlush(true),
+		bufferSize(DEFAULT_BUFFER_SIZE),
+		nextId(0),
+		lastTimeStamp(0)
+	{
+	}
+
+	BinaryJournalAppenderPriv(const LogString& fileName1, bool append1) :
+		fileName(fileName1),
+		fileAppend(append1),
+		immediateFlush(true),
+		bufferSize(DEFAULT_BUFFER_SIZE),
+		nextId(0),
+		lastTimeStamp(0)
+	{
+	}
+
+	LogString fileName;
+	bool fileAppend;
+	bool immediateFlush;
+	int bufferSize;
+	OutputStreamPtr out;
+
+	/** Records not yet written to the file. */
+	std::string buffer;
+
+	/** The fields of the record under construction. */
+	std::string record;
+
+	/** A string being converted to UTF-8. */
+	std::string scratch;
+
+	/**
+	 * The dictionary identifiers of strings that are never released,
+	 * interned names, string literals and levels, by address.
+	 */
+	std::unordered_map<const void*, uint32_t> idByAddress;
+
+	/** The dictionary identifiers of MDC keys. */
+	std::map<LogString, uint32_t> idByValue;
+
+	/** Keeps the levels in idByAddress alive. */
+	std::vector<LevelPtr> levels;
+
+	uint32_t nextId;
+	log4cxx_time_t lastTimeStamp;
+
+	/**
+	 * Move the fields in \c fields to the end of \c buffer as a record of \c type.
+	 * Fields a reader would reject are dropped.
+	 */
+	void addRecord(RecordType type, std::string& fields)
+	{
+		if (MaxRecordSize <= fields.size())
+		{
+			LogLog::warn(LOG4CXX_STR("Dropped a journal record larger than a reader accepts"));
+			fields.clear();
+			return;
+		}
+
+		putVarint(buffer, fields.size() + 1);
+		buffer.push_back(static_cast<char>(type));
+		buffer.append(fields);
+		fields.clear();
+	}
+
+	/**
+	 * Start a new dictionary and timestamp base.
+	 */
+	void addHeader()
+	{
+		idByAddress.clear();
+		idByValue.clear();
+		levels.clear();
+		nextId = 0;
+		lastTimeStamp = 0;
+		std::string fields(Magic, sizeof(Magic));
+		putVarint(fields, Version);
+		addRecord(Header, fields);
+	}
+
+	uint32_t addDictionaryEntry(const char* utf8, size_t size)
+	{
+		uint32_t id = nextId++;
+		std::string fields;
+		putVarint(fields, id);
+		fields.append(utf8, size);
+		addRecord(Dictionary, fields);
+		return id;
+	}
+
+	uint32_t addDictionaryEntry(const LogString& value)
+	{
+#if LOG4CXX_LOGCHAR_IS_UTF8
+		return addDictionaryEntry(value.data(), value.size());
+#else
+		scratch.clear();
+		Transcoder::encodeUTF8(value, scratch);
+		return addDictionaryEntry(scratch.data(), scratch.size());
+#endif
+	}
+
+	/**
+	 * The identifier of \c value, which is a NameTable entry.
+	 */
+	uint32_t getId(const LogString& value)
+	{
+		auto pItem = idByAddress.find(&value);
+
+		if (pItem != idByAddress.end())
+		{
+			return pItem->second;
+		}
+
+		uint32_t id = addDictionaryEntry(value);
+		idByAddress[&value] = id;
+		return id;
+	}
+
+	/**
+	 * The identifier of \c value, which is a string literal.
+	 */
+	uint32_t getId(const char* value)
+	{
+		value = nonNull(value);
+		auto pItem = idByAddress.find(value);
+
+		if (pItem != idByAddress.end())
+		{
+			return pItem->second;
+		}
+
+		uint32_t id = addDictionaryEntry(value, strlen(value));
+		idByAddress[value] = id;
+		return id;
+	}
+
+	uint32_t getId(const LevelPtr& level)
+	{
+		auto pItem = idByAddress.find(level.get());
+
+		if (pItem != idByAddress.end())
+		{
+			return pItem->second;
+		}
+
+		uint32_t id = addDictionaryEntry(level->toString());
+		idByAddress[level.get()] = id;
+		levels.push_back(level);
+		return id;
+	}
+
+	uint32_t getMDCKeyId(const LogString& key)
+	{
+		auto pItem = idByValue.find(key);
+
+		if (pItem != idByValue.end())
+		{
+			return pItem->second;
+		}
+
+		uint32_t id = addDictionaryEntry(key);
+		idByValue[key] = id;
+		return id;
+	}
+
+	void addEvent(const LoggingEventPtr& event)
+	{
+		uint32_t loggerId = getId(event->getLoggerName());
+		uint32_t levelId = getId(event->getLevel());
+		uint32_t threadId = getId(event->getThreadName());
+		uint32_t threadUserId = getId(event->getThreadUserName());
+
+		const LocationInfo& location = event->getLocationInformation();
+		bool hasLocation = location.getFileName() != LocationInfo::NA;
+		uint32_t fileId = 0, shortFileId = 0, functionId = 0;
+
+		if (hasLocation)
+		{
+			fileId = getId(location.getFileName());
+			shortFileId = getId(location.getShortFileName());
+			functionId = getId(location.getFunctionName());
+		}
+
+		LogString ndc;
+		bool hasNDC = event->getNDC(ndc);
+
+		LoggingEvent::KeySet mdcKeys = event->getMDCKeySet();
+		std::vector<uint32_t> mdcKeyIds;
+
+		for (auto& key : mdcKeys)
+		{
+			mdcKeyIds.push_back(getMDCKeyId(key));
+		}
+
+		putSignedVarint(record, event->getTimeStamp() - lastTimeStamp);
+		lastTimeStamp = event->getTimeStamp();
+		putSignedVarint(record, event->getLevel()->toInt());
+		putVarint(record, event->getLevel()->getSyslogEquivalent());
+		putVarint(record, levelId);
+		putVarint(record, loggerId);
+		putVarint(record, threadId);
+		putVarint(record, threadUserId);
+		putLogString(record, event->getMessage(), scratch);
+		putVarint(record, (hasNDC ? HasNDC : 0) | (hasLocation ? HasLocation : 0));
+
+		if (hasNDC)
+		{
+			putLogString(record, ndc, scratch);
+		}
+
+		if (hasLocation)
+		{
+			putVarint(record, fileId);
+			putVarint(record, shortFileId);
+			putVarint(record, functionId);
+			putSignedVarint(record, location.getLineNumber());
+		}
+
+		putVarint(record, mdcKeys.size());
+
+		for (size_t i = 0; i < mdcKeys.size(); ++i)
+		{
+			LogString value;
+			event->getMDC(mdcKeys[i], value);
+			putVarint(record, mdcKeyIds[i]);
+			putLogString(record, value, scratch);
+		}
+
+		addRecord(Event, record);
+	}
+
+	void writeBuffer(Pool& p)
+	{
+		if (out && !buffer.empty())
+		{
+			ByteBuffer buf(&buffer[0], buffer.size());
+			out->write(buf, p);
+			buffer.clear();
+		}
+	}
+
+	/**
+	 * Drop the records that could not be written.
+	 * They may include dictionary entries that later records would refer to,
+	 * so a new dictionary is started.
+	 */
+	void discardBuffer()
+	{
+		buffer.clear();
+		addHeader();
+	}
+
+	void closeFile(Pool& p)
+	{
+		if (out)
+		{
+			try
+			{
+				writeBuffer(p);
+				out->close(p);
+			}
+			catch (IOException& e)
+			{
+				LogLog::error(LOG4CXX_STR("Could not close ") + fileName, e);
+			}
+
+			out.reset();
+		}
+
+		buffer.clear();
+	}
+};
+
+IMPLEMENT_LOG4CXX_OBJECT(BinaryJournalAppender)
+
+#define _priv static_cast<BinaryJournalAppenderPriv*>(m_priv.get())
+
+BinaryJournalAppender::BinaryJournalAppender()
+	: AppenderSkeleton(std::make_unique<BinaryJournalAppenderPriv>())
+{
+}
+
+BinaryJournalAppender::BinaryJournalAppender(const LogString& filename, bool append)
+	: AppenderSkeleton(std::make_unique<BinaryJournalAppenderPriv>(filename, append))
+{
+	Pool p;
+	activateOptions(p);
+}
+
+BinaryJournalAppender::~BinaryJournalAppender()
+{
+	finalize();
+}
+
+void BinaryJournalAppender::activateOptions(Pool& p)
+{
+	std::lock_guard<std::recursive_mutex> lock(_priv->mutex);
+	_priv->closeFile(p);
+
+	if (_priv->fileName.empty())
+	{
+		LogLog::error(LogString(LOG4CXX_STR("File option not set for appender ["))
+			+  _priv->name + LOG4CXX_STR("]."));
+		return;
+	}
+
+	try
+	{
+		try
+		{
+			_priv->out = std::make_shared<FileOutputStream>(_priv->fileName, _priv->fileAppend);
+		}
+		catch (IOException&)
+		{
+			LogString parentName = File().setPath(_priv->fileName).getParent(p);
+
+			if (parentName.empty())
+			{
+				throw;
+			}
+
+			File parentDir;
+			parentDir.setPath(parentName);
+
+			if (parentDir.exists(p) || !parentDir.mkdirs(p))
+			{
+				throw;
+			}
+
+			_priv->out = std::make_shared<FileOutputStream>(_priv->fileName, _priv->fileAppend);
+		}
+
+		_priv->addHeader();
+		_priv->writeBuffer(p);
+	}
+	catch (IOException& e)
+	{
+		_priv->out.reset();
+		_priv->buffer.clear();
+		_priv->errorHandler->error(LOG4CXX_STR("Could not open ") + _priv->fileName
+			, e, ErrorCode::FILE_OPEN_FAILURE);
+	}
+}
+
+void BinaryJournalAppender::setOption(const LogString& option, const LogString& value)
+{
+	if (StringHelper::equalsIgnoreCase(option, LOG4CXX_STR("FILE"), LOG4CXX_STR("file"))
+		|| StringHelper::equalsIgnoreCase(option, LOG4CXX_STR("FILENAME"), LOG4CXX_STR("filename")))
+	{
+		setFile(value);
+	}
+	else if (StringHelper::equalsIgnoreCase(option, LOG4CXX_STR("APPEND"), LOG4CXX_STR("append")))
+	{
+		setAppend(OptionConverter::toBoolean(value, true));
+	}
+	else if (StringHelper::equalsIgnoreCase(option, LOG4CXX_STR("IMMEDIATEFLUSH"), LOG4CXX_STR("immediateflush")))
+	{
+		setImmediateFlush(OptionConverter::toBoolean(value, true));
+	}
+	else if (StringHelper::equalsIgnoreCase(option, LOG4CXX_STR("BUFFERSIZE"), LOG4CXX_STR("buffersize")))
+	{
+		setBufferSize((int) OptionConverter::toFileSize(value, DEFAULT_BUFFER_SIZE));
+	}
+	else
+	{
+		AppenderSkeleton::setOption(option, value);
+	}
+}
+
+void BinaryJournalAppender::append(const LoggingEventPtr& event, Pool& p)
+{
+	if (!_priv->out)
+	{
+		_priv->errorHandler->error(LOG4CXX_STR("No output stream set for the appender named [")
+			+ _priv->name + LOG4CXX_STR("]."));
+		return;
+	}
+
+	_priv->addEvent(event);
+
+	if (_priv->immediateFlush || _priv->bufferSize <= (int) _priv->buffer.size())
+	{
+		try
+		{
+			_priv->writeBuffer(p);
+
+			if (_priv->immediateFlush)
+			{
+				_priv->out->flush(p);
+			}
+		}
+		catch (IOException& e)
+		{
+			_priv->discardBuffer();
+			_priv->errorHandler->error(LOG4CXX_STR("Could not write to ") + _priv->fileName
+				, e, ErrorCode::WRITE_FAILURE);
+		}
+	}
+}
+
+void BinaryJournalAppender::setOutputStream(const OutputStreamPtr& out, Pool& p)
+{
+	std::lock_guard<std::recursive_mutex> lock(_priv->mutex);
+	_priv->closeFile(p);
+	_priv->out = out;
+	_priv->addHeader();
+
+	try
+	{
+		_priv->writeBuffer(p);
+	}
+	catch (IOException& e)
+	{
+		_priv->discardBuffer();
+		_priv->errorHandler->error(LOG4CXX_STR("Could not write to ") + _priv->fileName
+			, e, ErrorCode::WRITE_FAILURE);
+	}
+}
+
+void BinaryJournalAppender::close()
+{
+	std::lock_guard<std::recursive_mutex> lock(_priv->mutex);
+
+	if (_priv->closed)
+	{
+		return;
+	}
+
+	_priv->closed = true;
+	_priv->closeFile(_priv->pool);
+}
+
+bool BinaryJournalAppender::requiresLayout() const
+{
+	return false;
+}
+
+LogString BinaryJournalAppender::getFile() const
+{
+	return _priv->fileName;
+}
+
+void BinaryJournalAppender::setFile(const LogString& file)
+{
+	std::lock_guard<std::recursive_mutex> lock(_priv->mutex);
+	_priv->fileName = file;
+}
+
+bool BinaryJournalAppender::getAppend() const
+{
+	return _priv->fileAppend;
+}
+
+void BinaryJournalAppender::setAppend(bool value)
+{
+	std::lock_guard<std::recursive_mutex> lock(_priv->mutex);
+	_priv->fileAppend = value;
+}
+
+bool BinaryJournalAppender::getImmediateFlush() const
+{
+	return _priv->immediateFlush;
+}
+
+void BinaryJournalAppender::setImmediateFlush(bool value)
+{
+	std::lock_guard<std::recursive_mutex> lock(_priv->mutex);
+	_priv->immediateFlush = value;
+}
+
+int BinaryJournalAppender::getBufferSize() const
+{
+	return _priv->bufferSize;
+}
+
+void BinaryJournalAppender::setBufferSize(int value)
+{
+	std::lock_guard<std::recursive_mutex> lock(_priv->mutex);
+	_priv->bufferSize = value;
+}
@@ -0,0 +1,358 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <log4cxx/helpers/binaryjournalreader.h>
+#include <log4cxx/helpers/fileinputstream.h>
+#include <log4cxx/helpers/bytebuffer.h>
+#include <log4cxx/helpers/transcoder.h>
+#include <log4cxx/helpers/exception.h>
+#include <log4cxx/helpers/loglog.h>
+#include <log4cxx/private/binaryjournal.h>
+#include <deque>
+#include <map>
+#include <cstring>
+#include <algorithm>
+
+using namespace log4cxx;
+using namespace log4cxx::helpers;
+using namespace log4cxx::spi;
+using namespace log4cxx::helpers::BinaryJournal;
+
+struct BinaryJournalReader::BinaryJournalReaderPrivate
+{
+	BinaryJournalReaderPrivate(const File& file) :
+		in(std::make_shared<FileInputStream>(file)),
+		fileName(file.getPath()),
+		begin(0),
+		end(0),
+		endOfFile(false),
+		started(false),
+		lastTimeStamp(0)
+	{
+	}
+
+	InputStreamPtr in;
+	LogString fileName;
+
+	/** Bytes read from the file, of which [begin, end) are not yet used. */
+	std::vector<char> data;
+	size_t begin;
+	size_t end;
+	bool endOfFile;
+
+	/** Has a header record been read? */
+	bool started;
+
+	/** Every dictionary string read, never released as events refer to them. */
+	std::deque<std::string> strings;
+
+	/** The strings of the current session by identifier. */
+	std::vector<const std::string*> dictionary;
+
+	std::map<std::pair<int, LogString>, LevelPtr> levels;
+
+	log4cxx_time_t lastTimeStamp;
+
+	void malformed()
+	{
+		throw IOException(fileName + LOG4CXX_STR(" contains a malformed record"));
+	}
+
+	/**
+	 * Read from the file until \c count bytes are available or the file ends.
+	 */
+	void fill(size_t count)
+	{
+		if (end - begin < count && 0 < begin)
+		{
+			data.erase(data.begin(), data.begin() + begin);
+			end -= begin;
+			begin = 0;
+		}
+
+		while (end - begin < count && !endOfFile)
+		{
+			size_t wanted = std::max(begin + count, end + 8 * 1024);
+
+			if (data.size() < wanted)
+			{
+				data.resize(wanted);
+			}
+
+			ByteBuffer buf(&data[end], data.size() - end);
+
+			if (in->read(buf) < 0)
+			{
+				endOfFile = true;
+			}
+			else
+			{
+				end += buf.position();
+			}
+		}
+	}
+
+	/**
+	 * Get the next complete record.
+	 *
+	 * @return false at the end of the file.
+	 */
+	bool readRecord(RecordType& type, const char*& next, const char*& last)
+	{
+		fill(10);
+
+		if (begin == end)
+		{
+			return false;
+		}
+
+		const char* start = &data[begin];
+		next = start;
+		uint64_t size;
+
+		if (!getVarint(next, start + (end - begin), size) || size == 0)
+		{
+			return truncated();
+		}
+
+		if (MaxRecordSize < size)
+		{
+			malformed();
+		}
+
+		size_t headerSize = next - start;
+		fill(headerSize + size);
+
+		if (end - begin < headerSize + size)
+		{
+			return truncated();
+		}
+
+		next = &data[begin + headerSize];
+		type = static_cast<RecordType>(*next++);
+		last = next + size - 1;
+		begin += headerSize + size;
+		return true;
+	}
+
+	bool truncated()
+	{
+		if (!endOfFile)
+		{
+			malformed();
+		}
+
+		LogLog::warn(fileName + LOG4CXX_STR(" ends with an incomplete record"));
+		begin = end;
+		return false;
+	}
+
+	void readHeader(const char* next, const char* last)
+	{
+		uint64_t version;
+
+		if (last - next < (ptrdiff_t) sizeof(Magic)
+			|| memcmp(next, Magic, sizeof(Magic)) != 0)
+		{
+			throw IOException(fileName + LOG4CXX_STR(" is not a journal"));
+		}
+
+		next += sizeof(Magic);
+
+		if (!getVarint(next, last, version) || Version < version)
+		{
+			throw IOException(fileName + LOG4CXX_STR(" has an unsupported version"));
+		}
+
+		started = true;
+		dictionary.clear();
+		lastTimeStamp = 0;
+	}
+
+	void readDictionaryEntry(const char* next, const char* last)
+	{
+		uint64_t id;
+
+		if (!getVarint(next, last, id) || id != dictionary.size())
+		{
+			malformed();
+		}
+
+		strings.push_back(std::string(next, last));
+		dictionary.push_back(&strings.back());
+	}
+
+	const std::string& getEntry(const char*& next, const char* last)
+	{
+		uint64_t id;
+
+		if (!getVarint(next, last, id) || dictionary.size() <= id)
+		{
+			malformed();
+		}
+
+		return *dictionary[id];
+	}
+
+	LogString getLogString(const char*& next, const char* last)
+	{
+		std::string value;
+
+		if (!getString(next, last, value))
+		{
+			malformed();
+		}
+
+		LogString result;
+		Transcoder::decodeUTF8(value, result);
+		return result;
+	}
+
+	LogString getEntryLogString(const char*& next, const char* last)
+	{
+		LogString result;
+		Transcoder::decodeUTF8(getEntry(next, last), result);
+		return result;
+	}
+
+	int64_t getSigned(const char*& next, const char* last)
+	{
+		int64_t value;
+
+		if (!getSignedVarint(next, last, value))
+		{
+			malformed();
+		}
+
+		return value;
+	}
+
+	uint64_t getUnsigned(const char*& next, const char* last)
+	{
+		uint64_t value;
+
+		if (!getVarint(next, last, value))
+		{
+			malformed();
+		}
+
+		return value;
+	}
+
+	LevelPtr getLevel(int value, int syslogEquivalent, const LogString& name)
+	{
+		auto key = std::make_pair(value, name);
+		auto pItem = levels.find(key);
+
+		if (pItem != levels.end())
+		{
+			return pItem->second;
+		}
+
+		LevelPtr level = Level::toLevel(value, LevelPtr());
+
+		if (!level || level->toString() != name)
+		{
+			level = std::make_shared<Level>(value, name, syslogEquivalent);
+		}
+
+		levels[key] = level;
+		return level;
+	}
+
+	LoggingEventPtr readEvent(const char* next, const char* last)
+	{
+		lastTimeStamp += getSigned(next, last);
+		int levelValue = static_cast<int>(getSigned(next, last));
+		int syslogEquivalent = static_cast<int>(getUnsigned(next, last));
+		LevelPtr level = getLevel(levelValue, syslogEquivalent, getEntryLogString(next, last));
+		LogString logger = getEntryLogString(next, last);
+		LogString threadName = getEntryLogString(next, last);
+		LogString threadUserName = getEntryLogString(next, last);
+		LogString message = getLogString(next, last);
+		uint64_t flags = getUnsigned(next, last);
+		LogString ndc;
+
+		if (flags & HasNDC)
+		{
+			ndc = getLogString(next, last);
+		}
+
+		LocationInfo location;
+
+		if (flags & HasLocation)
+		{
+			const std::string& fileName = getEntry(next, last);
+			const std::string& shortFileName = getEntry(next, last);
+			const std::string& functionName = getEntry(next, last);
+			int lineNumber = static_cast<int>(getSigned(next, last));
+			location = LocationInfo(fileName.c_str(), shortFileName.c_str(), functionName.c_str(), lineNumber);
+		}
+
+		MDC::Map mdc;
+		uint64_t mdcCount = getUnsigned(next, last);
+
+		for (uint64_t i = 0; i < mdcCount; ++i)
+		{
+			LogString key = getEntryLogString(next, last);
+			mdc[key] = getLogString(next, last);
+		}
+
+		return std::make_shared<LoggingEvent>(logger, level, message, location
+			, lastTimeStamp, threadName, threadUserName
+			, (flags & HasNDC) ? &ndc : 0, mdc);
+	}
+};
+
+BinaryJournalReader::BinaryJournalReader(const File& file) :
+	m_priv(std::make_unique<BinaryJournalReaderPrivate>(file))
+{
+}
+
+BinaryJournalReader::~BinaryJournalReader()
+{
+}
+
+LoggingEventPtr BinaryJournalReader::read()
+{
+	RecordType type;
+	const char* next;
+	const char* last;
+
+	while (m_priv->readRecord(type, next, last))
+	{
+		if (type == Header)
+		{
+			m_priv->readHeader(next, last);
+		}
+		else if (!m_priv->started)
+		{
+			throw IOException(m_priv->fileName + LOG4CXX_STR(" is not a journal"));
+		}
+		else if (type == Dictionary)
+		{
+			m_priv->readDictionaryEntry(next, last);
+		}
+		else if (type == Event)
+		{
+			return m_priv->readEvent(next, last);
+		}
+		// Records of other types are from a later version
+	}
+
+	return LoggingEventPtr();
+}
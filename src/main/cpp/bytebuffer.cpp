@@ -18,6 +18,7 @@
 #include <log4cxx/helpers/bytebuffer.h>
 #include <log4cxx/helpers/exception.h>
 #include <log4cxx/helpers/pool.h>
+#include <log4cxx/private/recycling_allocator.h>
 
 using namespace log4cxx;
 using namespace log4cxx::helpers;
@@ -27,6 +28,31 @@ struct ByteBuffer::ByteBufferPriv
 	ByteBufferPriv(char* data1, size_t capacity) :
 		base(data1), pos(0), lim(capacity), cap(capacity) {}
 
+	/**
+	 * Reuse the memory of released instances.
+	 */
+	static void* operator new(size_t size)
+	{
+		if (size != sizeof(ByteBufferPriv))
+		{
+			return ::operator new(size);
+		}
+
+		return BlockPool<sizeof(ByteBufferPriv), alignof(ByteBufferPriv)>::allocate();
+	}
+
+	static void operator delete(void* p, size_t size)
+	{
+		if (size != sizeof(ByteBufferPriv))
+		{
+			::operator delete(p);
+		}
+		else
+		{
+			BlockPool<sizeof(ByteBufferPriv), alignof(ByteBufferPriv)>::deallocate(p);
+		}
+	}
+
 	char* base;
 	size_t pos;
 	size_t lim;
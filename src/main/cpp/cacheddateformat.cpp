@@ -24,44 +24,103 @@
 #include <log4cxx/helpers/pool.h>
 #include <limits>
 #include <log4cxx/helpers/exception.h>
+#include <log4cxx/private/atomic_shared_ptr.h>
 
 using namespace log4cxx;
 using namespace log4cxx::helpers;
 using namespace log4cxx::pattern;
 
-struct CachedDateFormat::CachedDateFormatPriv
+namespace
 {
-	CachedDateFormatPriv(DateFormatPtr dateFormat, int expiration1) :
-		formatter(dateFormat),
-		millisecondStart(0),
-		slotBegin(std::numeric_limits<log4cxx_time_t>::min()),
-		cache(50, 0x20),
-		expiration(expiration1),
-		previousTime(std::numeric_limits<log4cxx_time_t>::min())
-	{}
+
+/**
+ *  A formatted time and the integral second containing it.
+ */
+struct CachedSlot
+{
+	/**
+	 *  The time formatted in text.
+	 */
+	log4cxx_time_t time;
 
 	/**
-	 *   Wrapped formatter.
+	 *  Integral second preceding time.
 	 */
-	log4cxx::helpers::DateFormatPtr formatter;
+	log4cxx_time_t slotBegin;
 
 	/**
 	 *  Index of initial digit of millisecond pattern or
 	 *   UNRECOGNIZED_MILLISECONDS or NO_MILLISECONDS.
 	 */
-	mutable int millisecondStart;
+	int millisecondStart;
 
 	/**
-	 *  Integral second preceding the previous convered Date.
+	 *  The number of digits at millisecondStart, 3 or 6 (microseconds).
 	 */
-	mutable log4cxx_time_t slotBegin;
+	int fractionDigits;
 
+	LogString text;
+};
+
+typedef std::shared_ptr<const CachedSlot> CachedSlotPtr;
+
+/**
+ *  The slots most recently used by this thread.
+ */
+struct LocalSlots
+{
+	enum { Size = 4 };
+
+	struct Entry
+	{
+		uint64_t generation = 0;
+		CachedSlotPtr slot;
+	};
+
+	Entry entries[Size];
+	int next = 0;
+
+	Entry& get(uint64_t generation)
+	{
+		for (auto& entry : entries)
+		{
+			if (entry.generation == generation)
+			{
+				return entry;
+			}
+		}
+
+		Entry& result = entries[next];
+		next = (next + 1) % Size;
+		result.generation = generation;
+		result.slot.reset();
+		return result;
+	}
+};
+
+/**
+ *  Identifies a formatter and time zone to the slots held by each thread.
+ */
+uint64_t nextGeneration()
+{
+	static std::atomic<uint64_t> generation(0);
+	return ++generation;
+}
+
+} // namespace
+
+struct CachedDateFormat::CachedDateFormatPriv
+{
+	CachedDateFormatPriv(DateFormatPtr dateFormat, int expiration1) :
+		formatter(dateFormat),
+		expiration(expiration1),
+		generation(nextGeneration())
+	{}
 
 	/**
-	 *  Cache of previous conversion.
+	 *   Wrapped formatter.
 	 */
-	mutable LogString cache;
-
+	log4cxx::helpers::DateFormatPtr formatter;
 
 	/**
 	 *  Maximum validity period for the cache.
@@ -71,9 +130,83 @@ struct CachedDateFormat::CachedDateFormatPriv
 	const int expiration;
 
 	/**
-	 *  Date requested in previous conversion.
+	 *  The most recently formatted second, shared by all threads.
+	 */
+	AtomicSharedPtr<const CachedSlot> current;
+
+	/**
+	 *  Changed when the cached text is no longer valid.
+	 */
+	std::atomic<uint64_t> generation;
+
+	/**
+	 *  Can \c slot be used for \c now?
 	 */
-	mutable log4cxx_time_t previousTime;
+	bool isValid(const CachedSlot* slot, log4cxx_time_t now) const
+	{
+		if (!slot)
+		{
+			return false;
+		}
+
+		if (now == slot->time)
+		{
+			return true;
+		}
+
+		//    If the millisecond pattern was not unrecognized and
+		//       the requested time is within the same integral second
+		//       and a shorter expiration was not requested.
+		return slot->millisecondStart != UNRECOGNIZED_MILLISECONDS
+			&& now >= slot->slotBegin
+			&& now < slot->slotBegin + expiration
+			&& now < slot->slotBegin + 1000000L;
+	}
+
+	/**
+	 *  Use the underlying formatter to format \c now.
+	 */
+	CachedSlotPtr newSlot(log4cxx_time_t now, const CachedSlot* previous, Pool& p) const
+	{
+		auto result = std::make_shared<CachedSlot>();
+		result->time = now;
+		result->slotBegin = (now / 1000000) * 1000000;
+
+		if (result->slotBegin > now)
+		{
+			result->slotBegin -= 1000000;
+		}
+
+		formatter->format(result->text, now, p);
+		result->fractionDigits = 3;
+
+		//
+		//    if the milliseconds field was previous found
+		//       then reevaluate in case it moved.
+		//
+		result->millisecondStart = previous ? previous->millisecondStart : 0;
+
+		if (result->millisecondStart >= 0)
+		{
+			result->millisecondStart = findMillisecondStart(now, result->text, formatter, p);
+		}
+
+		if (result->millisecondStart >= 0)
+		{
+			//   Is it a microsecond field?
+			const logchar micros[] = { 0x36, 0x35, 0x34, 0x33, 0x32, 0x31, 0 };
+			LogString plusMicros;
+			formatter->format(plusMicros, result->slotBegin + 654321, p);
+
+			if (plusMicros.length() == result->text.length()
+				&& regionMatches(micros, 0, plusMicros, result->millisecondStart, 6))
+			{
+				result->fractionDigits = 6;
+			}
+		}
+
+		return result;
+	}
 };
 
 
@@ -240,74 +373,54 @@ int CachedDateFormat::findMillisecondStart(
 /**
  * Formats a millisecond count into a date/time string.
  *
+ * Text formatted by one thread is used by other threads
+ * for requests within the same integral second.
+ * Each thread then updates the millisecond (or microsecond) field
+ * in its own copy of the text.
+ *
  *  @param now Number of milliseconds after midnight 1 Jan 1970 GMT.
  *  @param sbuf the string buffer to write to
  */
 void CachedDateFormat::format(LogString& buf, log4cxx_time_t now, Pool& p) const
 {
+	thread_local LocalSlots localSlots;
+	auto& local = localSlots.get(m_priv->generation.load(std::memory_order_acquire));
 
-	//
-	// If the current requested time is identical to the previously
-	//     requested time, then append the cache contents.
-	//
-	if (now == m_priv->previousTime)
+	if (!m_priv->isValid(local.slot.get(), now))
 	{
-		buf.append(m_priv->cache);
-		return;
-	}
+		auto slot = m_priv->current.load();
 
-	//
-	//   If millisecond pattern was not unrecognized
-	//     (that is if it was found or milliseconds did not appear)
-	//
-	if (m_priv->millisecondStart != UNRECOGNIZED_MILLISECONDS)
-	{
-		//    Check if the cache is still valid.
-		//    If the requested time is within the same integral second
-		//       as the last request and a shorter expiration was not requested.
-		if (now < m_priv->slotBegin + m_priv->expiration
-			&& now >= m_priv->slotBegin
-			&& now < m_priv->slotBegin + 1000000L)
+		if (!m_priv->isValid(slot.get(), now))
 		{
-			//
-			//    if there was a millisecond field then update it
-			//
-			if (m_priv->millisecondStart >= 0)
-			{
-				millisecondFormat((int) ((now - m_priv->slotBegin) / 1000), m_priv->cache, m_priv->millisecondStart);
-			}
-
-			//
-			//   update the previously requested time
-			//      (the slot begin should be unchanged)
-			m_priv->previousTime = now;
-			buf.append(m_priv->cache);
-
-			return;
+			//  could not use previous value.
+			//    Call underlying formatter to format date.
+			slot = m_priv->newSlot(now, slot.get(), p);
+			m_priv->current.store(slot);
 		}
-	}
 
-	//
-	//  could not use previous value.
-	//    Call underlying formatter to format date.
-	m_priv->cache.erase(m_priv->cache.begin(), m_priv->cache.end());
-	m_priv->formatter->format(m_priv->cache, now, p);
-	buf.append(m_priv->cache);
-	m_priv->previousTime = now;
-	m_priv->slotBegin = (m_priv->previousTime / 1000000) * 1000000;
-
-	if (m_priv->slotBegin > m_priv->previousTime)
-	{
-		m_priv->slotBegin -= 1000000;
+		local.slot = slot;
 	}
 
+	const CachedSlot& slot = *local.slot;
+	int start = (int)buf.length();
+	buf.append(slot.text);
+
 	//
-	//    if the milliseconds field was previous found
-	//       then reevaluate in case it moved.
+	//    if there was a millisecond field then update it
 	//
-	if (m_priv->millisecondStart >= 0)
+	if (now != slot.time && slot.millisecondStart >= 0)
 	{
-		m_priv->millisecondStart = findMillisecondStart(now, m_priv->cache, m_priv->formatter, p);
+		int fraction = (int) (now - slot.slotBegin);
+
+		if (slot.fractionDigits == 3)
+		{
+			millisecondFormat(fraction / 1000, buf, start + slot.millisecondStart);
+		}
+		else
+		{
+			millisecondFormat(fraction / 1000, buf, start + slot.millisecondStart);
+			millisecondFormat(fraction % 1000, buf, start + slot.millisecondStart + 3);
+		}
 	}
 }
 
@@ -337,8 +450,8 @@ void CachedDateFormat::millisecondFormat(int millis,
 void CachedDateFormat::setTimeZone(const TimeZonePtr& timeZone)
 {
 	m_priv->formatter->setTimeZone(timeZone);
-	m_priv->previousTime = std::numeric_limits<log4cxx_time_t>::min();
-	m_priv->slotBegin = std::numeric_limits<log4cxx_time_t>::min();
+	m_priv->current.store(CachedSlotPtr());
+	m_priv->generation = nextGeneration();
 }
 
 
@@ -359,23 +472,26 @@ void CachedDateFormat::numberFormat(LogString& s, int n, Pool& p) const
 int CachedDateFormat::getMaximumCacheValidity(const LogString& pattern)
 {
 	//
-	//   If there are more "S" in the pattern than just one "SSS" then
+	//   If there are more "S" in the pattern than just one "SSS" or "SSSSSS" then
 	//      (for example, "HH:mm:ss,SSS SSS"), then set the expiration to
 	//      one millisecond which should only perform duplicate request caching.
 	//
 	const logchar S = 0x53;
-	const logchar SSS[] = { 0x53, 0x53, 0x53, 0 };
 	size_t firstS = pattern.find(S);
-	size_t len = pattern.length();
+
+	if (firstS == LogString::npos)
+	{
+		return 1000000;
+	}
+
+	size_t endS = pattern.find_first_not_of(S, firstS);
+	size_t countS = (endS == LogString::npos ? pattern.length() : endS) - firstS;
 
 	//
-	//   if there are no S's or
-	//      three that start with the first S and no fourth S in the string
+	//   if three or six S's start with the first S and there are no more S's in the string
 	//
-	if (firstS == LogString::npos ||
-		(len >= firstS + 3 && pattern.compare(firstS, 3, SSS) == 0
-			&& (len == firstS + 3 ||
-				pattern.find(S, firstS + 3) == LogString::npos)))
+	if ((countS == 3 || countS == 6)
+		&& (endS == LogString::npos || pattern.find(S, endS) == LogString::npos))
 	{
 		return 1000000;
 	}
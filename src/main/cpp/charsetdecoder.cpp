@@ -26,6 +26,7 @@
 	#define LOG4CXX 1
 #endif
 #include <log4cxx/private/log4cxx_private.h>
+#include <log4cxx/private/asciirun.h>
 #include <locale.h>
 #include <apr_portable.h>
 #include <log4cxx/helpers/stringhelper.h>
@@ -294,6 +295,12 @@ class UTF8CharsetDecoder : public CharsetDecoder
 
 				while (iter != tmp.end())
 				{
+					if (((unsigned char) *iter) < 0x80)
+					{
+						iter += AsciiRun::append(out, &*iter, tmp.end() - iter);
+						continue;
+					}
+
 					unsigned int sv = Transcoder::decode(tmp, iter);
 
 					if (sv == 0xFFFF)
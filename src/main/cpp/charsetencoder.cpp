@@ -28,6 +28,7 @@
 #endif
 
 #include <log4cxx/private/log4cxx_private.h>
+#include <log4cxx/private/asciirun.h>
 #include <apr_portable.h>
 #include <mutex>
 
@@ -358,6 +359,16 @@ class UTF8CharsetEncoder : public CharsetEncoder
 		{
 			while (iter != in.end() && out.remaining() >= 8)
 			{
+				if (((unsigned int) *iter) < 0x80)
+				{
+					size_t count = std::min(size_t(in.end() - iter), out.remaining());
+					count = AsciiRun::length(&*iter, count);
+					AsciiRun::convert(&*iter, count, out.current());
+					out.position(out.position() + count);
+					iter += count;
+					continue;
+				}
+
 				unsigned int sv = Transcoder::decode(in, iter);
 
 				if (sv == 0xFFFF)
@@ -628,6 +639,11 @@ void CharsetEncoder::encode(CharsetEncoderPtr& enc,
 	}
 }
 
+bool CharsetEncoder::isUTF8(const CharsetEncoderPtr& enc)
+{
+	return !!dynamic_cast<UTF8CharsetEncoder*>(enc.get());
+}
+
 bool CharsetEncoder::isTriviallyCopyable(const LogString& src, const CharsetEncoderPtr& enc)
 {
 	bool result;
@@ -31,6 +31,8 @@
 #include <log4cxx/asyncappender.h>
 #include <log4cxx/consoleappender.h>
 #include <log4cxx/fileappender.h>
+#include <log4cxx/mappedfileappender.h>
+#include <log4cxx/binaryjournalappender.h>
 #include <log4cxx/db/odbcappender.h>
 #if defined(WIN32) || defined(_WIN32)
 	#if !defined(_WIN32_WCE)
@@ -163,8 +165,10 @@ void Class::registerClasses()
 #if APR_HAS_THREADS
 	AsyncAppender::registerClass();
 #endif
+	BinaryJournalAppender::registerClass();
 	ConsoleAppender::registerClass();
 	FileAppender::registerClass();
+	MappedFileAppender::registerClass();
 	log4cxx::db::ODBCAppender::registerClass();
 #if (defined(WIN32) || defined(_WIN32))
 #if !defined(_WIN32_WCE)
@@ -28,6 +28,7 @@
 #include <log4cxx/helpers/loglog.h>
 #include <log4cxx/helpers/date.h>
 #include <log4cxx/private/patternconverter_priv.h>
+#include <log4cxx/private/nametable.h>
 
 using namespace log4cxx;
 using namespace log4cxx::pattern;
@@ -36,13 +37,30 @@ using namespace log4cxx::helpers;
 
 struct DatePatternConverter::DatePatternConverterPrivate : public PatternConverterPrivate
 {
-	DatePatternConverterPrivate( const LogString& name, const LogString& style, DateFormatPtr _df ):
+	DatePatternConverterPrivate( const LogString& name, const LogString& style, DateFormatPtr _df, const void* _key ):
 		PatternConverterPrivate(name, style),
-		df(_df) {}
+		df(_df),
+		key(_key) {}
 	/**
 	 * Date format.
 	 */
 	log4cxx::helpers::DateFormatPtr df;
+
+	/**
+	 * Shared by converters with the same options.
+	 */
+	const void* key;
+
+	static const void* getKey(const OptionsList& options)
+	{
+		LogString key(LOG4CXX_STR("%d"));
+		for (auto& option : options)
+		{
+			key.append(1, 0);
+			key.append(option);
+		}
+		return &NameTable::intern(key);
+	}
 };
 
 #define priv static_cast<DatePatternConverterPrivate*>(m_priv.get())
@@ -52,7 +70,7 @@ IMPLEMENT_LOG4CXX_OBJECT(DatePatternConverter)
 DatePatternConverter::DatePatternConverter(
 	const std::vector<LogString>& options) :
 	LoggingEventPatternConverter (std::make_unique<DatePatternConverterPrivate>(LOG4CXX_STR("Class Name"),
-			LOG4CXX_STR("class name"), getDateFormat(options)))
+			LOG4CXX_STR("class name"), getDateFormat(options), DatePatternConverterPrivate::getKey(options)))
 {
 }
 
@@ -141,7 +159,14 @@ void DatePatternConverter::format(
 	LogString& toAppendTo,
 	Pool& p) const
 {
+	if (event->getFormattedField(priv->key, toAppendTo))
+	{
+		return;
+	}
+
+	auto startIndex = toAppendTo.size();
 	priv->df->format(toAppendTo, event->getTimeStamp(), p);
+	event->keepFormattedField(priv->key, toAppendTo.data() + startIndex, toAppendTo.size() - startIndex);
 }
 
 /**
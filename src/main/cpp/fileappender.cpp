@@ -22,11 +22,17 @@
 #include <log4cxx/helpers/optionconverter.h>
 #include <log4cxx/helpers/pool.h>
 #include <log4cxx/helpers/fileoutputstream.h>
+#include <log4cxx/helpers/mappedfileoutputstream.h>
+#include <log4cxx/helpers/iouringfileoutputstream.h>
 #include <log4cxx/helpers/outputstreamwriter.h>
 #include <log4cxx/helpers/bufferedwriter.h>
 #include <log4cxx/helpers/bytebuffer.h>
+#include <log4cxx/helpers/threadutility.h>
 #include <log4cxx/private/writerappender_priv.h>
 #include <log4cxx/private/fileappender_priv.h>
+#include <log4cxx/private/groupcommit.h>
+#include <log4cxx/spi/loggingevent.h>
+#include <apr_file_io.h>
 #include <mutex>
 
 using namespace log4cxx;
@@ -80,9 +86,17 @@ FileAppender::FileAppender(std::unique_ptr<FileAppenderPriv> priv)
 
 FileAppender::~FileAppender()
 {
+	stopFlushTask();
 	finalize();
 }
 
+void FileAppender::close()
+{
+	std::lock_guard<std::recursive_mutex> lock(_priv->mutex);
+	stopFlushTask();
+	WriterAppender::close();
+}
+
 void FileAppender::setAppend(bool fileAppend1)
 {
 	std::lock_guard<std::recursive_mutex> lock(_priv->mutex);
@@ -140,6 +154,46 @@ void FileAppender::setOption(const LogString& option,
 		std::lock_guard<std::recursive_mutex> lock(_priv->mutex);
 		_priv->bufferSize = OptionConverter::toFileSize(value, 8 * 1024);
 	}
+	else if (StringHelper::equalsIgnoreCase(option, LOG4CXX_STR("MAXFLUSHDELAY"), LOG4CXX_STR("maxflushdelay")))
+	{
+		std::lock_guard<std::recursive_mutex> lock(_priv->mutex);
+		_priv->maxFlushDelay = OptionConverter::toInt(value, 0);
+	}
+	else if (StringHelper::equalsIgnoreCase(option, LOG4CXX_STR("MEMORYMAPPED"), LOG4CXX_STR("memorymapped")))
+	{
+		std::lock_guard<std::recursive_mutex> lock(_priv->mutex);
+		_priv->memoryMapped = OptionConverter::toBoolean(value, false);
+	}
+	else if (StringHelper::equalsIgnoreCase(option, LOG4CXX_STR("MAPPEDEXTENTSIZE"), LOG4CXX_STR("mappedextentsize")))
+	{
+		std::lock_guard<std::recursive_mutex> lock(_priv->mutex);
+		_priv->mappedExtentSize = (size_t) OptionConverter::toFileSize(value, MappedFileOutputStream::DefaultExtentSize);
+	}
+	else if (StringHelper::equalsIgnoreCase(option, LOG4CXX_STR("IOURING"), LOG4CXX_STR("iouring")))
+	{
+		std::lock_guard<std::recursive_mutex> lock(_priv->mutex);
+		_priv->ioUring = OptionConverter::toBoolean(value, false);
+	}
+	else if (StringHelper::equalsIgnoreCase(option, LOG4CXX_STR("IOURINGQUEUEDEPTH"), LOG4CXX_STR("iouringqueuedepth")))
+	{
+		std::lock_guard<std::recursive_mutex> lock(_priv->mutex);
+		_priv->ioUringQueueDepth = OptionConverter::toInt(value, IOUringFileOutputStream::DefaultQueueDepth);
+	}
+	else if (StringHelper::equalsIgnoreCase(option, LOG4CXX_STR("SYNCINTERVAL"), LOG4CXX_STR("syncinterval")))
+	{
+		std::lock_guard<std::recursive_mutex> lock(_priv->mutex);
+		_priv->syncInterval = OptionConverter::toInt(value, 0);
+	}
+	else if (StringHelper::equalsIgnoreCase(option, LOG4CXX_STR("SYNCSIZE"), LOG4CXX_STR("syncsize")))
+	{
+		std::lock_guard<std::recursive_mutex> lock(_priv->mutex);
+		_priv->syncSize = (size_t) OptionConverter::toFileSize(value, 0);
+	}
+	else if (StringHelper::equalsIgnoreCase(option, LOG4CXX_STR("SYNCLEVEL"), LOG4CXX_STR("synclevel")))
+	{
+		std::lock_guard<std::recursive_mutex> lock(_priv->mutex);
+		_priv->syncLevel = Level::toLevelLS(value);
+	}
 	else
 	{
 		WriterAppender::setOption(option, value);
@@ -269,14 +323,33 @@ void FileAppender::setFileInternal(
 	size_t bufferSize1,
 	Pool& p)
 {
-	// It does not make sense to have immediate flush and bufferedIO.
-	if (bufferedIO1)
+	// It does not make sense to have immediate flush and bufferedIO
+	// or asynchronous writes.
+	if (bufferedIO1 || _priv->ioUring)
 	{
 		setImmediateFlush(false);
 	}
 
 	closeWriter();
 
+	if (0 < _priv->syncInterval || 0 < _priv->syncSize || _priv->syncLevel)
+	{
+		if (_priv->groupCommit)
+		{
+			_priv->groupCommit->setPolicy(_priv->syncInterval, _priv->syncSize);
+		}
+		else
+		{
+			_priv->groupCommit = std::make_shared<GroupCommit>(_priv->syncInterval, _priv->syncSize);
+		}
+	}
+	else
+	{
+		_priv->groupCommit.reset();
+	}
+
+	_priv->syncThreshold = _priv->syncLevel ? _priv->syncLevel->toInt() : INT_MAX;
+
 	bool writeBOM = false;
 
 	if (StringHelper::equalsIgnoreCase(getEncoding(),
@@ -301,7 +374,7 @@ void FileAppender::setFileInternal(
 
 	try
 	{
-		outStream = FileOutputStreamPtr(new FileOutputStream(filename, append1));
+		outStream = createOutputStream(filename, append1);
 	}
 	catch (IOException&)
 	{
@@ -314,7 +387,7 @@ void FileAppender::setFileInternal(
 
 			if (!parentDir.exists(p) && parentDir.mkdirs(p))
 			{
-				outStream = OutputStreamPtr(new FileOutputStream(filename, append1));
+				outStream = createOutputStream(filename, append1);
 			}
 			else
 			{
@@ -347,6 +420,24 @@ void FileAppender::setFileInternal(
 
 	setWriterInternal(newWriter);
 
+	if (bufferedIO1 && 0 < _priv->maxFlushDelay)
+	{
+		if (_priv->flushTaskName.empty())
+		{
+			Pool taskPool;
+			_priv->flushTaskName = LOG4CXX_STR("FlushFileAppender ");
+			StringHelper::toString((int64_t) reinterpret_cast<intptr_t>(this), taskPool, _priv->flushTaskName);
+		}
+
+		ThreadUtility::instance()->addPeriodicTask(_priv->flushTaskName
+			, std::bind(&FileAppender::flushBuffer, this)
+			, std::chrono::milliseconds(_priv->maxFlushDelay));
+	}
+	else
+	{
+		stopFlushTask();
+	}
+
 	_priv->fileAppend = append1;
 	_priv->bufferedIO = bufferedIO1;
 	_priv->fileName = filename;
@@ -355,6 +446,67 @@ void FileAppender::setFileInternal(
 
 }
 
+OutputStreamPtr FileAppender::createOutputStream(const LogString& filename, bool append1)
+{
+	OutputStreamPtr result;
+	apr_file_t* fileptr = nullptr;
+
+	if (_priv->memoryMapped)
+	{
+		if (MappedFileOutputStream::isSupported())
+		{
+			try
+			{
+				auto mapped = std::make_shared<MappedFileOutputStream>(filename, append1, _priv->mappedExtentSize);
+				fileptr = mapped->getFilePtr();
+				result = mapped;
+			}
+			catch (IOException& e)
+			{
+				LogLog::warn(LOG4CXX_STR("Could not memory map [")
+					+ filename + LOG4CXX_STR("], writing it normally."), e);
+			}
+		}
+		else
+		{
+			LogLog::warn(LOG4CXX_STR("Memory mapped files are not supported, writing [")
+				+ filename + LOG4CXX_STR("] normally."));
+		}
+	}
+
+	if (!result && _priv->ioUring)
+	{
+		if (IOUringFileOutputStream::isSupported())
+		{
+			auto uring = std::make_shared<IOUringFileOutputStream>(filename, append1, _priv->ioUringQueueDepth);
+			fileptr = uring->getFilePtr();
+			result = uring;
+		}
+		else
+		{
+			LogLog::warn(LOG4CXX_STR("io_uring is not available, writing [")
+				+ filename + LOG4CXX_STR("] normally."));
+		}
+	}
+
+	if (!result)
+	{
+		auto plain = std::make_shared<FileOutputStream>(filename, append1);
+		fileptr = plain->getFilePtr();
+		result = plain;
+	}
+
+	if (_priv->groupCommit)
+	{
+		// Only bytes that reached the file are synchronized,
+		// so waitDurable flushes the writer first.
+		result = std::make_shared<GroupCommitOutputStream>(result, _priv->groupCommit,
+			[fileptr]() { return apr_file_datasync(fileptr); });
+	}
+
+	return result;
+}
+
 LogString FileAppender::getFile() const
 {
 	return _priv->fileName;
@@ -379,3 +531,223 @@ bool FileAppender::getAppend() const
 {
 	return _priv->fileAppend;
 }
+
+int FileAppender::getMaxFlushDelay() const
+{
+	return _priv->maxFlushDelay;
+}
+
+void FileAppender::setMaxFlushDelay(int milliseconds)
+{
+	std::lock_guard<std::recursive_mutex> lock(_priv->mutex);
+	_priv->maxFlushDelay = milliseconds;
+}
+
+/**
+ * Write buffered events to the file. Called by the periodic task,
+ * which skips an appender that is in use (it is flushed on the next run).
+ */
+void FileAppender::flushBuffer()
+{
+	std::unique_lock<std::recursive_mutex> lock(_priv->mutex, std::try_to_lock);
+
+	if (!lock.owns_lock() || _priv->closed || !_priv->writer || !_priv->unflushed)
+	{
+		return;
+	}
+
+	_priv->unflushed = false;
+
+	try
+	{
+		Pool p;
+		_priv->writer->flush(p);
+	}
+	catch (IOException& e)
+	{
+		_priv->errorHandler->error(LOG4CXX_STR("Unable to flush log file"), e, ErrorCode::FLUSH_FAILURE);
+	}
+}
+
+void FileAppender::subAppend(const LoggingEventPtr& event, Pool& p)
+{
+	WriterAppender::subAppend(event, p);
+	_priv->unflushed = true;
+}
+
+void FileAppender::subAppend(const LoggingEventList& events, Pool& p)
+{
+	WriterAppender::subAppend(events, p);
+	_priv->unflushed = true;
+}
+
+/**
+ * Remove the periodic task that calls #flushBuffer.
+ * The appender lock may be held as a running task does not wait for it.
+ */
+void FileAppender::stopFlushTask()
+{
+	if (!_priv->flushTaskName.empty())
+	{
+		ThreadUtility::instance()->removePeriodicTask(_priv->flushTaskName);
+		_priv->flushTaskName.clear();
+	}
+}
+
+bool FileAppender::getMemoryMapped() const
+{
+	return _priv->memoryMapped;
+}
+
+void FileAppender::setMemoryMapped(bool memoryMapped1)
+{
+	std::lock_guard<std::recursive_mutex> lock(_priv->mutex);
+	_priv->memoryMapped = memoryMapped1;
+}
+
+size_t FileAppender::getMappedExtentSize() const
+{
+	return _priv->mappedExtentSize;
+}
+
+void FileAppender::setMappedExtentSize(size_t extentSize)
+{
+	std::lock_guard<std::recursive_mutex> lock(_priv->mutex);
+	_priv->mappedExtentSize = extentSize;
+}
+
+bool FileAppender::getIOUring() const
+{
+	return _priv->ioUring;
+}
+
+void FileAppender::setIOUring(bool ioUring1)
+{
+	std::lock_guard<std::recursive_mutex> lock(_priv->mutex);
+	_priv->ioUring = ioUring1;
+}
+
+int FileAppender::getIOUringQueueDepth() const
+{
+	return _priv->ioUringQueueDepth;
+}
+
+void FileAppender::setIOUringQueueDepth(int queueDepth)
+{
+	std::lock_guard<std::recursive_mutex> lock(_priv->mutex);
+	_priv->ioUringQueueDepth = queueDepth;
+}
+
+int FileAppender::getSyncInterval() const
+{
+	return _priv->syncInterval;
+}
+
+void FileAppender::setSyncInterval(int milliseconds)
+{
+	std::lock_guard<std::recursive_mutex> lock(_priv->mutex);
+	_priv->syncInterval = milliseconds;
+}
+
+size_t FileAppender::getSyncSize() const
+{
+	return _priv->syncSize;
+}
+
+void FileAppender::setSyncSize(size_t byteCount)
+{
+	std::lock_guard<std::recursive_mutex> lock(_priv->mutex);
+	_priv->syncSize = byteCount;
+}
+
+LevelPtr FileAppender::getSyncLevel() const
+{
+	return _priv->syncLevel;
+}
+
+void FileAppender::setSyncLevel(const LevelPtr& level)
+{
+	std::lock_guard<std::recursive_mutex> lock(_priv->mutex);
+	_priv->syncLevel = level;
+}
+
+FileAppender::SyncStatistics FileAppender::getSyncStatistics() const
+{
+	std::shared_ptr<GroupCommit> commit;
+	{
+		std::lock_guard<std::recursive_mutex> lock(_priv->mutex);
+		commit = _priv->groupCommit;
+	}
+
+	if (commit)
+	{
+		return commit->getStatistics();
+	}
+
+	return SyncStatistics();
+}
+
+void FileAppender::doAppend(const LoggingEventPtr& event, Pool& p)
+{
+	WriterAppender::doAppend(event, p);
+
+	if (_priv->syncThreshold <= event->getLevel()->toInt())
+	{
+		waitDurable(p);
+	}
+}
+
+void FileAppender::doAppend(const LoggingEventList& events, Pool& p)
+{
+	WriterAppender::doAppend(events, p);
+
+	int threshold = _priv->syncThreshold;
+
+	for (auto& event : events)
+	{
+		if (threshold <= event->getLevel()->toInt())
+		{
+			waitDurable(p);
+			break;
+		}
+	}
+}
+
+/**
+ * Wait (without holding the appender lock) until
+ * the bytes written so far are durable,
+ * reporting a failed sync to the error handler.
+ */
+void FileAppender::waitDurable(Pool& p)
+{
+	std::shared_ptr<GroupCommit> commit;
+	spi::ErrorHandlerPtr handler;
+	uint64_t position = 0;
+	{
+		std::lock_guard<std::recursive_mutex> lock(_priv->mutex);
+
+		if (!_priv->groupCommit || !_priv->writer)
+		{
+			return;
+		}
+
+		try
+		{
+			_priv->writer->flush(p);
+		}
+		catch (IOException& e)
+		{
+			_priv->errorHandler->error(LOG4CXX_STR("Unable to flush log file"), e, ErrorCode::FLUSH_FAILURE);
+			return;
+		}
+
+		commit = _priv->groupCommit;
+		handler = _priv->errorHandler;
+		position = commit->getPosition();
+	}
+
+	if (log4cxx_status_t stat = commit->waitDurable(position))
+	{
+		handler->error(LOG4CXX_STR("Unable to synchronize log file"), IOException(stat), ErrorCode::FLUSH_FAILURE);
+	}
+}
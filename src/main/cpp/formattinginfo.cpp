@@ -18,6 +18,7 @@
 #include <log4cxx/logstring.h>
 #include <log4cxx/pattern/formattinginfo.h>
 #include <limits.h>
+#include <algorithm>
 
 using namespace log4cxx;
 using namespace log4cxx::pattern;
@@ -99,6 +100,51 @@ void FormattingInfo::format(const int fieldStart, LogString& buffer) const
 	}
 }
 
+void FormattingInfo::formatUTF8(const int fieldStart, std::string& buffer) const
+{
+#if LOG4CXX_LOGCHAR_IS_UTF8
+	format(fieldStart, buffer);
+#else
+	int byteLength = int(buffer.length() - fieldStart);
+
+	// A field has no more characters than bytes
+	if (m_priv->minLength <= 0 && byteLength <= m_priv->maxLength)
+	{
+		return;
+	}
+
+	auto isLeadByte = [](char ch) { return (ch & 0xC0) != 0x80; };
+	int rawLength = int(std::count_if(buffer.begin() + fieldStart, buffer.end(), isLeadByte));
+
+	if (rawLength > m_priv->maxLength)
+	{
+		auto fieldEnd = buffer.begin() + fieldStart;
+
+		for (int excess = rawLength - m_priv->maxLength; 0 < excess; --excess)
+		{
+			do
+			{
+				++fieldEnd;
+			}
+			while (fieldEnd != buffer.end() && !isLeadByte(*fieldEnd));
+		}
+
+		buffer.erase(buffer.begin() + fieldStart, fieldEnd);
+	}
+	else if (rawLength < m_priv->minLength)
+	{
+		if (m_priv->leftAlign)
+		{
+			buffer.append(m_priv->minLength - rawLength, ' ');
+		}
+		else
+		{
+			buffer.insert(fieldStart, m_priv->minLength - rawLength, ' ');
+		}
+	}
+#endif
+}
+
 bool FormattingInfo::isLeftAligned() const
 {
 	return m_priv->leftAlign;
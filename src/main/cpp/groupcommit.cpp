@@ -0,0 +1,283 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <log4cxx/logstring.h>
+#include <log4cxx/private/groupcommit.h>
+#include <log4cxx/helpers/bytebuffer.h>
+#include <log4cxx/helpers/exception.h>
+#include <log4cxx/helpers/loglog.h>
+#include <log4cxx/helpers/pool.h>
+#include <log4cxx/helpers/stringhelper.h>
+#include <log4cxx/helpers/threadutility.h>
+
+using namespace log4cxx;
+using namespace log4cxx::helpers;
+
+GroupCommit::GroupCommit(int intervalMillis, size_t syncSize1)
+	: interval(intervalMillis)
+	, syncSize(syncSize1)
+	, position(0)
+	, durable(0)
+	, failed(0)
+	, failure(0)
+	, sizeReached(false)
+	, requested(0)
+	, syncing(false)
+	, stopping(false)
+	, statistics()
+{
+	thread = ThreadUtility::instance()->createThread(LOG4CXX_STR("FileSync"), &GroupCommit::run, this);
+}
+
+GroupCommit::~GroupCommit()
+{
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		stopping = true;
+		due.notify_all();
+		done.notify_all();
+	}
+
+	if (thread.joinable())
+	{
+		thread.join();
+	}
+
+	if (0 < statistics.syncCount)
+	{
+		Pool p;
+		LogString msg(LOG4CXX_STR("File synchronized "));
+		StringHelper::toString((int64_t) statistics.syncCount, p, msg);
+		msg += LOG4CXX_STR(" times for ");
+		StringHelper::toString((int64_t) statistics.waitCount, p, msg);
+		msg += LOG4CXX_STR(" waiting events, average ");
+		StringHelper::toString((int64_t) (statistics.totalMicroseconds / statistics.syncCount), p, msg);
+		msg += LOG4CXX_STR(" us, maximum ");
+		StringHelper::toString((int64_t) statistics.maxMicroseconds, p, msg);
+		msg += LOG4CXX_STR(" us");
+		LogLog::debug(msg);
+	}
+}
+
+void GroupCommit::setPolicy(int intervalMillis, size_t syncSize1)
+{
+	std::lock_guard<std::mutex> lock(mutex);
+	interval = std::chrono::milliseconds(intervalMillis);
+	syncSize = syncSize1;
+	due.notify_one();
+}
+
+void GroupCommit::attach(const SyncFunction& sync1)
+{
+	std::lock_guard<std::mutex> lock(mutex);
+	syncFunction = sync1;
+}
+
+void GroupCommit::detach()
+{
+	std::unique_lock<std::mutex> lock(mutex);
+	done.wait(lock, [this] { return !syncing; });
+	sync(lock);
+	syncFunction = SyncFunction();
+	durable = position.load();
+	done.notify_all();
+}
+
+void GroupCommit::written(size_t byteCount)
+{
+	uint64_t total = position += byteCount;
+	uint64_t limit = syncSize;
+
+	if (0 < limit && limit <= total - durable && !sizeReached.exchange(true))
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		due.notify_one();
+	}
+}
+
+uint64_t GroupCommit::getPosition() const
+{
+	return position;
+}
+
+log4cxx_status_t GroupCommit::waitDurable(uint64_t target)
+{
+	if (target <= durable && failed < target)
+	{
+		return 0;
+	}
+
+	std::unique_lock<std::mutex> lock(mutex);
+
+	if (target <= failed)
+	{
+		return failure;
+	}
+
+	if (target <= durable || stopping)
+	{
+		return 0;
+	}
+
+	++statistics.waitCount;
+
+	if (requested < target)
+	{
+		requested = target;
+		due.notify_one();
+	}
+
+	done.wait(lock, [this, target] { return target <= durable || target <= failed || stopping; });
+	return target <= failed ? failure : 0;
+}
+
+FileAppender::SyncStatistics GroupCommit::getStatistics() const
+{
+	std::lock_guard<std::mutex> lock(mutex);
+	return statistics;
+}
+
+void GroupCommit::run()
+{
+	std::unique_lock<std::mutex> lock(mutex);
+
+	while (!stopping)
+	{
+		if (syncing || (requested <= std::max(durable.load(), failed.load()) && !sizeReached))
+		{
+			if (0 < interval.count())
+			{
+				due.wait_for(lock, interval);
+			}
+			else
+			{
+				due.wait(lock);
+			}
+		}
+
+		if (!stopping && !syncing)
+		{
+			sync(lock);
+		}
+	}
+}
+
+/**
+ * Synchronize the bytes written so far. The mutex is unlocked during the sync
+ * so events can be written and more threads can start waiting.
+ */
+void GroupCommit::sync(std::unique_lock<std::mutex>& lock)
+{
+	uint64_t target = position;
+	sizeReached = false;
+
+	if (target <= durable)
+	{
+		return;
+	}
+
+	if (!syncFunction)
+	{
+		durable = target;
+		done.notify_all();
+		return;
+	}
+
+	SyncFunction syncNow = syncFunction;
+	syncing = true;
+	lock.unlock();
+	auto start = std::chrono::steady_clock::now();
+	log4cxx_status_t stat = syncNow();
+	auto elapsed = std::chrono::steady_clock::now() - start;
+	lock.lock();
+	syncing = false;
+
+	uint64_t micros = (uint64_t) std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count();
+	++statistics.syncCount;
+	statistics.totalMicroseconds += micros;
+
+	if (statistics.maxMicroseconds < micros)
+	{
+		statistics.maxMicroseconds = micros;
+	}
+
+	if (stat != 0)
+	{
+		if (failed < target)
+		{
+			failed = target;
+		}
+
+		failure = stat;
+	}
+	else if (durable < target)
+	{
+		durable = target;
+	}
+
+	done.notify_all();
+	due.notify_one();
+
+	if (stat != 0)
+	{
+		LogLog::error(LOG4CXX_STR("Unable to synchronize log file"), IOException(stat));
+	}
+}
+
+GroupCommitOutputStream::GroupCommitOutputStream
+	( const OutputStreamPtr& os1
+	, const std::shared_ptr<GroupCommit>& commit1
+	, const GroupCommit::SyncFunction& sync
+	)
+	: os(os1)
+	, commit(commit1)
+	, attached(true)
+{
+	commit->attach(sync);
+}
+
+GroupCommitOutputStream::~GroupCommitOutputStream()
+{
+	if (attached)
+	{
+		commit->detach();
+	}
+}
+
+void GroupCommitOutputStream::close(Pool& p)
+{
+	if (attached)
+	{
+		attached = false;
+		os->flush(p);
+		commit->detach();
+	}
+
+	os->close(p);
+}
+
+void GroupCommitOutputStream::flush(Pool& p)
+{
+	os->flush(p);
+}
+
+void GroupCommitOutputStream::write(ByteBuffer& buf, Pool& p)
+{
+	size_t byteCount = buf.remaining();
+	os->write(buf, p);
+	commit->written(byteCount);
+}
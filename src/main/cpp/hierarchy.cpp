@@ -195,6 +195,19 @@ void Hierarchy::setThresholdInternal(const LevelPtr& l)
 	{
 		m_priv->configured = true;
 	}
+	// The hierarchy threshold is part of each logger's cached threshold
+	for (auto& item : m_priv->loggers)
+	{
+		if (item.second)
+		{
+			item.second->updateThreshold();
+		}
+	}
+
+	if (m_priv->root)
+	{
+		m_priv->root->updateThreshold();
+	}
 }
 
 void Hierarchy::fireAddAppenderEvent(const Logger* logger, const Appender* appender)
@@ -325,20 +338,29 @@ void Hierarchy::resetConfiguration()
 
 	if (m_priv->root)
 	{
-		m_priv->root->setLevel(Level::getDebug());
+		m_priv->root->setLevelInternal(Level::getDebug());
 		m_priv->root->setResourceBundle(0);
 	}
+
+	LoggerMap::const_iterator it, itEnd = m_priv->loggers.end();
+
+	for (it = m_priv->loggers.begin(); it != itEnd; it++)
+	{
+		if (auto pLogger = it->second)
+		{
+			pLogger->setLevelInternal(0);
+		}
+	}
+
+	// Also refreshes the threshold of every logger
 	setThresholdInternal(Level::getAll());
 
 	shutdownInternal();
 
-	LoggerMap::const_iterator it, itEnd = m_priv->loggers.end();
-
 	for (it = m_priv->loggers.begin(); it != itEnd; it++)
 	{
 		if (auto pLogger = it->second)
 		{
-			pLogger->setLevel(0);
 			pLogger->setAdditivity(true);
 			pLogger->setResourceBundle(0);
 		}
@@ -448,11 +470,19 @@ void Hierarchy::updateChildren(ProvisionNode& pn, const LoggerPtr& logger)
 
 void Hierarchy::updateChildren(const Logger* parent)
 {
+	// Serialized with setThreshold so a logger cannot keep a threshold based on an old value
+	std::unique_lock<std::mutex> lock(m_priv->mutex);
+
+	if (m_priv->root.get() == parent)
+	{
+		m_priv->root->updateThreshold();
+	}
+
 	for (auto& item : m_priv->loggers)
 	{
 		for (auto l = item.second; l; l = l->getParent())
 		{
-			if (l->getParent().get() == parent)
+			if (l.get() == parent)
 			{
 				item.second->updateThreshold();
 				break;
@@ -0,0 +1,795 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <log4cxx/logstring.h>
+#include <log4cxx/helpers/iouringfileoutputstream.h>
+#include <log4cxx/helpers/exception.h>
+#include <log4cxx/helpers/bytebuffer.h>
+#include <log4cxx/private/log4cxx_private.h>
+#include <apr_file_io.h>
+#include <apr_portable.h>
+#if !defined(LOG4CXX)
+	#define LOG4CXX 1
+#endif
+#include <log4cxx/helpers/aprinitializer.h>
+#include <algorithm>
+#include <cstring>
+#include <vector>
+#include <errno.h>
+#if LOG4CXX_HAS_IO_URING
+	#include <linux/io_uring.h>
+	#include <sys/mman.h>
+	#include <sys/stat.h>
+	#include <sys/syscall.h>
+	#include <sys/uio.h>
+	#include <unistd.h>
+#endif
+
+using namespace log4cxx;
+using namespace log4cxx::helpers;
+
+#if LOG4CXX_HAS_IO_URING
+namespace
+{
+int io_uring_setup(unsigned entries, struct io_uring_params* params)
+{
+	return (int) syscall(__NR_io_uring_setup, entries, params);
+}
+
+int io_uring_enter(int ringFd, unsigned toSubmit, unsigned minComplete, unsigned flags)
+{
+	return (int) syscall(__NR_io_uring_enter, ringFd, toSubmit, minComplete, flags, nullptr, 0);
+}
+
+int io_uring_register(int ringFd, unsigned opcode, const void* arg, unsigned argCount)
+{
+	return (int) syscall(__NR_io_uring_register, ringFd, opcode, arg, argCount);
+}
+
+/**
+ * The shared submission and completion queues of an io_uring instance.
+ */
+class Ring
+{
+	public:
+		Ring() {}
+
+		~Ring()
+		{
+			release();
+		}
+
+		/**
+		 * Create an io_uring instance with \c entries submission queue entries.
+		 * @return zero or an error number.
+		 */
+		int setup(unsigned entries)
+		{
+			struct io_uring_params params;
+			std::memset(&params, 0, sizeof (params));
+			fd = io_uring_setup(entries, &params);
+
+			if (fd < 0)
+			{
+				return errno;
+			}
+
+			sqRingSize = params.sq_off.array + params.sq_entries * sizeof (unsigned);
+			cqRingSize = params.cq_off.cqes + params.cq_entries * sizeof (struct io_uring_cqe);
+
+			if (params.features & IORING_FEAT_SINGLE_MMAP)
+			{
+				sqRingSize = cqRingSize = std::max(sqRingSize, cqRingSize);
+			}
+
+			sqRing = mmap(nullptr, sqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQ_RING);
+
+			if (sqRing == MAP_FAILED)
+			{
+				return errno;
+			}
+
+			if (params.features & IORING_FEAT_SINGLE_MMAP)
+			{
+				cqRing = sqRing;
+			}
+			else
+			{
+				cqRing = mmap(nullptr, cqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_CQ_RING);
+
+				if (cqRing == MAP_FAILED)
+				{
+					return errno;
+				}
+			}
+
+			sqesSize = params.sq_entries * sizeof (struct io_uring_sqe);
+			void* sqesAddress = mmap(nullptr, sqesSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQES);
+
+			if (sqesAddress == MAP_FAILED)
+			{
+				return errno;
+			}
+
+			sqes = static_cast<struct io_uring_sqe*>(sqesAddress);
+			char* sq = static_cast<char*>(sqRing);
+			sqHead = reinterpret_cast<unsigned*>(sq + params.sq_off.head);
+			sqEntries = reinterpret_cast<unsigned*>(sq + params.sq_off.ring_entries);
+			sqTail = reinterpret_cast<unsigned*>(sq + params.sq_off.tail);
+			sqMask = reinterpret_cast<unsigned*>(sq + params.sq_off.ring_mask);
+			sqArray = reinterpret_cast<unsigned*>(sq + params.sq_off.array);
+			char* cq = static_cast<char*>(cqRing);
+			cqHead = reinterpret_cast<unsigned*>(cq + params.cq_off.head);
+			cqTail = reinterpret_cast<unsigned*>(cq + params.cq_off.tail);
+			cqMask = reinterpret_cast<unsigned*>(cq + params.cq_off.ring_mask);
+			cqes = reinterpret_cast<struct io_uring_cqe*>(cq + params.cq_off.cqes);
+			return 0;
+		}
+
+		void release()
+		{
+			if (sqes)
+			{
+				munmap(sqes, sqesSize);
+				sqes = nullptr;
+			}
+
+			if (cqRing != MAP_FAILED && cqRing != sqRing)
+			{
+				munmap(cqRing, cqRingSize);
+			}
+
+			cqRing = MAP_FAILED;
+
+			if (sqRing != MAP_FAILED)
+			{
+				munmap(sqRing, sqRingSize);
+				sqRing = MAP_FAILED;
+			}
+
+			if (0 <= fd)
+			{
+				::close(fd);
+				fd = -1;
+			}
+		}
+
+		/**
+		 * Is there room for another submission queue entry?
+		 * The submission queue fills only when the kernel does not take the submitted entries.
+		 */
+		bool hasFreeEntry() const
+		{
+			return *sqTail - __atomic_load_n(sqHead, __ATOMIC_ACQUIRE) < *sqEntries;
+		}
+
+		/**
+		 * The next submission queue entry, cleared.
+		 * The submission queue is never full because entries are submitted immediately.
+		 */
+		struct io_uring_sqe* nextEntry()
+		{
+			unsigned index = *sqTail & *sqMask;
+			struct io_uring_sqe* sqe = &sqes[index];
+			std::memset(sqe, 0, sizeof (*sqe));
+			sqArray[index] = index;
+			return sqe;
+		}
+
+		/**
+		 * Pass the entry obtained from #nextEntry to the kernel.
+		 * @return zero or an error number.
+		 */
+		int submit()
+		{
+			__atomic_store_n(sqTail, *sqTail + 1, __ATOMIC_RELEASE);
+			++unsubmitted;
+			return enter(0, 0);
+		}
+
+		/**
+		 * Wait until at least one completion is available.
+		 * @return zero or an error number.
+		 */
+		int wait()
+		{
+			return enter(1, IORING_ENTER_GETEVENTS);
+		}
+
+		/**
+		 * Pass each available completion to \c handler.
+		 * @return the number of completions.
+		 */
+		template <class Handler>
+		int reap(Handler handler)
+		{
+			unsigned head = *cqHead;
+			unsigned tail = __atomic_load_n(cqTail, __ATOMIC_ACQUIRE);
+			int count = 0;
+
+			for (; head != tail; ++head, ++count)
+			{
+				const struct io_uring_cqe& cqe = cqes[head & *cqMask];
+				handler(cqe.user_data, cqe.res);
+			}
+
+			__atomic_store_n(cqHead, head, __ATOMIC_RELEASE);
+			return count;
+		}
+
+		int fd = -1;
+
+	private:
+		/**
+		 * Submit entries not yet consumed by the kernel.
+		 * Entries are left in the queue when the kernel is temporarily short of resources.
+		 */
+		int enter(unsigned minComplete, unsigned flags)
+		{
+			for (;;)
+			{
+				int result = io_uring_enter(fd, unsubmitted, minComplete, flags);
+
+				if (0 <= result)
+				{
+					unsubmitted -= (unsigned) result;
+					return 0;
+				}
+
+				if ((errno == EAGAIN || errno == EBUSY) && minComplete == 0)
+				{
+					return 0;
+				}
+
+				if (errno != EINTR)
+				{
+					return errno;
+				}
+			}
+		}
+
+		unsigned unsubmitted = 0;
+		void* sqRing = MAP_FAILED;
+		size_t sqRingSize = 0;
+		void* cqRing = MAP_FAILED;
+		size_t cqRingSize = 0;
+		struct io_uring_sqe* sqes = nullptr;
+		size_t sqesSize = 0;
+		unsigned* sqHead = nullptr;
+		unsigned* sqEntries = nullptr;
+		unsigned* sqTail = nullptr;
+		unsigned* sqMask = nullptr;
+		unsigned* sqArray = nullptr;
+		unsigned* cqHead = nullptr;
+		unsigned* cqTail = nullptr;
+		unsigned* cqMask = nullptr;
+		struct io_uring_cqe* cqes = nullptr;
+
+		Ring(const Ring&) = delete;
+		Ring& operator=(const Ring&) = delete;
+};
+
+bool probe()
+{
+	Ring ring;
+	return ring.setup(1) == 0;
+}
+}
+#endif
+
+struct IOUringFileOutputStream::IOUringFileOutputStreamPrivate
+{
+	Pool pool;
+	apr_file_t* fileptr = nullptr;
+	int error = 0;
+#if LOG4CXX_HAS_IO_URING
+	enum class State { Free, Filled, Busy };
+
+	/**
+	 * Marks the user data of a cancellation request (the rest is the buffer index).
+	 */
+	static constexpr uint64_t CancelTag = uint64_t(1) << 63;
+
+	struct Buffer
+	{
+		std::vector<char> data;
+		size_t used = 0;
+		State state = State::Free;
+		uint64_t offset = 0;
+		struct iovec iov;
+	};
+
+	int fd = -1;
+
+	/**
+	 * Are writes made at offsets held by this stream (and so in parallel)?
+	 * Otherwise the file is opened for appending.
+	 */
+	bool seekable = false;
+
+	/**
+	 * Were the buffers registered with the kernel?
+	 */
+	bool registered = false;
+
+	/**
+	 * Are buffers written without io_uring (after it failed)?
+	 */
+	bool synchronous = false;
+
+	/**
+	 * The file offset at which the next buffer is written.
+	 */
+	uint64_t offset = 0;
+
+	/**
+	 * Buffers are filled, submitted and written in round robin order.
+	 */
+	std::vector<Buffer> buffers;
+	size_t fill = 0;
+	size_t nextSubmit = 0;
+	int inFlight = 0;
+
+	/**
+	 * Declared after the buffers, so the kernel stops using them before they are released.
+	 */
+	Ring ring;
+
+	void open(const LogString& filename, bool append, int queueDepth)
+	{
+		queueDepth = std::max(1, queueDepth);
+		apr_int32_t flags = APR_WRITE | APR_CREATE;
+
+		if (!append)
+		{
+			flags |= APR_TRUNCATE;
+		}
+
+		// Bytes added to an existing file go to its end, wherever that is at the time.
+		// Only a file this stream truncated is written at offsets it holds.
+		if (append || queueDepth == 1)
+		{
+			flags |= APR_APPEND;
+		}
+
+		File fn;
+		fn.setPath(filename);
+		apr_status_t stat = fn.open(&fileptr, flags, APR_OS_DEFAULT, pool);
+
+		if (stat != APR_SUCCESS)
+		{
+			throw IOException(stat);
+		}
+
+		apr_os_file_t osFile;
+		stat = apr_os_file_get(&osFile, fileptr);
+
+		if (stat != APR_SUCCESS)
+		{
+			throw IOException(stat);
+		}
+
+		fd = osFile;
+		struct stat info;
+
+		if (fstat(fd, &info) != 0)
+		{
+			throw IOException(errno);
+		}
+
+		seekable = S_ISREG(info.st_mode) && !(flags & APR_APPEND);
+		offset = 0;
+
+		int err = ring.setup((unsigned) queueDepth);
+
+		if (err != 0)
+		{
+			ring.release();
+			throw IOException(err);
+		}
+
+		buffers.resize(queueDepth);
+		std::vector<struct iovec> iovs;
+
+		for (auto& buffer : buffers)
+		{
+			buffer.data.resize(BufferSize);
+			buffer.iov.iov_base = buffer.data.data();
+			buffer.iov.iov_len = BufferSize;
+			iovs.push_back(buffer.iov);
+		}
+
+		// Registration fails if the locked memory limit is too low
+		registered = io_uring_register(ring.fd, IORING_REGISTER_BUFFERS, iovs.data(), (unsigned) iovs.size()) == 0;
+	}
+
+	/**
+	 * Copy \c count bytes at \c data into the buffers,
+	 * waiting for a write to complete if all buffers are in use.
+	 */
+	void write(const char* data, size_t count)
+	{
+		while (0 < count)
+		{
+			waitForFreeBuffer();
+			Buffer& buffer = buffers[fill];
+			size_t n = std::min(count, buffer.data.size() - buffer.used);
+			std::memcpy(buffer.data.data() + buffer.used, data, n);
+			buffer.used += n;
+			data += n;
+			count -= n;
+
+			if (buffer.used == buffer.data.size())
+			{
+				endFill();
+			}
+		}
+
+		if (inFlight == 0 && 0 < buffers[fill].used)
+		{
+			endFill();
+		}
+
+		submitFilled();
+	}
+
+	/**
+	 * Wait until all bytes are written.
+	 */
+	void flush()
+	{
+		if (0 < buffers[fill].used)
+		{
+			endFill();
+		}
+
+		for (;;)
+		{
+			submitFilled();
+
+			if (inFlight == 0)
+			{
+				break;
+			}
+
+			waitForCompletion();
+		}
+	}
+
+	void endFill()
+	{
+		buffers[fill].state = State::Filled;
+		fill = (fill + 1) % buffers.size();
+	}
+
+	void waitForFreeBuffer()
+	{
+		for (;;)
+		{
+			submitFilled();
+
+			if (buffers[fill].state == State::Free)
+			{
+				break;
+			}
+
+			waitForCompletion();
+		}
+	}
+
+	/**
+	 * Submit filled buffers in order,
+	 * but only one at a time if the file is not seekable.
+	 */
+	void submitFilled()
+	{
+		while (buffers[nextSubmit].state == State::Filled && (seekable || inFlight == 0))
+		{
+			submit(nextSubmit);
+			nextSubmit = (nextSubmit + 1) % buffers.size();
+		}
+	}
+
+	void submit(size_t index)
+	{
+		Buffer& buffer = buffers[index];
+		buffer.offset = offset;
+		buffer.state = State::Busy;
+		offset += buffer.used;
+		++inFlight;
+
+		if (synchronous)
+		{
+			complete(index, 0);
+			return;
+		}
+
+		struct io_uring_sqe* sqe = ring.nextEntry();
+		sqe->fd = fd;
+		sqe->off = seekable ? buffer.offset : (uint64_t) -1;
+		sqe->user_data = index;
+
+		if (registered)
+		{
+			sqe->opcode = IORING_OP_WRITE_FIXED;
+			sqe->addr = (uint64_t) (uintptr_t) buffer.data.data();
+			sqe->len = (uint32_t) buffer.used;
+			sqe->buf_index = (uint16_t) index;
+		}
+		else
+		{
+			buffer.iov.iov_len = buffer.used;
+			sqe->opcode = IORING_OP_WRITEV;
+			sqe->addr = (uint64_t) (uintptr_t) &buffer.iov;
+			sqe->len = 1;
+		}
+
+		if (int err = ring.submit())
+		{
+			stopUsingRing(err);
+		}
+	}
+
+	void waitForCompletion()
+	{
+		if (int err = ring.wait())
+		{
+			stopUsingRing(err);
+			return;
+		}
+
+		reapCompletions();
+	}
+
+	void reapCompletions()
+	{
+		ring.reap([this](uint64_t userData, int result)
+		{
+			if (userData & CancelTag)
+			{
+				return;
+			}
+
+			// A cancelled write wrote nothing
+			complete((size_t) userData, result == -ECANCELED ? 0 : result);
+		});
+	}
+
+	/**
+	 * Write the buffers synchronously from now on.
+	 * Writes in progress are cancelled. If that is not possible,
+	 * the ring is closed (ending the use of the buffers by the kernel)
+	 * and those writes are reported as lost rather than made a second time.
+	 */
+	void stopUsingRing(int err)
+	{
+		if (error == 0)
+		{
+			error = err;
+		}
+
+		synchronous = true;
+
+		if (cancelInFlight())
+		{
+			return;
+		}
+
+		ring.release();
+
+		for (auto& buffer : buffers)
+		{
+			if (buffer.state == State::Busy)
+			{
+				buffer.used = 0;
+				buffer.state = State::Free;
+				--inFlight;
+			}
+		}
+	}
+
+	/**
+	 * Ask the kernel to cancel each write in progress and wait for all of them to complete.
+	 * @return false if the ring could not be used.
+	 */
+	bool cancelInFlight()
+	{
+		for (size_t index = 0; index < buffers.size(); ++index)
+		{
+			if (buffers[index].state != State::Busy)
+			{
+				continue;
+			}
+
+			if (!ring.hasFreeEntry())
+			{
+				return false;
+			}
+
+			struct io_uring_sqe* sqe = ring.nextEntry();
+			sqe->opcode = IORING_OP_ASYNC_CANCEL;
+			sqe->fd = -1;
+			sqe->addr = index;
+			sqe->user_data = CancelTag | index;
+
+			if (ring.submit() != 0)
+			{
+				return false;
+			}
+		}
+
+		while (0 < inFlight)
+		{
+			if (ring.wait() != 0)
+			{
+				return false;
+			}
+
+			reapCompletions();
+		}
+
+		return true;
+	}
+
+	/**
+	 * Release the buffer at \c index, writing any part the kernel did not.
+	 */
+	void complete(size_t index, int result)
+	{
+		Buffer& buffer = buffers[index];
+
+		if (result < 0)
+		{
+			if (error == 0)
+			{
+				error = -result;
+			}
+		}
+		else
+		{
+			size_t written = (size_t) result;
+
+			while (written < buffer.used)
+			{
+				ssize_t n = seekable
+					? pwrite(fd, buffer.data.data() + written, buffer.used - written, (off_t) (buffer.offset + written))
+					: ::write(fd, buffer.data.data() + written, buffer.used - written);
+
+				if (n < 0 && errno == EINTR)
+				{
+					continue;
+				}
+
+				if (n <= 0)
+				{
+					if (error == 0)
+					{
+						error = n < 0 ? errno : EIO;
+					}
+
+					break;
+				}
+
+				written += (size_t) n;
+			}
+		}
+
+		buffer.used = 0;
+		buffer.state = State::Free;
+		--inFlight;
+	}
+#endif
+
+	/**
+	 * Throw an exception for the first error since the last call.
+	 */
+	void checkError()
+	{
+		if (error != 0)
+		{
+			int err = error;
+			error = 0;
+			throw IOException(err);
+		}
+	}
+
+	apr_status_t close()
+	{
+#if LOG4CXX_HAS_IO_URING
+		flush();
+		ring.release();
+#endif
+		apr_status_t stat = apr_file_close(fileptr);
+		fileptr = nullptr;
+		return stat;
+	}
+};
+
+IMPLEMENT_LOG4CXX_OBJECT(IOUringFileOutputStream)
+
+IOUringFileOutputStream::IOUringFileOutputStream(const LogString& filename,
+	bool append, int queueDepth)
+	: m_priv(std::make_unique<IOUringFileOutputStreamPrivate>())
+{
+#if LOG4CXX_HAS_IO_URING
+	m_priv->open(filename, append, queueDepth);
+#else
+	throw IOException(LOG4CXX_STR("io_uring is not supported on this platform"));
+#endif
+}
+
+IOUringFileOutputStream::~IOUringFileOutputStream()
+{
+	if (m_priv->fileptr != NULL && !APRInitializer::isDestructed)
+	{
+		m_priv->close();
+	}
+}
+
+bool IOUringFileOutputStream::isSupported()
+{
+#if LOG4CXX_HAS_IO_URING
+	static const bool supported = probe();
+	return supported;
+#else
+	return false;
+#endif
+}
+
+void IOUringFileOutputStream::close(Pool& /* p */)
+{
+	if (m_priv->fileptr != NULL)
+	{
+		apr_status_t stat = m_priv->close();
+		m_priv->checkError();
+
+		if (stat != APR_SUCCESS)
+		{
+			throw IOException(stat);
+		}
+	}
+}
+
+void IOUringFileOutputStream::flush(Pool& /* p */)
+{
+	if (m_priv->fileptr != NULL)
+	{
+#if LOG4CXX_HAS_IO_URING
+		m_priv->flush();
+#endif
+		m_priv->checkError();
+	}
+}
+
+void IOUringFileOutputStream::write(ByteBuffer& buf, Pool& /* p */ )
+{
+	if (m_priv->fileptr == NULL)
+	{
+		throw IOException(-1);
+	}
+
+#if LOG4CXX_HAS_IO_URING
+	m_priv->write(buf.data() + buf.position(), buf.remaining());
+#endif
+	buf.position(buf.limit());
+	m_priv->checkError();
+}
+
+apr_file_t* IOUringFileOutputStream::getFilePtr() const
+{
+	return m_priv->fileptr;
+}
@@ -23,6 +23,7 @@
 #include <log4cxx/helpers/iso8601dateformat.h>
 #include <log4cxx/helpers/stringhelper.h>
 #include <log4cxx/helpers/transcoder.h>
+#include <log4cxx/private/asciirun.h>
 
 #include <string.h>
 
@@ -41,7 +42,10 @@ struct JSONLayout::JSONLayoutPrivate
 		ppIndentL1(LOG4CXX_STR("  ")),
 		ppIndentL2(LOG4CXX_STR("    ")),
 		expectedPatternLength(100),
-		threadInfo(false) {}
+		threadInfo(false)
+	{
+		buildTemplate();
+	}
 
 	// Print no location info by default
 	bool locationInfo; //= false
@@ -57,6 +61,58 @@ struct JSONLayout::JSONLayoutPrivate
 
 	// Thread info is not included by default
 	bool threadInfo; //= false
+
+	// The constant text between the values of an event, which depends on prettyPrint
+	LogString eventStart;          // '{' and the timestamp key
+	LogString threadKey;           // separator and thread key
+	LogString levelKey;            // separator and level key
+	LogString loggerKey;           // separator and logger key
+	LogString messageKey;          // separator and message key
+	LogString eventEnd;            // '}' and the line separator
+	LogString fieldSeparator;      // ',' and a line separator or space
+	LogString lineEnd;             // a line separator or space
+	LogString indent1;             // empty unless prettyPrint
+	LogString indent2;             // empty unless prettyPrint
+	LogString contextMapStart;     // separator, context_map key and '{'
+	LogString contextMapEnd;       // '}'
+	LogString contextStackStart;   // separator, context_stack key and '['
+	LogString contextStackEnd;     // ']'
+	LogString locationStart;       // location_info key, '{' and file key
+	LogString lineKey;             // separator and line key
+	LogString classKey;            // separator and class key
+	LogString methodKey;           // separator and method key
+	LogString locationEnd;         // '}'
+
+	LogString key(const LogString& indent, const LogString& name) const
+	{
+		LogString result(indent);
+		appendItem(name, result);
+		result.append(LOG4CXX_STR(": "));
+		return result;
+	}
+
+	void buildTemplate()
+	{
+		lineEnd = prettyPrint ? LogString(LOG4CXX_EOL) : LogString(LOG4CXX_STR(" "));
+		indent1 = prettyPrint ? ppIndentL1 : LogString();
+		indent2 = prettyPrint ? ppIndentL2 : LogString();
+		fieldSeparator = LOG4CXX_STR(",") + lineEnd;
+		eventStart = LOG4CXX_STR("{") + lineEnd + key(indent1, LOG4CXX_STR("timestamp"));
+		threadKey = fieldSeparator + key(indent1, LOG4CXX_STR("thread"));
+		levelKey = fieldSeparator + key(indent1, LOG4CXX_STR("level"));
+		loggerKey = fieldSeparator + key(indent1, LOG4CXX_STR("logger"));
+		messageKey = fieldSeparator + key(indent1, LOG4CXX_STR("message"));
+		eventEnd = lineEnd + LOG4CXX_STR("}") + LOG4CXX_EOL;
+		contextMapStart = fieldSeparator + key(indent1, LOG4CXX_STR("context_map")) + LOG4CXX_STR("{") + lineEnd;
+		contextMapEnd = indent1 + LOG4CXX_STR("}");
+		contextStackStart = fieldSeparator + key(indent1, LOG4CXX_STR("context_stack")) + LOG4CXX_STR("[") + lineEnd + indent2;
+		contextStackEnd = lineEnd + indent1 + LOG4CXX_STR("]");
+		locationStart = key(indent1, LOG4CXX_STR("location_info")) + LOG4CXX_STR("{") + lineEnd + key(indent2, LOG4CXX_STR("file"));
+		lineKey = fieldSeparator + key(indent2, LOG4CXX_STR("line"));
+		classKey = fieldSeparator + key(indent2, LOG4CXX_STR("class"));
+		methodKey = fieldSeparator + key(indent2, LOG4CXX_STR("method"));
+		locationEnd = lineEnd + indent1 + LOG4CXX_STR("}");
+	}
 };
 
 JSONLayout::JSONLayout() :
@@ -79,6 +135,7 @@ bool JSONLayout::getLocationInfo() const
 void JSONLayout::setPrettyPrint(bool prettyPrintFlag)
 {
 	m_priv->prettyPrint = prettyPrintFlag;
+	m_priv->buildTemplate();
 }
 
 bool JSONLayout::getPrettyPrint() const
@@ -129,82 +186,37 @@ void JSONLayout::format(LogString& output,
 	const spi::LoggingEventPtr& event,
 	Pool& p) const
 {
-	output.reserve(m_priv->expectedPatternLength + event->getMessage().size());
-	output.append(LOG4CXX_STR("{"));
-	output.append(m_priv->prettyPrint ? LOG4CXX_EOL : LOG4CXX_STR(" "));
-
-	if (m_priv->prettyPrint)
-	{
-		output.append(m_priv->ppIndentL1);
-	}
-
-	appendQuotedEscapedString(output, LOG4CXX_STR("timestamp"));
-	output.append(LOG4CXX_STR(": "));
-	LogString timestamp;
-	m_priv->dateFormat.format(timestamp, event->getTimeStamp(), p);
-	appendQuotedEscapedString(output, timestamp);
-	output.append(LOG4CXX_STR(","));
-	output.append(m_priv->prettyPrint ? LOG4CXX_EOL : LOG4CXX_STR(" "));
+	output.reserve(output.size() + m_priv->expectedPatternLength + event->getMessage().size());
+	output.append(m_priv->eventStart);
+	output.append(1, 0x22);
+	m_priv->dateFormat.format(output, event->getTimeStamp(), p);
+	output.append(1, 0x22);
 
 	if (m_priv->threadInfo)
 	{
-		if (m_priv->prettyPrint)
-		{
-			output.append(m_priv->ppIndentL1);
-		}
-		appendQuotedEscapedString(output, LOG4CXX_STR("thread"));
-		output.append(LOG4CXX_STR(": "));
-		appendQuotedEscapedString(output, event->getThreadName());
-		output.append(LOG4CXX_STR(","));
-		output.append(m_priv->prettyPrint ? LOG4CXX_EOL : LOG4CXX_STR(" "));
-	}
-
-	if (m_priv->prettyPrint)
-	{
-		output.append(m_priv->ppIndentL1);
+		output.append(m_priv->threadKey);
+		appendItem(event->getThreadName(), output);
 	}
 
-	appendQuotedEscapedString(output, LOG4CXX_STR("level"));
-	output.append(LOG4CXX_STR(": "));
+	output.append(m_priv->levelKey);
 	LogString level;
 	event->getLevel()->toString(level);
-	appendQuotedEscapedString(output, level);
-	output.append(LOG4CXX_STR(","));
-	output.append(m_priv->prettyPrint ? LOG4CXX_EOL : LOG4CXX_STR(" "));
-
-	if (m_priv->prettyPrint)
-	{
-		output.append(m_priv->ppIndentL1);
-	}
-
-	appendQuotedEscapedString(output, LOG4CXX_STR("logger"));
-	output.append(LOG4CXX_STR(": "));
-	appendQuotedEscapedString(output, event->getLoggerName());
-	output.append(LOG4CXX_STR(","));
-	output.append(m_priv->prettyPrint ? LOG4CXX_EOL : LOG4CXX_STR(" "));
-
-	if (m_priv->prettyPrint)
-	{
-		output.append(m_priv->ppIndentL1);
-	}
-
-	appendQuotedEscapedString(output, LOG4CXX_STR("message"));
-	output.append(LOG4CXX_STR(": "));
-	appendQuotedEscapedString(output, event->getMessage());
+	appendItem(level, output);
+	output.append(m_priv->loggerKey);
+	appendItem(event->getLoggerName(), output);
+	output.append(m_priv->messageKey);
+	appendItem(event->getMessage(), output);
 
 	appendSerializedMDC(output, event);
 	appendSerializedNDC(output, event);
 
 	if (m_priv->locationInfo)
 	{
-		output.append(LOG4CXX_STR(","));
-		output.append(m_priv->prettyPrint ? LOG4CXX_EOL : LOG4CXX_STR(" "));
+		output.append(m_priv->fieldSeparator);
 		appendSerializedLocationInfo(output, event, p);
 	}
 
-	output.append(m_priv->prettyPrint ? LOG4CXX_EOL : LOG4CXX_STR(" "));
-	output.append(LOG4CXX_STR("}"));
-	output.append(LOG4CXX_EOL);
+	output.append(m_priv->eventEnd);
 }
 
 void JSONLayout::appendQuotedEscapedString(LogString& buf,
@@ -218,92 +230,58 @@ void JSONLayout::appendItem(const LogString& input, LogString& buf)
 	/* add leading quote */
 	buf.push_back(0x22);
 
-	logchar specialChars[] =
-	{
-		0x08,   /* \b backspace         */
-		0x09,   /* \t tab               */
-		0x0a,   /* \n newline           */
-		0x0c,   /* \f form feed         */
-		0x0d,   /* \r carriage return   */
-		0x22,   /* \" double quote      */
-		0x5c,   /* \\ backslash         */
-		0x00    /* terminating NULL for C-strings */
-	};
-
+	const logchar* text = input.data();
+	size_t length = input.size();
 	size_t start = 0;
-	size_t found = input.find_first_of(specialChars, start);
 
-	while (found != LogString::npos)
+	while (start < length)
 	{
-		if (found > start)
+		/* copy characters needing no escape in bulk */
+		size_t count = AsciiRun::unescapedLength(text + start, length - start);
+		buf.append(text + start, count);
+		start += count;
+
+		if (length <= start)
 		{
-			buf.append(input, start, found - start);
+			break;
 		}
 
-		switch (input[found])
+		buf.push_back(0x5c);
+
+		switch (text[start])
 		{
 			case 0x08:
 				/* \b backspace */
-				buf.push_back(0x5c);
 				buf.push_back('b');
 				break;
 
 			case 0x09:
 				/* \t tab */
-				buf.push_back(0x5c);
 				buf.push_back('t');
 				break;
 
 			case 0x0a:
 				/* \n newline */
-				buf.push_back(0x5c);
 				buf.push_back('n');
 				break;
 
 			case 0x0c:
 				/* \f form feed */
-				buf.push_back(0x5c);
 				buf.push_back('f');
 				break;
 
 			case 0x0d:
 				/* \r carriage return */
-				buf.push_back(0x5c);
 				buf.push_back('r');
 				break;
 
-			case 0x22:
-				/* \" double quote */
-				buf.push_back(0x5c);
-				buf.push_back(0x22);
-				break;
-
-			case 0x5c:
-				/* \\ backslash */
-				buf.push_back(0x5c);
-				buf.push_back(0x5c);
-				break;
-
 			default:
-				buf.push_back(input[found]);
+				/* \" double quote or \\ backslash */
+				buf.push_back(text[start]);
 				break;
 		}
 
-		start = found + 1;
-
-		if (found < input.size())
-		{
-			found = input.find_first_of(specialChars, start);
-		}
-		else
-		{
-			found = LogString::npos;
-		}
-	}
-
-	if (start < input.size())
-	{
-		buf.append(input, start, input.size() - start);
+		++start;
 	}
 
 	/* add trailing quote */
@@ -320,50 +298,30 @@ void JSONLayout::appendSerializedMDC(LogString& buf,
 		return;
 	}
 
-	buf.append(LOG4CXX_STR(","));
-	buf.append(m_priv->prettyPrint ? LOG4CXX_EOL : LOG4CXX_STR(" "));
-
-	if (m_priv->prettyPrint)
-	{
-		buf.append(m_priv->ppIndentL1);
-	}
-
-	appendQuotedEscapedString(buf, LOG4CXX_STR("context_map"));
-	buf.append(LOG4CXX_STR(": {"));
-	buf.append(m_priv->prettyPrint ? LOG4CXX_EOL : LOG4CXX_STR(" "));
+	buf.append(m_priv->contextMapStart);
 
 	for (LoggingEvent::KeySet::iterator it = keys.begin();
 		it != keys.end(); ++it)
 	{
-		if (m_priv->prettyPrint)
-		{
-			buf.append(m_priv->ppIndentL2);
-		}
-
-		appendQuotedEscapedString(buf, *it);
+		buf.append(m_priv->indent2);
+		appendItem(*it, buf);
 		buf.append(LOG4CXX_STR(": "));
 		LogString value;
 		event->getMDC(*it, value);
-		appendQuotedEscapedString(buf, value);
+		appendItem(value, buf);
 
 		/* if this isn't the last k:v pair, we need a comma */
 		if (it + 1 != keys.end())
 		{
-			buf.append(LOG4CXX_STR(","));
-			buf.append(m_priv->prettyPrint ? LOG4CXX_EOL : LOG4CXX_STR(" "));
+			buf.append(m_priv->fieldSeparator);
 		}
 		else
 		{
-			buf.append(m_priv->prettyPrint ? LOG4CXX_EOL : LOG4CXX_STR(" "));
+			buf.append(m_priv->lineEnd);
 		}
 	}
 
-	if (m_priv->prettyPrint)
-	{
-		buf.append(m_priv->ppIndentL1);
-	}
-
-	buf.append(LOG4CXX_STR("}"));
+	buf.append(m_priv->contextMapEnd);
 }
 
 void JSONLayout::appendSerializedNDC(LogString& buf,
@@ -376,100 +334,27 @@ void JSONLayout::appendSerializedNDC(LogString& buf,
 		return;
 	}
 
-	buf.append(LOG4CXX_STR(","));
-	buf.append(m_priv->prettyPrint ? LOG4CXX_EOL : LOG4CXX_STR(" "));
-
-	if (m_priv->prettyPrint)
-	{
-		buf.append(m_priv->ppIndentL1);
-	}
-
-	appendQuotedEscapedString(buf, LOG4CXX_STR("context_stack"));
-	buf.append(LOG4CXX_STR(": ["));
-	buf.append(m_priv->prettyPrint ? LOG4CXX_EOL : LOG4CXX_STR(" "));
-
-	if (m_priv->prettyPrint)
-	{
-		buf.append(m_priv->ppIndentL2);
-	}
-
-	appendQuotedEscapedString(buf, ndcVal);
-	buf.append(m_priv->prettyPrint ? LOG4CXX_EOL : LOG4CXX_STR(" "));
-
-	if (m_priv->prettyPrint)
-	{
-		buf.append(m_priv->ppIndentL1);
-	}
-
-	buf.append(LOG4CXX_STR("]"));
+	buf.append(m_priv->contextStackStart);
+	appendItem(ndcVal, buf);
+	buf.append(m_priv->contextStackEnd);
 }
 
 void JSONLayout::appendSerializedLocationInfo(LogString& buf,
 	const LoggingEventPtr& event, Pool& p) const
 {
-	if (m_priv->prettyPrint)
-	{
-		buf.append(m_priv->ppIndentL1);
-	}
-
-	appendQuotedEscapedString(buf, LOG4CXX_STR("location_info"));
-	buf.append(LOG4CXX_STR(": {"));
-	buf.append(m_priv->prettyPrint ? LOG4CXX_EOL : LOG4CXX_STR(" "));
 	const LocationInfo& locInfo = event->getLocationInformation();
-
-	if (m_priv->prettyPrint)
-	{
-		buf.append(m_priv->ppIndentL2);
-	}
-
-	appendQuotedEscapedString(buf, LOG4CXX_STR("file"));
-	buf.append(LOG4CXX_STR(": "));
+	buf.append(m_priv->locationStart);
 	LOG4CXX_DECODE_CHAR(fileName, locInfo.getFileName());
-	appendQuotedEscapedString(buf, fileName);
-	buf.append(LOG4CXX_STR(","));
-	buf.append(m_priv->prettyPrint ? LOG4CXX_EOL : LOG4CXX_STR(" "));
-
-	if (m_priv->prettyPrint)
-	{
-		buf.append(m_priv->ppIndentL2);
-	}
-
-	appendQuotedEscapedString(buf, LOG4CXX_STR("line"));
-	buf.append(LOG4CXX_STR(": "));
+	appendItem(fileName, buf);
+	buf.append(m_priv->lineKey);
 	LogString lineNumber;
 	StringHelper::toString(locInfo.getLineNumber(), p, lineNumber);
-	appendQuotedEscapedString(buf, lineNumber);
-	buf.append(LOG4CXX_STR(","));
-	buf.append(m_priv->prettyPrint ? LOG4CXX_EOL : LOG4CXX_STR(" "));
-
-	if (m_priv->prettyPrint)
-	{
-		buf.append(m_priv->ppIndentL2);
-	}
-
-	appendQuotedEscapedString(buf, LOG4CXX_STR("class"));
-	buf.append(LOG4CXX_STR(": "));
+	appendItem(lineNumber, buf);
+	buf.append(m_priv->classKey);
 	LOG4CXX_DECODE_CHAR(className, locInfo.getClassName());
-	appendQuotedEscapedString(buf, className);
-	buf.append(LOG4CXX_STR(","));
-	buf.append(m_priv->prettyPrint ? LOG4CXX_EOL : LOG4CXX_STR(" "));
-
-	if (m_priv->prettyPrint)
-	{
-		buf.append(m_priv->ppIndentL2);
-	}
-
-	appendQuotedEscapedString(buf, LOG4CXX_STR("method"));
-	buf.append(LOG4CXX_STR(": "));
+	appendItem(className, buf);
+	buf.append(m_priv->methodKey);
 	LOG4CXX_DECODE_CHAR(methodName, locInfo.getMethodName());
-	appendQuotedEscapedString(buf, methodName);
-	buf.append(m_priv->prettyPrint ? LOG4CXX_EOL : LOG4CXX_STR(" "));
-
-	if (m_priv->prettyPrint)
-	{
-		buf.append(m_priv->ppIndentL1);
-	}
-
-	buf.append(LOG4CXX_STR("}"));
+	appendItem(methodName, buf);
+	buf.append(m_priv->locationEnd);
 }
-
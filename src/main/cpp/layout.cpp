@@ -16,6 +16,7 @@
  */
 #include <log4cxx/logstring.h>
 #include <log4cxx/layout.h>
+#include <log4cxx/helpers/transcoder.h>
 
 using namespace log4cxx;
 using namespace log4cxx::helpers;
@@ -34,6 +35,38 @@ void Layout::appendHeader(LogString&, log4cxx::helpers::Pool&) {}
 
 void Layout::appendFooter(LogString&, log4cxx::helpers::Pool&) {}
 
+void Layout::formatUTF8(std::string& output, const spi::LoggingEventPtr& event, Pool& pool) const
+{
+#if LOG4CXX_LOGCHAR_IS_UTF8
+	format(output, event, pool);
+#else
+	LogString text;
+	format(text, event, pool);
+	Transcoder::encodeUTF8(text, output);
+#endif
+}
+
+const void* Layout::getFormatKey() const
+{
+	return 0;
+}
+
+void Layout::formatShared(LogString& output, const spi::LoggingEventPtr& event, Pool& pool) const
+{
+	auto key = getFormatKey();
+
+	if (!event->isFormattedEventShared(key))
+	{
+		format(output, event, pool);
+	}
+	else if (!event->getFormattedEvent(key, output))
+	{
+		auto startIndex = output.size();
+		format(output, event, pool);
+		event->keepFormattedEvent(key, output.data() + startIndex, output.size() - startIndex);
+	}
+}
+
 /**
  * The expected length of a formatted event excluding the message text
  */
@@ -99,6 +99,11 @@ LogString Level::toString() const
 	return name;
 }
 
+const LogString& Level::getName() const
+{
+	return name;
+}
+
 
 LevelPtr Level::toLevel(int val)
 {
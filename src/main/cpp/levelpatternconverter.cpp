@@ -47,7 +47,7 @@ void LevelPatternConverter::format(
 	LogString& toAppendTo,
 	log4cxx::helpers::Pool& /* p */) const
 {
-	toAppendTo.append(event->getLevel()->toString());
+	toAppendTo.append(event->getLevel()->getName());
 }
 
 
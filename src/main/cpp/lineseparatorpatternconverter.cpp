@@ -19,6 +19,7 @@
 #include <log4cxx/pattern/lineseparatorpatternconverter.h>
 #include <log4cxx/spi/loggingevent.h>
 #include <log4cxx/spi/location/locationinfo.h>
+#include <log4cxx/helpers/transcoder.h>
 
 using namespace log4cxx;
 using namespace log4cxx::pattern;
@@ -48,6 +49,20 @@ void LineSeparatorPatternConverter::format(
 	toAppendTo.append(LOG4CXX_EOL);
 }
 
+void LineSeparatorPatternConverter::formatUTF8(
+	const LoggingEventPtr& /* event */,
+	std::string& toAppendTo,
+	Pool& /* p */) const
+{
+	static const WideLife<std::string> eol([]
+		{
+			std::string result;
+			Transcoder::encodeUTF8(LOG4CXX_EOL, result);
+			return result;
+		}());
+	toAppendTo.append(eol.value());
+}
+
 void LineSeparatorPatternConverter::format(
 	const ObjectPtr& /* event */,
 	LogString& toAppendTo,
@@ -20,6 +20,7 @@
 #include <log4cxx/spi/loggingevent.h>
 #include <log4cxx/spi/location/locationinfo.h>
 #include <log4cxx/private/patternconverter_priv.h>
+#include <log4cxx/helpers/transcoder.h>
 
 using namespace log4cxx;
 using namespace log4cxx::pattern;
@@ -32,12 +33,20 @@ struct LiteralPatternConverter::LiteralPatternConverterPrivate : public PatternC
 {
 	LiteralPatternConverterPrivate( const LogString& name, const LogString& style, const LogString& literal1 ) :
 		PatternConverterPrivate( name, style ),
-		literal(literal1) {}
+		literal(literal1)
+	{
+		Transcoder::encodeUTF8(literal, utf8Literal);
+	}
 
 	/**
 	 * String literal.
 	 */
 	const LogString literal;
+
+	/**
+	 * UTF-8 encoded string literal.
+	 */
+	std::string utf8Literal;
 };
 
 IMPLEMENT_LOG4CXX_OBJECT(LiteralPatternConverter)
@@ -68,6 +77,14 @@ void LiteralPatternConverter::format(
 	toAppendTo.append(priv->literal);
 }
 
+void LiteralPatternConverter::formatUTF8(
+	const LoggingEventPtr& /* event */,
+	std::string& toAppendTo,
+	Pool& /* p */) const
+{
+	toAppendTo.append(priv->utf8Literal);
+}
+
 void LiteralPatternConverter::format(
 	const ObjectPtr& /* event */,
 	LogString& toAppendTo,
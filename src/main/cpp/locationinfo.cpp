@@ -120,6 +120,11 @@ int LocationInfo::getLineNumber() const
 }
 
 /** Returns the method name of the caller. */
+const char* LocationInfo::getFunctionName() const
+{
+	return methodName;
+}
+
 const std::string LocationInfo::getMethodName() const
 {
 	std::string tmp(methodName);
@@ -21,6 +21,7 @@
 #include <log4cxx/logmanager.h>
 #include <log4cxx/spi/loggerfactory.h>
 #include <log4cxx/appender.h>
+#include <log4cxx/layout.h>
 #include <log4cxx/level.h>
 #include <log4cxx/helpers/loglog.h>
 #include <log4cxx/hierarchy.h>
@@ -33,18 +34,221 @@
 #endif
 #include <log4cxx/private/log4cxx_private.h>
 #include <log4cxx/helpers/aprinitializer.h>
+#include <log4cxx/private/atomic_shared_ptr.h>
+#include <log4cxx/private/recycling_allocator.h>
+#include <apr_pools.h>
+#include <algorithm>
+#include <mutex>
+#include <unordered_set>
 
 using namespace log4cxx;
 using namespace log4cxx::helpers;
 using namespace log4cxx::spi;
 
+/**
+ * The appenders an event reaches, in order and without duplicates,
+ * when logged by a particular logger.
+ */
+struct AppenderRoute
+{
+	AppenderRoute(unsigned generation1) : generation(generation1) {}
+
+	/** The value of AppenderRouteCache::generation when the route was built. */
+	const unsigned generation;
+
+	AppenderList appenders;
+
+	/** Do more than one of the appenders have a layout? */
+	bool sharesText = false;
+
+	/** The format keys of layouts used by more than one of the appenders. */
+	std::vector<const void*> sharedFormatKeys;
+
+	/**
+	 * Find the layouts that may reuse text formatted for an event by another appender.
+	 */
+	void countLayouts()
+	{
+		std::vector<const void*> keys;
+		size_t layoutCount = 0;
+
+		for (auto& appender : appenders)
+		{
+			if (auto layout = appender->getLayout())
+			{
+				++layoutCount;
+
+				if (auto key = layout->getFormatKey())
+				{
+					if (std::find(keys.begin(), keys.end(), key) == keys.end())
+					{
+						keys.push_back(key);
+					}
+					else if (std::find(sharedFormatKeys.begin(), sharedFormatKeys.end(), key) == sharedFormatKeys.end())
+					{
+						sharedFormatKeys.push_back(key);
+					}
+				}
+			}
+		}
+
+		sharesText = 1 < layoutCount;
+	}
+};
+typedef std::shared_ptr<const AppenderRoute> AppenderRoutePtr;
+
+namespace
+{
+/**
+ * The routes held by loggers. A change to the appenders, additivity
+ * or parent of any logger advances the generation, and each logger
+ * rebuilds its route when it next logs. Removing an appender also
+ * releases the routes stored since the last removal, so a removed
+ * appender is not kept open by a logger which does not log again.
+ */
+struct AppenderRouteCache
+{
+	AppenderRouteCache() : generation(0) {}
+
+	/**
+	 * Incremented after any change to the appenders, additivity or parent of a logger.
+	 */
+	std::atomic<unsigned> generation;
+
+	/**
+	 * Guards held and the release of the route pointers it holds.
+	 */
+	std::mutex mutex;
+
+	/**
+	 * The routes stored since appenders were last removed.
+	 */
+	std::unordered_set<AtomicSharedPtr<const AppenderRoute>*> held;
+
+	/**
+	 * The cache, kept alive by each logger that uses it.
+	 */
+	static std::shared_ptr<AppenderRouteCache> instance()
+	{
+		static std::shared_ptr<AppenderRouteCache> cache = std::make_shared<AppenderRouteCache>();
+		return cache;
+	}
+
+	/**
+	 * Make every route out of date without visiting any logger.
+	 */
+	void advance()
+	{
+		++generation;
+	}
+
+	/**
+	 * Make every route out of date and drop the stored routes
+	 * which may refer to a removed appender.
+	 */
+	void release()
+	{
+		std::vector<AppenderRoutePtr> released;
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			++generation;
+
+			for (auto route : held)
+			{
+				if (auto oldRoute = route->load())
+				{
+					released.push_back(oldRoute);
+					route->store(AppenderRoutePtr());
+				}
+			}
+			held.clear();
+		}
+		// Appenders no longer referenced are destroyed here, without holding the lock
+	}
+};
+typedef std::shared_ptr<AppenderRouteCache> AppenderRouteCachePtr;
+}
+
 struct Logger::LoggerPrivate
 {
 	LoggerPrivate(Pool& p, const LogString& name1):
 		name(name1),
 		repositoryRaw(0),
 		aai(p),
-		additive(true) {}
+		additive(true),
+		routeCache(AppenderRouteCache::instance())
+	{
+	}
+
+	~LoggerPrivate()
+	{
+		std::lock_guard<std::mutex> lock(routeCache->mutex);
+		routeCache->held.erase(&route);
+	}
+
+	/**
+	The appenders reached from this logger, built when first required
+	after a change to the hierarchy.
+	*/
+	AppenderRoutePtr getRoute()
+	{
+		unsigned generation = routeCache->generation;
+		AppenderRoutePtr result = route.load();
+
+		if (!result || result->generation != generation)
+		{
+			auto newRoute = std::make_shared<AppenderRoute>(generation);
+
+			for (LoggerPrivate* l = this; l; l = l->parent ? l->parent->m_priv.get() : 0)
+			{
+				for (auto& appender : l->aai.getAllAppenders())
+				{
+					if (std::find(newRoute->appenders.begin(), newRoute->appenders.end(), appender) == newRoute->appenders.end())
+					{
+						newRoute->appenders.push_back(appender);
+					}
+				}
+
+				if (!l->additive)
+				{
+					break;
+				}
+			}
+
+			newRoute->countLayouts();
+
+			{
+				// Do not keep a route which may include an appender removed while it was built
+				std::lock_guard<std::mutex> lock(routeCache->mutex);
+
+				if (generation == routeCache->generation)
+				{
+					route.store(newRoute);
+					routeCache->held.insert(&route);
+				}
+			}
+			result = newRoute;
+		}
+
+		return result;
+	}
+
+	/**
+	Rebuild the route of each logger when it next logs.
+	*/
+	void invalidateAppenderRoutes()
+	{
+		routeCache->advance();
+	}
+
+	/**
+	Rebuild the route of each logger when it next logs
+	and drop the routes which may refer to a removed appender.
+	*/
+	void releaseAppenderRoutes()
+	{
+		routeCache->release();
+	}
 
 	/**
 	The name of this logger.
@@ -82,13 +286,19 @@ struct Logger::LoggerPrivate
 	        have their additivity flag set to <code>false</code> too. See
 	        the user manual for more details. */
 	bool additive;
+
+	/** The appenders reached from this logger when last built. */
+	AtomicSharedPtr<const AppenderRoute> route;
+
+	/** Tracks the generation and the stored routes. */
+	AppenderRouteCachePtr routeCache;
 };
 
 IMPLEMENT_LOG4CXX_OBJECT(Logger)
 
 Logger::Logger(Pool& p, const LogString& name1)
 	: m_priv(std::make_unique<LoggerPrivate>(p, name1))
-	, m_threshold(0)
+	, m_threshold(Level::OFF_INT)
 {
 }
 
@@ -99,6 +309,7 @@ Logger::~Logger()
 void Logger::addAppender(const AppenderPtr newAppender)
 {
 	m_priv->aai.addAppender(newAppender);
+	m_priv->invalidateAppenderRoutes();
 	if (auto rep = getHierarchy())
 	{
 		rep->fireAddAppenderEvent(this, newAppender.get());
@@ -122,27 +333,27 @@ void Logger::reconfigure( const std::vector<AppenderPtr>& appenders, bool additi
 			rep->fireAddAppenderEvent(this, it->get());
 		}
 	}
+
+	m_priv->releaseAppenderRoutes();
 }
 
 void Logger::callAppenders(const spi::LoggingEventPtr& event, Pool& p) const
 {
-	int writes = 0;
+	AppenderRoutePtr route = m_priv->getRoute();
 
-	for (const Logger* logger = this;
-		logger != 0;
-		logger = logger->m_priv->parent.get())
+	if (route->sharesText)
 	{
-		writes += logger->m_priv->aai.appendLoopOnAppenders(event, p);
+		event->shareFormattedText(route->sharedFormatKeys);
+	}
 
-		if (!logger->m_priv->additive)
-		{
-			break;
-		}
+	for (auto& appender : route->appenders)
+	{
+		appender->doAppend(event, p);
 	}
 
 	auto rep = getHierarchy();
 
-	if (writes == 0 && rep)
+	if (route->appenders.empty() && rep)
 	{
 		rep->emitNoAppenderWarning(const_cast<Logger*>(this));
 	}
@@ -158,18 +369,113 @@ void Logger::closeNestedAppenders()
 	}
 }
 
+namespace
+{
+/**
+ * The memory used by the calling thread while appending an event.
+ * It is cleared, not destroyed, after each event.
+ */
+struct ThreadScratchPool
+{
+	apr_pool_t* pool = 0;
+	bool inUse = false;
+
+	~ThreadScratchPool()
+	{
+		// The root pool has gone if this thread outlived the APR environment
+		if (pool && !APRInitializer::isDestructed)
+		{
+			apr_pool_destroy(pool);
+		}
+	}
+};
+
+apr_pool_t* createPool()
+{
+	apr_pool_t* result = 0;
+	apr_status_t stat = apr_pool_create(&result, APRInitializer::getRootPool());
+
+	if (stat != APR_SUCCESS)
+	{
+		throw PoolException(stat);
+	}
+
+	return result;
+}
+
+/**
+ * Provides the calling thread's scratch pool,
+ * or a new pool when an event is logged while appending another event.
+ */
+class ScratchPool
+{
+	public:
+		ScratchPool()
+			: scratch(getThreadScratch())
+			, nested(scratch.inUse)
+			, pool(nested ? createPool() : getScratchPool(scratch), nested)
+		{
+			scratch.inUse = true;
+		}
+
+		~ScratchPool()
+		{
+			if (!nested)
+			{
+				apr_pool_clear(scratch.pool);
+				scratch.inUse = false;
+			}
+		}
+
+		Pool& get()
+		{
+			return pool;
+		}
+
+	private:
+		ThreadScratchPool& scratch;
+		const bool nested;
+		Pool pool;
+
+		static ThreadScratchPool& getThreadScratch()
+		{
+			thread_local ThreadScratchPool result;
+			return result;
+		}
+
+		static apr_pool_t* getScratchPool(ThreadScratchPool& scratch)
+		{
+			if (!scratch.pool)
+			{
+				scratch.pool = createPool();
+			}
+
+			return scratch.pool;
+		}
+};
+
+/**
+ * Create an event in a recycled block of memory.
+ */
+template <class... Args>
+LoggingEventPtr createEvent(Args&&... args)
+{
+	return std::allocate_shared<LoggingEvent>(RecyclingAllocator<LoggingEvent>(), std::forward<Args>(args)...);
+}
+}
+
 void Logger::addEvent(const LevelPtr& level, std::string&& message, const LocationInfo& location) const
 {
 	if (!getHierarchy()) // Has removeHierarchy() been called?
 		return;
 #if LOG4CXX_LOGCHAR_IS_UTF8
-	auto event = std::make_shared<LoggingEvent>(m_priv->name, level, location, std::move(message));
+	auto event = createEvent(m_priv->name, level, location, std::move(message));
 #else
 	LOG4CXX_DECODE_CHAR(msg, message);
-	auto event = std::make_shared<LoggingEvent>(m_priv->name, level, location, std::move(msg));
+	auto event = createEvent(m_priv->name, level, location, std::move(msg));
 #endif
-	Pool p;
-	callAppenders(event, p);
+	ScratchPool p;
+	callAppenders(event, p.get());
 }
 
 void Logger::forcedLog(const LevelPtr& level, const std::string& message,
@@ -178,13 +484,13 @@ void Logger::forcedLog(const LevelPtr& level, const std::string& message,
 	if (!getHierarchy()) // Has removeHierarchy() been called?
 		return;
 #if LOG4CXX_LOGCHAR_IS_UTF8
-	auto event = std::make_shared<LoggingEvent>(m_priv->name, level, message, location);
+	auto event = createEvent(m_priv->name, level, message, location);
 #else
 	LOG4CXX_DECODE_CHAR(msg, message);
-	auto event = std::make_shared<LoggingEvent>(m_priv->name, level, location, std::move(msg));
+	auto event = createEvent(m_priv->name, level, location, std::move(msg));
 #endif
-	Pool p;
-	callAppenders(event, p);
+	ScratchPool p;
+	callAppenders(event, p.get());
 }
 
 void Logger::forcedLog(const LevelPtr& level1, const std::string& message) const
@@ -192,13 +498,22 @@ void Logger::forcedLog(const LevelPtr& level1, const std::string& message) const
 	forcedLog(level1, message, LocationInfo::getLocationUnavailable());
 }
 
+void Logger::addEvent(const LevelPtr& level, DeferredMessage&& message, const LocationInfo& location) const
+{
+	if (!getHierarchy()) // Has removeHierarchy() been called?
+		return;
+	ScratchPool p;
+	auto event = createEvent(m_priv->name, level, location, std::move(message));
+	callAppenders(event, p.get());
+}
+
 void Logger::addEventLS(const LevelPtr& level, LogString&& message, const LocationInfo& location) const
 {
 	if (!getHierarchy()) // Has removeHierarchy() been called?
 		return;
-	Pool p;
-	auto event = std::make_shared<LoggingEvent>(m_priv->name, level, location, std::move(message));
-	callAppenders(event, p);
+	ScratchPool p;
+	auto event = createEvent(m_priv->name, level, location, std::move(message));
+	callAppenders(event, p.get());
 }
 
 void Logger::forcedLogLS(const LevelPtr& level1, const LogString& message,
@@ -206,9 +521,9 @@ void Logger::forcedLogLS(const LevelPtr& level1, const LogString& message,
 {
 	if (!getHierarchy()) // Has removeHierarchy() been called?
 		return;
-	Pool p;
-	auto event = std::make_shared<LoggingEvent>(m_priv->name, level1, message, location);
-	callAppenders(event, p);
+	ScratchPool p;
+	auto event = createEvent(m_priv->name, level1, message, location);
+	callAppenders(event, p.get());
 }
 
 
@@ -312,87 +627,42 @@ bool Logger::isAttached(const AppenderPtr appender) const
 
 bool Logger::isTraceEnabled() const
 {
-	auto rep = getHierarchy();
-
-	if (!rep || rep->isDisabled(Level::TRACE_INT))
-	{
-		return false;
-	}
-
-	return getEffectiveLevel()->toInt() <= Level::TRACE_INT;
+	return m_threshold.load(std::memory_order_relaxed) <= Level::TRACE_INT;
 }
 
 bool Logger::isDebugEnabled() const
 {
-	auto rep = getHierarchy();
-
-	if (!rep || rep->isDisabled(Level::DEBUG_INT))
-	{
-		return false;
-	}
-
-	return getEffectiveLevel()->toInt() <= Level::DEBUG_INT;
+	return m_threshold.load(std::memory_order_relaxed) <= Level::DEBUG_INT;
 }
 
 bool Logger::isEnabledFor(const LevelPtr& level1) const
 {
-	auto rep = getHierarchy();
+	int threshold = m_threshold.load(std::memory_order_relaxed);
 
-	if (!rep || rep->isDisabled(level1->toInt()))
-	{
-		return false;
-	}
-
-	return level1->isGreaterOrEqual(getEffectiveLevel());
+	// A threshold of OFF is also used by a logger outside a hierarchy, which enables nothing
+	return threshold <= level1->toInt()
+		&& (threshold < Level::OFF_INT || getHierarchy());
 }
 
 
 bool Logger::isInfoEnabled() const
 {
-	auto rep = getHierarchy();
-
-	if (!rep || rep->isDisabled(Level::INFO_INT))
-	{
-		return false;
-	}
-
-	return getEffectiveLevel()->toInt() <= Level::INFO_INT;
+	return m_threshold.load(std::memory_order_relaxed) <= Level::INFO_INT;
 }
 
 bool Logger::isErrorEnabled() const
 {
-	auto rep = getHierarchy();
-
-	if (!rep || rep->isDisabled(Level::ERROR_INT))
-	{
-		return false;
-	}
-
-	return getEffectiveLevel()->toInt() <= Level::ERROR_INT;
+	return m_threshold.load(std::memory_order_relaxed) <= Level::ERROR_INT;
 }
 
 bool Logger::isWarnEnabled() const
 {
-	auto rep = getHierarchy();
-
-	if (!rep || rep->isDisabled(Level::WARN_INT))
-	{
-		return false;
-	}
-
-	return getEffectiveLevel()->toInt() <= Level::WARN_INT;
+	return m_threshold.load(std::memory_order_relaxed) <= Level::WARN_INT;
 }
 
 bool Logger::isFatalEnabled() const
 {
-	auto rep = getHierarchy();
-
-	if (!rep || rep->isDisabled(Level::FATAL_INT))
-	{
-		return false;
-	}
-
-	return getEffectiveLevel()->toInt() <= Level::FATAL_INT;
+	return m_threshold.load(std::memory_order_relaxed) <= Level::FATAL_INT;
 }
 
 /*void Logger::l7dlog(const LevelPtr& level, const String& key,
@@ -425,14 +695,7 @@ bool Logger::isFatalEnabled() const
 void Logger::l7dlog(const LevelPtr& level1, const LogString& key,
 	const LocationInfo& location, const std::vector<LogString>& params) const
 {
-	auto rep = getHierarchy();
-
-	if (!rep || rep->isDisabled(level1->toInt()))
-	{
-		return;
-	}
-
-	if (level1->isGreaterOrEqual(getEffectiveLevel()))
+	if (isEnabledFor(level1))
 	{
 		LogString pattern = getResourceBundleString(key);
 		LogString msg;
@@ -503,36 +766,43 @@ void Logger::l7dlog(const LevelPtr& level1, const std::string& key,
 void Logger::removeAllAppenders()
 {
 	m_priv->aai.removeAllAppenders();
+	m_priv->releaseAppenderRoutes();
 }
 
 void Logger::removeAppender(const AppenderPtr appender)
 {
 	m_priv->aai.removeAppender(appender);
+	m_priv->releaseAppenderRoutes();
 }
 
 void Logger::removeAppender(const LogString& name1)
 {
 	m_priv->aai.removeAppender(name1);
+	m_priv->releaseAppenderRoutes();
 }
 
 void Logger::removeHierarchy()
 {
 	m_priv->repositoryRaw = 0;
+	updateThreshold();
 }
 
 void Logger::setAdditivity(bool additive1)
 {
 	m_priv->additive = additive1;
+	m_priv->invalidateAppenderRoutes();
 }
 
 void Logger::setHierarchy(spi::LoggerRepository* repository1)
 {
 	m_priv->repositoryRaw = repository1;
+	updateThreshold();
 }
 
 void Logger::setParent(LoggerPtr parentLogger)
 {
 	m_priv->parent = parentLogger;
+	m_priv->invalidateAppenderRoutes();
 	updateThreshold();
 }
 
@@ -541,15 +811,36 @@ void Logger::setLevel(const LevelPtr level1)
 	if (m_priv->level != level1)
 	{
 		m_priv->level = level1;
-		updateThreshold();
 		if (auto rep = dynamic_cast<Hierarchy*>(getHierarchy()))
 			rep->updateChildren(this);
+		else
+			updateThreshold();
 	}
 }
 
+void Logger::setLevelInternal(const LevelPtr& level1)
+{
+	m_priv->level = level1;
+}
+
 void Logger::updateThreshold()
 {
-	m_threshold = getEffectiveLevel()->toInt();
+	// Nothing is enabled until the logger is in a hierarchy and has a level
+	int threshold = Level::OFF_INT;
+
+	if (auto rep = getHierarchy())
+	{
+		for (const Logger* l = this; l != 0; l = l->m_priv->parent.get())
+		{
+			if (l->m_priv->level)
+			{
+				threshold = std::max(l->m_priv->level->toInt(), rep->getThreshold()->toInt());
+				break;
+			}
+		}
+	}
+
+	m_threshold.store(threshold, std::memory_order_relaxed);
 }
 
 const LogString& Logger::getName() const
@@ -729,13 +1020,13 @@ void Logger::addEvent(const LevelPtr& level, std::wstring&& message, const Locat
 	if (!getHierarchy()) // Has removeHierarchy() been called?
 		return;
 #if LOG4CXX_LOGCHAR_IS_WCHAR
-	auto event = std::make_shared<LoggingEvent>(m_priv->name, level, location, std::move(message));
+	auto event = createEvent(m_priv->name, level, location, std::move(message));
 #else
 	LOG4CXX_DECODE_WCHAR(msg, message);
-	auto event = std::make_shared<LoggingEvent>(m_priv->name, level, location, std::move(msg));
+	auto event = createEvent(m_priv->name, level, location, std::move(msg));
 #endif
-	Pool p;
-	callAppenders(event, p);
+	ScratchPool p;
+	callAppenders(event, p.get());
 }
 
 void Logger::forcedLog(const LevelPtr& level, const std::wstring& message,
@@ -744,13 +1035,13 @@ void Logger::forcedLog(const LevelPtr& level, const std::wstring& message,
 	if (!getHierarchy()) // Has removeHierarchy() been called?
 		return;
 #if LOG4CXX_LOGCHAR_IS_WCHAR
-	auto event = std::make_shared<LoggingEvent>(m_priv->name, level, message, location);
+	auto event = createEvent(m_priv->name, level, message, location);
 #else
 	LOG4CXX_DECODE_WCHAR(msg, message);
-	auto event = std::make_shared<LoggingEvent>(m_priv->name, level, location, std::move(msg));
+	auto event = createEvent(m_priv->name, level, location, std::move(msg));
 #endif
-	Pool p;
-	callAppenders(event, p);
+	ScratchPool p;
+	callAppenders(event, p.get());
 }
 
 void Logger::forcedLog(const LevelPtr& level1, const std::wstring& message) const
@@ -895,10 +1186,10 @@ void Logger::addEvent(const LevelPtr& level1, std::basic_string<UniChar>&& messa
 {
 	if (!getHierarchy()) // Has removeHierarchy() been called?
 		return;
-	Pool p;
+	ScratchPool p;
 	LOG4CXX_DECODE_UNICHAR(msg, message);
-	auto event = std::make_shared<LoggingEvent>(m_priv->name, level1, location, std::move(msg));
-	callAppenders(event, p);
+	auto event = createEvent(m_priv->name, level1, location, std::move(msg));
+	callAppenders(event, p.get());
 }
 
 void Logger::forcedLog(const LevelPtr& level1, const std::basic_string<UniChar>& message,
@@ -906,21 +1197,21 @@ void Logger::forcedLog(const LevelPtr& level1, const std::basic_string<UniChar>&
 {
 	if (!getHierarchy()) // Has removeHierarchy() been called?
 		return;
-	Pool p;
+	ScratchPool p;
 	LOG4CXX_DECODE_UNICHAR(msg, message);
-	auto event = std::make_shared<LoggingEvent>(m_priv->name, level1, location, std::move(msg));
-	callAppenders(event, p);
+	auto event = createEvent(m_priv->name, level1, location, std::move(msg));
+	callAppenders(event, p.get());
 }
 
 void Logger::forcedLog(const LevelPtr& level1, const std::basic_string<UniChar>& message) const
 {
 	if (!getHierarchy()) // Has removeHierarchy() been called?
 		return;
-	Pool p;
+	ScratchPool p;
 	LOG4CXX_DECODE_UNICHAR(msg, message);
-	auto event = std::make_shared<LoggingEvent>(m_priv->name, level1, msg,
+	auto event = createEvent(m_priv->name, level1, msg,
 			LocationInfo::getLocationUnavailable());
-	callAppenders(event, p);
+	callAppenders(event, p.get());
 }
 
 void Logger::getName(std::basic_string<UniChar>& rv) const
@@ -1056,21 +1347,21 @@ void Logger::forcedLog(const LevelPtr& level, const CFStringRef& message,
 {
 	if (!getHierarchy()) // Has removeHierarchy() been called?
 		return;
-	Pool p;
+	ScratchPool p;
 	LOG4CXX_DECODE_CFSTRING(msg, message);
-	auto event = std::make_shared<LoggingEvent>(m_priv->name, level, location, std::move(msg));
-	callAppenders(event, p);
+	auto event = createEvent(m_priv->name, level, location, std::move(msg));
+	callAppenders(event, p.get());
 }
 
 void Logger::forcedLog(const LevelPtr& level, const CFStringRef& message) const
 {
 	if (!getHierarchy()) // Has removeHierarchy() been called?
 		return;
-	Pool p;
+	ScratchPool p;
 	LOG4CXX_DECODE_CFSTRING(msg, message);
-	auto event = std::make_shared<LoggingEvent>(m_priv->name, level, msg,
+	auto event = createEvent(m_priv->name, level, msg,
 			LocationInfo::getLocationUnavailable());
-	callAppenders(event, p);
+	callAppenders(event, p.get());
 }
 
 void Logger::getName(CFStringRef& rv) const
@@ -37,6 +37,13 @@
 #include <log4cxx/logger.h>
 #include <log4cxx/private/log4cxx_private.h>
 #include <log4cxx/helpers/date.h>
+#include <log4cxx/private/recycling_allocator.h>
+#include <log4cxx/private/nametable.h>
+#include <log4cxx/helpers/deferredmessage.h>
+#include <mutex>
+#include <atomic>
+#include <algorithm>
+#include <cstddef>
 
 using namespace log4cxx;
 using namespace log4cxx::spi;
@@ -45,6 +52,7 @@ using namespace log4cxx::helpers;
 struct LoggingEvent::LoggingEventPrivate
 {
 	LoggingEventPrivate() :
+		logger(NameTable::intern(LogString())),
 		ndc(0),
 		mdcCopy(0),
 		properties(0),
@@ -52,8 +60,11 @@ struct LoggingEvent::LoggingEventPrivate
 		mdcCopyLookupRequired(true),
 		timeStamp(0),
 		locationInfo(),
-		threadName(getCurrentThreadName()),
-		threadUserName(getCurrentThreadUserName())
+		threadName(NameTable::intern(getCurrentThreadName()).name),
+		threadUserName(NameTable::intern(getCurrentThreadUserName()).name),
+		deferredStorage(0),
+		deferredMessage(0),
+		shared(0)
 	{
 	}
 
@@ -63,7 +74,7 @@ struct LoggingEvent::LoggingEventPrivate
 		, const LocationInfo& locationInfo1
 		, LogString&& message1
 		) :
-		logger(logger1),
+		logger(NameTable::intern(logger1)),
 		level(level1),
 		ndc(0),
 		mdcCopy(0),
@@ -73,16 +84,19 @@ struct LoggingEvent::LoggingEventPrivate
 		message(std::move(message1)),
 		timeStamp(Date::currentTime()),
 		locationInfo(locationInfo1),
-		threadName(getCurrentThreadName()),
-		threadUserName(getCurrentThreadUserName()),
-		chronoTimeStamp(std::chrono::microseconds(timeStamp))
+		threadName(NameTable::intern(getCurrentThreadName()).name),
+		threadUserName(NameTable::intern(getCurrentThreadUserName()).name),
+		chronoTimeStamp(std::chrono::microseconds(timeStamp)),
+		deferredStorage(0),
+		deferredMessage(0),
+		shared(0)
 	{
 	}
 
 	LoggingEventPrivate(
 		const LogString& logger1, const LevelPtr& level1,
 		const LogString& message1, const LocationInfo& locationInfo1) :
-		logger(logger1),
+		logger(NameTable::intern(logger1)),
 		level(level1),
 		ndc(0),
 		mdcCopy(0),
@@ -92,9 +106,66 @@ struct LoggingEvent::LoggingEventPrivate
 		message(message1),
 		timeStamp(Date::currentTime()),
 		locationInfo(locationInfo1),
-		threadName(getCurrentThreadName()),
-		threadUserName(getCurrentThreadUserName()),
-		chronoTimeStamp(std::chrono::microseconds(timeStamp))
+		threadName(NameTable::intern(getCurrentThreadName()).name),
+		threadUserName(NameTable::intern(getCurrentThreadUserName()).name),
+		chronoTimeStamp(std::chrono::microseconds(timeStamp)),
+		deferredStorage(0),
+		deferredMessage(0),
+		shared(0)
+	{
+	}
+
+	LoggingEventPrivate
+		( const LogString& logger1
+		, const LevelPtr& level1
+		, const LocationInfo& locationInfo1
+		, DeferredMessage&& message1
+		) :
+		logger(NameTable::intern(logger1)),
+		level(level1),
+		ndc(0),
+		mdcCopy(0),
+		properties(0),
+		ndcLookupRequired(true),
+		mdcCopyLookupRequired(true),
+		timeStamp(Date::currentTime()),
+		locationInfo(locationInfo1),
+		threadName(NameTable::intern(getCurrentThreadName()).name),
+		threadUserName(NameTable::intern(getCurrentThreadUserName()).name),
+		chronoTimeStamp(std::chrono::microseconds(timeStamp)),
+		deferredStorage(DeferredPool::allocate()),
+		deferredMessage(message1.moveTo(deferredStorage)),
+		shared(0)
+	{
+	}
+
+	LoggingEventPrivate
+		( const LogString& logger1
+		, const LevelPtr& level1
+		, const LogString& message1
+		, const LocationInfo& locationInfo1
+		, log4cxx_time_t timeStamp1
+		, const LogString& threadName1
+		, const LogString& threadUserName1
+		, const LogString* ndc1
+		, const MDC::Map& mdc1
+		) :
+		logger(NameTable::intern(logger1)),
+		level(level1),
+		ndc(ndc1 ? new LogString(*ndc1) : 0),
+		mdcCopy(new MDC::Map(mdc1)),
+		properties(0),
+		ndcLookupRequired(false),
+		mdcCopyLookupRequired(false),
+		message(message1),
+		timeStamp(timeStamp1),
+		locationInfo(locationInfo1),
+		threadName(NameTable::intern(threadName1).name),
+		threadUserName(NameTable::intern(threadUserName1).name),
+		chronoTimeStamp(std::chrono::microseconds(timeStamp)),
+		deferredStorage(0),
+		deferredMessage(0),
+		shared(0)
 	{
 	}
 
@@ -103,12 +174,44 @@ struct LoggingEvent::LoggingEventPrivate
 		delete ndc;
 		delete mdcCopy;
 		delete properties;
+		if (deferredMessage)
+		{
+			deferredMessage->~DeferredMessage();
+			DeferredPool::deallocate(deferredStorage);
+		}
+		delete shared;
+	}
+
+	/**
+	 * Reuse the memory of released instances.
+	 */
+	static void* operator new(size_t size)
+	{
+		if (size != sizeof(LoggingEventPrivate))
+		{
+			return ::operator new(size);
+		}
+
+		return BlockPool<sizeof(LoggingEventPrivate), alignof(LoggingEventPrivate)>::allocate();
+	}
+
+	static void operator delete(void* p, size_t size)
+	{
+		if (size != sizeof(LoggingEventPrivate))
+		{
+			::operator delete(p);
+		}
+		else
+		{
+			BlockPool<sizeof(LoggingEventPrivate), alignof(LoggingEventPrivate)>::deallocate(p);
+		}
 	}
 
 	/**
 	* The logger of the logging event.
+	* Shared with other events, so it remains valid after the logger is gone.
 	**/
-	LogString logger;
+	const NameTable::Entry& logger;
 
 	/** level of logging event. */
 	LevelPtr level;
@@ -151,7 +254,8 @@ struct LoggingEvent::LoggingEventPrivate
 
 
 	/** The identifier of thread in which this logging event
-	was generated.
+	was generated. Shared with other events, so it remains valid
+	after the thread has ended.
 	*/
 	const LogString& threadName;
 
@@ -163,6 +267,152 @@ struct LoggingEvent::LoggingEventPrivate
 	const LogString& threadUserName;
 
 	std::chrono::time_point<std::chrono::system_clock> chronoTimeStamp;
+
+	typedef BlockPool<DeferredMessage::MaxSize, alignof(std::max_align_t)> DeferredPool;
+
+	/** Holds *deferredMessage, or null. */
+	void* deferredStorage;
+
+	/** Produces the message when it is first requested, or null. */
+	DeferredMessage* deferredMessage;
+
+	std::once_flag messageFormatted;
+
+	/**
+	 * Text produced from this event which other appenders may reuse.
+	 * A slot is claimed by setting its key and published by setting ready.
+	 */
+	template <class Text>
+	struct KeptText
+	{
+		std::atomic<const void*> key{nullptr};
+		std::atomic<bool> ready{false};
+		Text text;
+	};
+
+	template <size_t MaxLength>
+	struct Chars
+	{
+		enum { Capacity = MaxLength };
+		size_t length;
+		logchar data[MaxLength];
+	};
+
+	/** The output of a pattern converter. */
+	typedef Chars<48> Field;
+
+	/** The output of a layout, held in a recycled block. */
+	typedef Chars<(1024 - sizeof(size_t)) / sizeof(logchar)> Event;
+	typedef BlockPool<sizeof(Event), alignof(Event)> EventPool;
+
+	/**
+	 * Text produced from this event which other appenders may reuse,
+	 * present only when the event is sent to more than one layout.
+	 */
+	struct SharedText
+	{
+		/** The layouts with more than one appender, whose output is kept. */
+		const void* eventKeys[2] = {};
+
+		/** The output of layouts. */
+		KeptText<Event*> formattedEvent[2];
+
+		/** The output of pattern converters. */
+		KeptText<Field> formattedField[2];
+
+		~SharedText()
+		{
+			for (auto& slot : formattedEvent)
+			{
+				if (slot.ready.load(std::memory_order_relaxed))
+				{
+					EventPool::deallocate(slot.text);
+				}
+			}
+		}
+
+		static void* operator new(size_t)
+		{
+			return BlockPool<sizeof(SharedText), alignof(SharedText)>::allocate();
+		}
+
+		static void operator delete(void* p)
+		{
+			BlockPool<sizeof(SharedText), alignof(SharedText)>::deallocate(p);
+		}
+	};
+
+	/** Set before the event is passed to any appender, or null. */
+	SharedText* shared;
+
+	template <class Text, size_t N>
+	static const Text* findKept(const KeptText<Text> (&slots)[N], const void* key)
+	{
+		for (auto& slot : slots)
+		{
+			if (slot.ready.load(std::memory_order_acquire))
+			{
+				if (slot.key.load(std::memory_order_relaxed) == key)
+				{
+					return &slot.text;
+				}
+			}
+			else if (!slot.key.load(std::memory_order_relaxed))
+			{
+				break;
+			}
+		}
+
+		return 0;
+	}
+
+	/**
+	 * A slot for the text identified by \c key,
+	 * or null if all are in use or another thread is keeping the same text.
+	 */
+	template <class Text, size_t N>
+	static KeptText<Text>* claimKept(KeptText<Text> (&slots)[N], const void* key)
+	{
+		for (auto& slot : slots)
+		{
+			const void* expected = 0;
+
+			if (slot.key.compare_exchange_strong(expected, key))
+			{
+				return &slot;
+			}
+
+			if (expected == key)
+			{
+				break;
+			}
+		}
+
+		return 0;
+	}
+
+	/**
+	 * The application supplied message of logging event.
+	 */
+	const LogString& getMessage()
+	{
+		if (deferredMessage)
+		{
+			std::call_once(messageFormatted, [this]()
+			{
+				try
+				{
+					deferredMessage->format(message);
+				}
+				catch (std::exception& ex)
+				{
+					LogLog::error(LOG4CXX_STR("Unable to format message"), ex);
+				}
+			});
+		}
+
+		return message;
+	}
 };
 
 IMPLEMENT_LOG4CXX_OBJECT(LoggingEvent)
@@ -198,6 +448,32 @@ LoggingEvent::LoggingEvent(
 {
 }
 
+LoggingEvent::LoggingEvent
+	( const LogString&    logger
+	, const LevelPtr&     level
+	, const LocationInfo& location
+	, DeferredMessage&&   message
+	)
+	: m_priv(std::make_unique<LoggingEventPrivate>(logger, level, location, std::move(message)))
+{
+}
+
+LoggingEvent::LoggingEvent
+	( const LogString&    logger
+	, const LevelPtr&     level
+	, const LogString&    message
+	, const LocationInfo& location
+	, log4cxx_time_t      timeStamp
+	, const LogString&    threadName
+	, const LogString&    threadUserName
+	, const LogString*    ndc
+	, const MDC::Map&     mdc
+	)
+	: m_priv(std::make_unique<LoggingEventPrivate>(logger, level, message, location
+		, timeStamp, threadName, threadUserName, ndc, mdc))
+{
+}
+
 LoggingEvent::~LoggingEvent()
 {
 }
@@ -450,6 +726,112 @@ void LoggingEvent::setProperty(const LogString& key, const LogString& value)
 	(*m_priv->properties)[key] = value;
 }
 
+void LoggingEvent::shareFormattedText(const std::vector<const void*>& keys)
+{
+	if (m_priv->shared)
+	{
+		return;
+	}
+
+	m_priv->shared = new LoggingEventPrivate::SharedText;
+	auto& eventKeys = m_priv->shared->eventKeys;
+
+	for (size_t i = 0; i < keys.size() && i < sizeof(eventKeys) / sizeof(eventKeys[0]); ++i)
+	{
+		eventKeys[i] = keys[i];
+	}
+}
+
+bool LoggingEvent::isFormattedEventShared(const void* key) const
+{
+	if (!m_priv->shared || !key)
+	{
+		return false;
+	}
+
+	for (auto sharedKey : m_priv->shared->eventKeys)
+	{
+		if (sharedKey == key)
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
+
+bool LoggingEvent::getFormattedEvent(const void* key, LogString& dest) const
+{
+	if (!m_priv->shared)
+	{
+		return false;
+	}
+
+	auto text = LoggingEventPrivate::findKept(m_priv->shared->formattedEvent, key);
+
+	if (!text)
+	{
+		return false;
+	}
+
+	dest.append((*text)->data, (*text)->length);
+	return true;
+}
+
+void LoggingEvent::keepFormattedEvent(const void* key, const logchar* text, size_t length) const
+{
+	if (!isFormattedEventShared(key) || LoggingEventPrivate::Event::Capacity < length)
+	{
+		return;
+	}
+
+	auto slot = LoggingEventPrivate::claimKept(m_priv->shared->formattedEvent, key);
+
+	if (slot)
+	{
+		auto block = static_cast<LoggingEventPrivate::Event*>(LoggingEventPrivate::EventPool::allocate());
+		std::copy(text, text + length, block->data);
+		block->length = length;
+		slot->text = block;
+		slot->ready.store(true, std::memory_order_release);
+	}
+}
+
+bool LoggingEvent::getFormattedField(const void* key, LogString& dest) const
+{
+	if (!m_priv->shared)
+	{
+		return false;
+	}
+
+	auto field = LoggingEventPrivate::findKept(m_priv->shared->formattedField, key);
+
+	if (!field)
+	{
+		return false;
+	}
+
+	dest.append(field->data, field->length);
+	return true;
+}
+
+void LoggingEvent::keepFormattedField(const void* key, const logchar* text, size_t length) const
+{
+	if (!m_priv->shared || LoggingEventPrivate::Field::Capacity < length)
+	{
+		return;
+	}
+
+	auto slot = LoggingEventPrivate::claimKept(m_priv->shared->formattedField, key);
+
+	if (slot)
+	{
+		std::copy(text, text + length, slot->text.data);
+		slot->text.length = length;
+		slot->ready.store(true, std::memory_order_release);
+	}
+}
+
 const LevelPtr& LoggingEvent::getLevel() const
 {
 	return m_priv->level;
@@ -457,17 +839,17 @@ const LevelPtr& LoggingEvent::getLevel() const
 
 const LogString& LoggingEvent::getLoggerName() const
 {
-	return m_priv->logger;
+	return m_priv->logger.name;
 }
 
 const LogString& LoggingEvent::getMessage() const
 {
-	return m_priv->message;
+	return m_priv->getMessage();
 }
 
 const LogString& LoggingEvent::getRenderedMessage() const
 {
-	return m_priv->message;
+	return m_priv->getMessage();
 }
 
 const LogString& LoggingEvent::getThreadName() const
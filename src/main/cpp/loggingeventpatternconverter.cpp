@@ -19,6 +19,7 @@
 #include <log4cxx/pattern/loggingeventpatternconverter.h>
 #include <log4cxx/spi/loggingevent.h>
 #include <log4cxx/private/patternconverter_priv.h>
+#include <log4cxx/helpers/transcoder.h>
 
 using namespace log4cxx;
 using namespace log4cxx::pattern;
@@ -52,6 +53,19 @@ void LoggingEventPatternConverter::format(const ObjectPtr& obj,
 	}
 }
 
+void LoggingEventPatternConverter::formatUTF8(const LoggingEventPtr& event,
+	std::string& output,
+	Pool& p) const
+{
+#if LOG4CXX_LOGCHAR_IS_UTF8
+	format(event, output, p);
+#else
+	LogString text;
+	format(event, text, p);
+	Transcoder::encodeUTF8(text, output);
+#endif
+}
+
 bool LoggingEventPatternConverter::handlesThrowable() const
 {
 	return false;
@@ -0,0 +1,469 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <log4cxx/logstring.h>
+#include <log4cxx/helpers/mappedfileoutputstream.h>
+#include <log4cxx/helpers/exception.h>
+#include <log4cxx/helpers/bytebuffer.h>
+#include <log4cxx/private/log4cxx_private.h>
+#include <apr_file_io.h>
+#include <apr_portable.h>
+#if !defined(LOG4CXX)
+	#define LOG4CXX 1
+#endif
+#include <log4cxx/helpers/aprinitializer.h>
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <errno.h>
+#if LOG4CXX_HAS_MMAP && LOG4CXX_HAS_POSIX_FALLOCATE
+	#define LOG4CXX_HAS_MAPPED_FILES 1
+#else
+	#define LOG4CXX_HAS_MAPPED_FILES 0
+#endif
+#if LOG4CXX_HAS_MAPPED_FILES
+	#include <sys/mman.h>
+	#include <sys/stat.h>
+	#include <fcntl.h>
+	#include <unistd.h>
+#endif
+
+using namespace log4cxx;
+using namespace log4cxx::helpers;
+
+#if LOG4CXX_HAS_MAPPED_FILES
+namespace
+{
+/**
+ * The last bytes of a file with preallocated space are a Trailer,
+ * which records the number of bytes written when the stream was last flushed.
+ * A file that ends with a Trailer was not closed.
+ */
+const char TrailerMagic[8] = { 'l', '4', 'x', 'm', '\xff', '\xfe', '\xfd', '\x01' };
+const size_t TrailerSize = sizeof (TrailerMagic) + 8;
+}
+#endif
+
+struct MappedFileOutputStream::MappedFileOutputStreamPrivate
+{
+	MappedFileOutputStreamPrivate(size_t extentSize1)
+		: fileptr(nullptr)
+		, fd(-1)
+		, pageSize(4096)
+		, extentSize(extentSize1)
+		, region(nullptr)
+		, regionOffset(0)
+		, regionLength(0)
+		, allocated(0)
+		, length(0)
+		, syncedLength(0)
+		, trailerOffset(0)
+	{
+	}
+
+	Pool pool;
+	apr_file_t* fileptr;
+	int fd;
+	size_t pageSize;
+
+	/**
+	 * The number of bytes by which the file is extended and mapped.
+	 */
+	size_t extentSize;
+
+	/**
+	 * The mapped part of the file, which starts at \c regionOffset.
+	 */
+	char* region;
+	size_t regionOffset;
+	size_t regionLength;
+
+	/**
+	 * The size of the file including preallocated space.
+	 */
+	size_t allocated;
+
+	/**
+	 * The number of bytes written to the file.
+	 */
+	size_t length;
+
+	/**
+	 * The page aligned file offset up to which writing to disk was requested.
+	 */
+	size_t syncedLength;
+
+	/**
+	 * The file offset of the Trailer, or zero if it has none.
+	 */
+	size_t trailerOffset;
+
+#if LOG4CXX_HAS_MAPPED_FILES
+	void open(const LogString& filename, bool append)
+	{
+		long sysPageSize = sysconf(_SC_PAGESIZE);
+
+		if (0 < sysPageSize)
+		{
+			pageSize = (size_t) sysPageSize;
+		}
+
+		// At least two pages, so mapping the last page also extends the file
+		extentSize = std::max(2 * pageSize, (extentSize + pageSize - 1) / pageSize * pageSize);
+
+		apr_int32_t flags = APR_READ | APR_WRITE | APR_CREATE;
+
+		if (!append)
+		{
+			flags |= APR_TRUNCATE;
+		}
+
+		File fn;
+		fn.setPath(filename);
+		apr_status_t stat = fn.open(&fileptr, flags, APR_OS_DEFAULT, pool);
+
+		if (stat != APR_SUCCESS)
+		{
+			throw IOException(stat);
+		}
+
+		apr_os_file_t osFile;
+		stat = apr_os_file_get(&osFile, fileptr);
+
+		if (stat != APR_SUCCESS)
+		{
+			throw IOException(stat);
+		}
+
+		fd = osFile;
+		struct stat info;
+
+		if (fstat(fd, &info) != 0)
+		{
+			throw IOException(errno);
+		}
+
+		allocated = length = (size_t) info.st_size;
+
+		if (append)
+		{
+			trimPadding();
+		}
+
+		syncedLength = length - length % pageSize;
+
+		// Allocate the first extent now, so a file system that cannot
+		// preallocate space is reported before anything is written
+		map(length);
+	}
+
+	/**
+	 * Remove the preallocated space left at the end of a file that was not closed.
+	 * The bytes after the length recorded in the Trailer are kept
+	 * up to the last non-zero byte, as they were written but not flushed.
+	 */
+	void trimPadding()
+	{
+		char trailer[TrailerSize];
+
+		if (allocated < TrailerSize
+			|| pread(fd, trailer, TrailerSize, (off_t) (allocated - TrailerSize)) != (ssize_t) TrailerSize
+			|| std::memcmp(trailer, TrailerMagic, sizeof (TrailerMagic)) != 0)
+		{
+			return;
+		}
+
+		size_t limit = 0;
+
+		for (size_t i = 0; i < 8; ++i)
+		{
+			limit |= size_t((unsigned char) trailer[sizeof (TrailerMagic) + i]) << (8 * i);
+		}
+
+		size_t end = allocated - TrailerSize;
+
+		if (end < limit)
+		{
+			return;
+		}
+
+		char chunk[4096];
+
+		while (limit < end)
+		{
+			size_t count = std::min(sizeof (chunk), end - limit);
+
+			if (pread(fd, chunk, count, (off_t) (end - count)) != (ssize_t) count)
+			{
+				break;
+			}
+
+			size_t nonZeroCount = count;
+
+			while (0 < nonZeroCount && chunk[nonZeroCount - 1] == 0)
+			{
+				--nonZeroCount;
+			}
+
+			end -= count - nonZeroCount;
+
+			if (0 < nonZeroCount)
+			{
+				break;
+			}
+		}
+
+		length = end;
+
+		if (ftruncate(fd, (off_t) length) != 0)
+		{
+			throw IOException(errno);
+		}
+
+		allocated = length;
+	}
+
+	/**
+	 * Grow the file to \c newSize bytes, allocating disk space.
+	 *
+	 * A sparse file is never used: writing a mapped page of one
+	 * when the disk is full raises SIGBUS instead of reporting an error.
+	 */
+	void extend(size_t newSize)
+	{
+		int stat = posix_fallocate(fd, (off_t) allocated, (off_t) (newSize - allocated));
+
+		if (stat == EINVAL || stat == EOPNOTSUPP)
+		{
+			throw IOException(LOG4CXX_STR("The file system cannot preallocate space for a memory mapped file"));
+		}
+
+		if (stat != 0)
+		{
+			throw IOException(stat);
+		}
+
+		allocated = newSize;
+	}
+
+	/**
+	 * Map the extent of the file that contains the offset \c position,
+	 * extending the file and moving the Trailer to its new end.
+	 */
+	void map(size_t position)
+	{
+		unmap();
+		size_t offset = position - position % pageSize;
+		size_t end = offset + extentSize;
+
+		if (allocated < end)
+		{
+			extend(end);
+		}
+
+		void* address = mmap(nullptr, end - offset, PROT_READ | PROT_WRITE, MAP_SHARED, fd, (off_t) offset);
+
+		if (address == MAP_FAILED)
+		{
+			throw IOException(errno);
+		}
+
+		region = static_cast<char*>(address);
+		regionOffset = offset;
+		regionLength = end - offset;
+
+		size_t previousTrailer = trailerOffset;
+		trailerOffset = end - TrailerSize;
+		std::memcpy(region + (trailerOffset - regionOffset), TrailerMagic, sizeof (TrailerMagic));
+		storeLength();
+
+		if (previousTrailer && previousTrailer != trailerOffset)
+		{
+			std::memset(region + (previousTrailer - regionOffset), 0, TrailerSize);
+		}
+	}
+
+	/**
+	 * Record \c length in the Trailer.
+	 */
+	void storeLength()
+	{
+		if (region && trailerOffset)
+		{
+			char* dest = region + (trailerOffset - regionOffset) + sizeof (TrailerMagic);
+
+			for (size_t i = 0; i < 8; ++i)
+			{
+				dest[i] = (char) ((uint64_t) length >> (8 * i));
+			}
+		}
+	}
+
+	void unmap()
+	{
+		if (region)
+		{
+			sync(length);
+			munmap(region, regionLength);
+			region = nullptr;
+			regionOffset = regionLength = 0;
+		}
+	}
+
+	/**
+	 * Request the mapped bytes before the offset \c end be written to disk.
+	 */
+	void sync(size_t end)
+	{
+		size_t begin = std::max(syncedLength, regionOffset);
+		end = std::min(end, regionOffset + regionLength);
+
+		if (region && begin < end)
+		{
+			if (msync(region + (begin - regionOffset), end - begin, MS_ASYNC) != 0)
+			{
+				throw IOException(errno);
+			}
+
+			syncedLength = end - end % pageSize;
+		}
+	}
+
+	/**
+	 * Release the mapping, remove preallocated space and close the file.
+	 */
+	apr_status_t close()
+	{
+		apr_status_t stat = APR_SUCCESS;
+
+		if (region)
+		{
+			msync(region, regionLength, MS_ASYNC);
+			munmap(region, regionLength);
+			region = nullptr;
+		}
+
+		if (length < allocated && ftruncate(fd, (off_t) length) != 0)
+		{
+			stat = errno;
+		}
+
+		trailerOffset = 0;
+
+		apr_status_t closeStat = apr_file_close(fileptr);
+		fileptr = nullptr;
+		fd = -1;
+		return stat != APR_SUCCESS ? stat : closeStat;
+	}
+#endif
+};
+
+IMPLEMENT_LOG4CXX_OBJECT(MappedFileOutputStream)
+
+MappedFileOutputStream::MappedFileOutputStream(const LogString& filename,
+	bool append, size_t extentSize)
+	: m_priv(std::make_unique<MappedFileOutputStreamPrivate>(extentSize))
+{
+#if LOG4CXX_HAS_MAPPED_FILES
+	m_priv->open(filename, append);
+#else
+	throw IOException(LOG4CXX_STR("Memory mapped files are not supported on this platform"));
+#endif
+}
+
+MappedFileOutputStream::~MappedFileOutputStream()
+{
+#if LOG4CXX_HAS_MAPPED_FILES
+	if (m_priv->fileptr != NULL && !APRInitializer::isDestructed)
+	{
+		m_priv->close();
+	}
+#endif
+}
+
+bool MappedFileOutputStream::isSupported()
+{
+	return LOG4CXX_HAS_MAPPED_FILES;
+}
+
+void MappedFileOutputStream::close(Pool& /* p */)
+{
+#if LOG4CXX_HAS_MAPPED_FILES
+	if (m_priv->fileptr != NULL)
+	{
+		apr_status_t stat = m_priv->close();
+
+		if (stat != APR_SUCCESS)
+		{
+			throw IOException(stat);
+		}
+	}
+#endif
+}
+
+void MappedFileOutputStream::flush(Pool& /* p */)
+{
+#if LOG4CXX_HAS_MAPPED_FILES
+	m_priv->storeLength();
+	m_priv->sync(m_priv->length - m_priv->length % m_priv->pageSize);
+#endif
+}
+
+void MappedFileOutputStream::write(ByteBuffer& buf, Pool& /* p */ )
+{
+	if (m_priv->fileptr == NULL)
+	{
+		throw IOException(-1);
+	}
+
+#if LOG4CXX_HAS_MAPPED_FILES
+	size_t nbytes = buf.remaining();
+	const char* data = buf.data() + buf.position();
+
+	while (0 < nbytes)
+	{
+		// The Trailer follows the writable part of the region
+		size_t regionEnd = m_priv->regionOffset + m_priv->regionLength;
+
+		if (regionEnd <= m_priv->length + TrailerSize)
+		{
+			m_priv->map(m_priv->length);
+			regionEnd = m_priv->regionOffset + m_priv->regionLength;
+		}
+
+		regionEnd -= TrailerSize;
+
+		size_t count = std::min(nbytes, regionEnd - m_priv->length);
+		std::memcpy(m_priv->region + (m_priv->length - m_priv->regionOffset), data, count);
+		m_priv->length += count;
+		data += count;
+		nbytes -= count;
+	}
+
+	buf.position(buf.limit());
+#endif
+}
+
+size_t MappedFileOutputStream::length() const
+{
+	return m_priv->length;
+}
+
+apr_file_t* MappedFileOutputStream::getFilePtr() const
+{
+	return m_priv->fileptr;
+}
@@ -19,6 +19,7 @@
 #include <log4cxx/pattern/messagepatternconverter.h>
 #include <log4cxx/spi/loggingevent.h>
 #include <log4cxx/spi/location/locationinfo.h>
+#include <log4cxx/helpers/transcoder.h>
 
 
 using namespace log4cxx;
@@ -85,3 +86,11 @@ void MessagePatternConverter::format
 	toAppendTo.append(event->getRenderedMessage());
 }
 
+void MessagePatternConverter::formatUTF8
+	( const spi::LoggingEventPtr& event
+	, std::string&                toAppendTo
+	, helpers::Pool&           /* p */
+	) const
+{
+	helpers::Transcoder::encodeUTF8(event->getRenderedMessage(), toAppendTo);
+}
@@ -537,6 +537,17 @@ void MultiprocessRollingFileAppender::subAppend(const LoggingEventPtr& event, Po
 	FileAppender::subAppend(event, p);
 }
 
+/**
+ * {@inheritDoc}
+*/
+void MultiprocessRollingFileAppender::subAppend(const LoggingEventList& events, Pool& p)
+{
+	for (auto& event : events)
+	{
+		subAppend(event, p);
+	}
+}
+
 /**
  * Get rolling policy.
  * @return rolling policy.
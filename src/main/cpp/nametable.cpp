@@ -0,0 +1,89 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <log4cxx/private/nametable.h>
+#include <unordered_map>
+#include <deque>
+#include <mutex>
+
+using namespace log4cxx;
+using namespace log4cxx::helpers;
+
+namespace
+{
+struct NameTableData
+{
+	std::mutex mutex;
+
+	/** Entries in identifier order. A deque keeps their addresses stable. */
+	std::deque<NameTable::Entry> entries;
+
+	std::unordered_map<LogString, const NameTable::Entry*> index;
+};
+
+NameTableData& getData()
+{
+	// Never destroyed, so entries outlive events released during termination
+	static NameTableData* data = new NameTableData;
+	return *data;
+}
+
+/**
+ * Recently used entries of the calling thread,
+ * keyed by the address of the string that was interned.
+ */
+struct CacheSlot
+{
+	const LogString* key;
+	const NameTable::Entry* entry;
+};
+
+enum { CacheSize = 16 };
+}
+
+const NameTable::Entry& NameTable::intern(const LogString& name)
+{
+	thread_local CacheSlot cache[CacheSize];
+	CacheSlot& slot = cache[(reinterpret_cast<uintptr_t>(&name) / sizeof(LogString)) % CacheSize];
+
+	// The string at an address may have changed, so compare its content
+	if (slot.key == &name && slot.entry->name == name)
+	{
+		return *slot.entry;
+	}
+
+	NameTableData& data = getData();
+	std::lock_guard<std::mutex> lock(data.mutex);
+	auto pItem = data.index.find(name);
+
+	if (pItem == data.index.end())
+	{
+		data.entries.emplace_back(name, static_cast<uint32_t>(data.entries.size()));
+		pItem = data.index.emplace(name, &data.entries.back()).first;
+	}
+
+	slot.key = &name;
+	slot.entry = pItem->second;
+	return *pItem->second;
+}
+
+const NameTable::Entry* NameTable::find(uint32_t id)
+{
+	NameTableData& data = getData();
+	std::lock_guard<std::mutex> lock(data.mutex);
+	return id < data.entries.size() ? &data.entries[id] : 0;
+}
@@ -21,6 +21,8 @@
 #include <log4cxx/helpers/charsetencoder.h>
 #include <log4cxx/helpers/bytebuffer.h>
 #include <log4cxx/helpers/stringhelper.h>
+#include <algorithm>
+#include <vector>
 
 using namespace log4cxx;
 using namespace log4cxx::helpers;
@@ -36,6 +38,14 @@ struct OutputStreamWriter::OutputStreamWriterPrivate{
 
 	OutputStreamPtr out;
 	CharsetEncoderPtr enc;
+
+	/**
+	 * Holds encoded text. Retains its capacity between calls to write,
+	 * so the owner must prevent concurrent writes.
+	 */
+	std::vector<char> buffer;
+
+	enum { MinBufferSize = 1024, MaxRetainedBufferSize = 128 * 1024 };
 };
 
 OutputStreamWriter::OutputStreamWriter(OutputStreamPtr& out1)
@@ -87,20 +97,17 @@ void OutputStreamWriter::write(const LogString& str, Pool& p)
 	}
 	else
 	{
-		enum { BUFSIZE = 1024 };
-		char stackData[BUFSIZE];
-		char* rawbuf = stackData;
-		size_t bufSize = BUFSIZE;
-#ifdef LOG4CXX_MULTI_PROCESS
-		std::vector<char> heapData;
-		// Ensure the logging event is a single write system call to keep events from each process separate
-		if (bufSize < str.length() * 2)
+		// Size the buffer for the whole event so that it
+		// is usually encoded and written in a single pass
+		size_t bufSize = std::max<size_t>(OutputStreamWriterPrivate::MinBufferSize, str.length() * 2);
+#ifndef LOG4CXX_MULTI_PROCESS
+		bufSize = std::min<size_t>(bufSize, OutputStreamWriterPrivate::MaxRetainedBufferSize);
+#endif
+		if (m_priv->buffer.size() < bufSize)
 		{
-			heapData.resize(bufSize = str.length() * 2);
-			rawbuf = heapData.data();
+			m_priv->buffer.resize(bufSize);
 		}
-#endif
-		ByteBuffer buf(rawbuf, bufSize);
+		ByteBuffer buf(m_priv->buffer.data(), m_priv->buffer.size());
 		m_priv->enc->reset();
 		LogString::const_iterator iter = str.begin();
 
@@ -116,6 +123,29 @@ void OutputStreamWriter::write(const LogString& str, Pool& p)
 		m_priv->enc->flush(buf);
 		buf.flip();
 		m_priv->out->write(buf, p);
+
+		if (OutputStreamWriterPrivate::MaxRetainedBufferSize < m_priv->buffer.size())
+		{
+			std::vector<char>().swap(m_priv->buffer);
+		}
+	}
+}
+
+bool OutputStreamWriter::isUTF8() const
+{
+	return CharsetEncoder::isUTF8(m_priv->enc);
+}
+
+void OutputStreamWriter::writeUTF8(const std::string& bytes, Pool& p)
+{
+	if (!isUTF8())
+	{
+		Writer::writeUTF8(bytes, p);
+	}
+	else if (!bytes.empty())
+	{
+		ByteBuffer buf(const_cast<char*>(bytes.data()), bytes.size());
+		m_priv->out->write(buf, p);
 	}
 }
 
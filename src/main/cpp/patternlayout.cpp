@@ -23,6 +23,9 @@
 #include <log4cxx/helpers/stringhelper.h>
 #include <log4cxx/helpers/pool.h>
 #include <log4cxx/helpers/optionconverter.h>
+#include <log4cxx/helpers/transcoder.h>
+#include <log4cxx/private/nametable.h>
+#include <climits>
 
 #include <log4cxx/pattern/loggerpatternconverter.h>
 #include <log4cxx/pattern/colorendpatternconverter.h>
@@ -59,10 +62,12 @@ struct PatternLayout::PatternLayoutPrivate
 {
 	PatternLayoutPrivate()
 		: expectedPatternLength(100)
+		, formatKey(0)
 		{}
 	PatternLayoutPrivate(const LogString& pattern)
 		: conversionPattern(pattern)
 		, expectedPatternLength(100)
+		, formatKey(0)
 		{}
 
 	/**
@@ -89,6 +94,116 @@ struct PatternLayout::PatternLayoutPrivate
 
 	// Expected length of a formatted event excluding the message text
 	size_t expectedPatternLength;
+
+	// Shared by layouts with the same pattern and colors
+	const void* formatKey;
+
+	/**
+	 * A step of the program compiled from the pattern converters.
+	 */
+	struct Instruction
+	{
+		enum Operation
+		{
+			AppendText,    // constant text with any field width applied
+			AppendMessage, // %m
+			AppendLevel,   // %p
+			AppendLogger,  // %c without precision
+			AppendThread,  // %t
+			Convert        // any other converter
+		};
+
+		Operation operation;
+
+		// The text of AppendText
+		LogString text;
+#if !LOG4CXX_LOGCHAR_IS_UTF8
+		std::string utf8Text;
+#endif
+
+		// The converter used by Convert
+		LoggingEventPatternConverterPtr converter;
+
+		// Null unless the field width is limited
+		FormattingInfoPtr field;
+	};
+
+	/**
+	 * The pattern converters as a sequence of steps
+	 * in which adjacent constant text is merged, unlimited field widths are skipped
+	 * and common converters are not called.
+	 */
+	std::vector<Instruction> program;
+
+	void compile()
+	{
+		program.clear();
+		Pool p;
+		std::vector<LogString> noOptions;
+		auto message = MessagePatternConverter::newInstance(noOptions);
+		auto level = LevelPatternConverter::newInstance(noOptions);
+		auto logger = LoggerPatternConverter::newInstance(noOptions);
+		auto thread = ThreadPatternConverter::newInstance(noOptions);
+		auto fieldIter = patternFields.begin();
+
+		for (auto& converter : patternConverters)
+		{
+			auto& field = *fieldIter++;
+			bool isConstant = &converter->getClass() == &LiteralPatternConverter::getStaticClass()
+				|| &converter->getClass() == &LineSeparatorPatternConverter::getStaticClass();
+
+			if (isConstant)
+			{
+				LogString text;
+				converter->format(LoggingEventPtr(), text, p);
+				field->format(0, text);
+
+				if (program.empty() || program.back().operation != Instruction::AppendText)
+				{
+					program.push_back(Instruction{Instruction::AppendText});
+				}
+				program.back().text.append(text);
+				continue;
+			}
+
+			Instruction step{Instruction::Convert};
+
+			if (converter == message)
+			{
+				step.operation = Instruction::AppendMessage;
+			}
+			else if (converter == level)
+			{
+				step.operation = Instruction::AppendLevel;
+			}
+			else if (converter == logger)
+			{
+				step.operation = Instruction::AppendLogger;
+			}
+			else if (converter == thread)
+			{
+				step.operation = Instruction::AppendThread;
+			}
+			else
+			{
+				step.converter = converter;
+			}
+
+			if (0 < field->getMinLength() || field->getMaxLength() < INT_MAX)
+			{
+				step.field = field;
+			}
+
+			program.push_back(step);
+		}
+
+#if !LOG4CXX_LOGCHAR_IS_UTF8
+		for (auto& step : program)
+		{
+			Transcoder::encodeUTF8(step.text, step.utf8Text);
+		}
+#endif
+	}
 };
 
 IMPLEMENT_LOG4CXX_OBJECT(PatternLayout)
@@ -122,20 +237,94 @@ void PatternLayout::format(LogString& output,
 	const spi::LoggingEventPtr& event,
 	Pool& pool) const
 {
-	output.reserve(m_priv->expectedPatternLength + event->getMessage().size());
-	std::vector<FormattingInfoPtr>::const_iterator formatterIter =
-		m_priv->patternFields.begin();
-
-	for (std::vector<LoggingEventPatternConverterPtr>::const_iterator
-		converterIter = m_priv->patternConverters.begin();
-		converterIter != m_priv->patternConverters.end();
-		converterIter++, formatterIter++)
+	typedef PatternLayoutPrivate::Instruction Instruction;
+	output.reserve(output.size() + m_priv->expectedPatternLength + event->getMessage().size());
+
+	for (auto& step : m_priv->program)
 	{
 		int startField = (int)output.length();
-		(*converterIter)->format(event, output, pool);
-		(*formatterIter)->format(startField, output);
+
+		switch (step.operation)
+		{
+			case Instruction::AppendText:
+				output.append(step.text);
+				break;
+
+			case Instruction::AppendMessage:
+				output.append(event->getRenderedMessage());
+				break;
+
+			case Instruction::AppendLevel:
+				output.append(event->getLevel()->getName());
+				break;
+
+			case Instruction::AppendLogger:
+				output.append(event->getLoggerName());
+				break;
+
+			case Instruction::AppendThread:
+				output.append(event->getThreadName());
+				break;
+
+			default:
+				step.converter->format(event, output, pool);
+				break;
+		}
+
+		if (step.field)
+		{
+			step.field->format(startField, output);
+		}
 	}
+}
+
+void PatternLayout::formatUTF8(std::string& output,
+	const spi::LoggingEventPtr& event,
+	Pool& pool) const
+{
+#if LOG4CXX_LOGCHAR_IS_UTF8
+	format(output, event, pool);
+#else
+	typedef PatternLayoutPrivate::Instruction Instruction;
+	output.reserve(output.size() + m_priv->expectedPatternLength + event->getMessage().size());
+
+	for (auto& step : m_priv->program)
+	{
+		int startField = (int)output.length();
+
+		switch (step.operation)
+		{
+			case Instruction::AppendText:
+				output.append(step.utf8Text);
+				break;
+
+			case Instruction::AppendMessage:
+				Transcoder::encodeUTF8(event->getRenderedMessage(), output);
+				break;
+
+			case Instruction::AppendLevel:
+				Transcoder::encodeUTF8(event->getLevel()->getName(), output);
+				break;
+
+			case Instruction::AppendLogger:
+				Transcoder::encodeUTF8(event->getLoggerName(), output);
+				break;
 
+			case Instruction::AppendThread:
+				Transcoder::encodeUTF8(event->getThreadName(), output);
+				break;
+
+			default:
+				step.converter->formatUTF8(event, output, pool);
+				break;
+		}
+
+		if (step.field)
+		{
+			step.field->formatUTF8(startField, output);
+		}
+	}
+#endif
 }
 
 void PatternLayout::setOption(const LogString& option, const LogString& value)
@@ -207,7 +396,28 @@ void PatternLayout::activateOptions(Pool&)
 			m_priv->patternConverters.push_back(eventConverter);
 		}
 	}
+	m_priv->compile();
 	m_priv->expectedPatternLength = getFormattedEventCharacterCount() * 2;
+
+	LogString key(pat);
+	for (auto color : { &m_priv->m_fatalColor, &m_priv->m_errorColor, &m_priv->m_warnColor
+		, &m_priv->m_infoColor, &m_priv->m_debugColor, &m_priv->m_traceColor })
+	{
+		key.append(1, 0);
+		key.append(*color);
+	}
+	m_priv->formatKey = &NameTable::intern(key);
+}
+
+const void* PatternLayout::getFormatKey() const
+{
+	// A derived class may produce different output from the same pattern
+	if (&getClass() != &PatternLayout::getStaticClass())
+	{
+		return 0;
+	}
+
+	return m_priv->formatKey;
 }
 
 #define RULES_PUT(spec, cls) \
@@ -381,7 +381,7 @@ bool RollingFileAppender::rolloverInternal(Pool& p)
 							setFileInternal(rollover1->getActiveFileName());
 							// Call activateOptions to create any intermediate directories(if required)
 							FileAppender::activateOptionsInternal(p);
-							OutputStreamPtr os(new FileOutputStream(
+							OutputStreamPtr os(createOutputStream(
 									rollover1->getActiveFileName(), rollover1->getAppend()));
 							WriterPtr newWriter(createWriter(os));
 							setWriterInternal(newWriter);
@@ -458,27 +458,69 @@ void RollingFileAppender::subAppend(const LoggingEventPtr& event, Pool& p)
 		_priv->triggeringPolicy->isTriggeringEvent(
 			this, event, getFile(), getFileLength()))
 	{
-		//
-		//   wrap rollover request in try block since
-		//    rollover may fail in case read access to directory
-		//    is not provided.  However appender should still be in good
-		//     condition and the append should still happen.
-		try
-		{
-			_priv->_event = event;
-			rolloverInternal(p);
-		}
-		catch (std::exception& ex)
+		rolloverBefore(event, p);
+	}
+
+	FileAppender::subAppend(event, p);
+}
+
+/**
+ * {@inheritDoc}
+*/
+void RollingFileAppender::subAppend(const LoggingEventList& events, Pool& p)
+{
+	size_t start = 0;
+
+	for (size_t index = 0; index < events.size(); ++index)
+	{
+		auto& event = events[index];
+
+		if (_priv->triggeringPolicy->isTriggeringEvent(
+				this, event, getFile(), getFileLength()))
 		{
-			LOG4CXX_DECODE_CHAR(lsMsg, ex.what());
-			LogString errorMsg = LOG4CXX_STR("Exception during rollover attempt: ");
-			errorMsg.append(lsMsg);
-			LogLog::warn(errorMsg);
-			_priv->errorHandler->error(lsMsg);
+			if (start < index)
+			{
+				FileAppender::subAppend(LoggingEventList(events.begin() + start, events.begin() + index), p);
+			}
+
+			rolloverBefore(event, p);
+			start = index;
 		}
 	}
 
-	FileAppender::subAppend(event, p);
+	if (start == 0)
+	{
+		FileAppender::subAppend(events, p);
+	}
+	else
+	{
+		FileAppender::subAppend(LoggingEventList(events.begin() + start, events.end()), p);
+	}
+}
+
+/**
+ * Roll over because of \c event, which is written to the new file.
+*/
+void RollingFileAppender::rolloverBefore(const LoggingEventPtr& event, Pool& p)
+{
+	//
+	//   wrap rollover request in try block since
+	//    rollover may fail in case read access to directory
+	//    is not provided.  However appender should still be in good
+	//     condition and the append should still happen.
+	try
+	{
+		_priv->_event = event;
+		rolloverInternal(p);
+	}
+	catch (std::exception& ex)
+	{
+		LOG4CXX_DECODE_CHAR(lsMsg, ex.what());
+		LogString errorMsg = LOG4CXX_STR("Exception during rollover attempt: ");
+		errorMsg.append(lsMsg);
+		LogLog::warn(errorMsg);
+		_priv->errorHandler->error(lsMsg);
+	}
 }
 
 /**
@@ -796,9 +796,59 @@ void SimpleDateFormat::parsePattern( const LogString& fmt, const std::locale* lo
 }
 
 
+namespace
+{
+
+/**
+ * The characters of the numbers 00 to 99.
+ */
+struct DigitPairs
+{
+	logchar text[200];
+
+	constexpr DigitPairs() : text()
+	{
+		for (int i = 0; i < 100; ++i)
+		{
+			text[2 * i] = logchar(0x30 + i / 10);
+			text[2 * i + 1] = logchar(0x30 + i % 10);
+		}
+	}
+};
+
+constexpr DigitPairs digitPairs;
+
+logchar* putTwoDigits(logchar* p, int n)
+{
+	p[0] = digitPairs.text[2 * n];
+	p[1] = digitPairs.text[2 * n + 1];
+	return p + 2;
+}
+
+logchar* putThreeDigits(logchar* p, int n)
+{
+	*p++ = logchar(0x30 + n / 100);
+	return putTwoDigits(p, n % 100);
+}
+
+logchar* putTime(logchar* p, const apr_time_exp_t& tm)
+{
+	p = putTwoDigits(p, tm.tm_hour);
+	*p++ = 0x3A; // ':'
+	p = putTwoDigits(p, tm.tm_min);
+	*p++ = 0x3A; // ':'
+	p = putTwoDigits(p, tm.tm_sec);
+	*p++ = 0x2C; // ','
+	return putThreeDigits(p, tm.tm_usec / 1000);
+}
+
+} // namespace
+
 struct SimpleDateFormat::SimpleDateFormatPrivate{
 	SimpleDateFormatPrivate() :
-		timeZone(TimeZone::getDefault())
+		timeZone(TimeZone::getDefault()),
+		fixedFormat(Tokens),
+		monthName(0)
 	{}
 
 	/**
@@ -810,6 +860,84 @@ struct SimpleDateFormat::SimpleDateFormatPrivate{
 	 * List of tokens.
 	 */
 	PatternTokenList pattern;
+
+	/**
+	 * Patterns formatted without the token list.
+	 */
+	enum FixedFormat
+	{
+		Tokens,   // not a fixed format
+		ISO8601,  // yyyy-MM-dd HH:mm:ss,SSS
+		Absolute, // HH:mm:ss,SSS
+		DateTime  // dd MMM yyyy HH:mm:ss,SSS
+	};
+	FixedFormat fixedFormat;
+
+	/**
+	 * The MMM token of DateTime.
+	 */
+	const PatternToken* monthName;
+
+	void setFixedFormat(const LogString& fmt)
+	{
+		if (fmt == LOG4CXX_STR("yyyy-MM-dd HH:mm:ss,SSS"))
+		{
+			fixedFormat = ISO8601;
+		}
+		else if (fmt == LOG4CXX_STR("HH:mm:ss,SSS"))
+		{
+			fixedFormat = Absolute;
+		}
+		else if (fmt == LOG4CXX_STR("dd MMM yyyy HH:mm:ss,SSS"))
+		{
+			fixedFormat = DateTime;
+			monthName = pattern[2];
+		}
+	}
+
+	/**
+	 * Append \c tm in a fixed format using a table of digits.
+	 * @return false if the year is not four digits.
+	 */
+	bool formatFixed(LogString& s, const apr_time_exp_t& tm, Pool& p) const
+	{
+		int year = tm.tm_year + 1900;
+
+		if (year < 0 || 9999 < year)
+		{
+			return false;
+		}
+
+		logchar buf[32];
+		logchar* end = buf;
+
+		if (fixedFormat == ISO8601)
+		{
+			end = putTwoDigits(end, year / 100);
+			end = putTwoDigits(end, year % 100);
+			*end++ = 0x2D; // '-'
+			end = putTwoDigits(end, tm.tm_mon + 1);
+			*end++ = 0x2D; // '-'
+			end = putTwoDigits(end, tm.tm_mday);
+			*end++ = 0x20; // ' '
+		}
+		else if (fixedFormat == DateTime)
+		{
+			end = putTwoDigits(end, tm.tm_mday);
+			*end++ = 0x20; // ' '
+			s.append(buf, end - buf);
+			monthName->format(s, tm, p);
+			end = buf;
+			*end++ = 0x20; // ' '
+			end = putTwoDigits(end, year / 100);
+			end = putTwoDigits(end, year % 100);
+			*end++ = 0x20; // ' '
+		}
+
+		end = putTime(end, tm);
+		s.append(buf, end - buf);
+		return true;
+	}
 };
 
 SimpleDateFormat::SimpleDateFormat( const LogString& fmt ) : m_priv(std::make_unique<SimpleDateFormatPrivate>())
@@ -820,6 +948,7 @@ SimpleDateFormat::SimpleDateFormat( const LogString& fmt ) : m_priv(std::make_un
 #else
 	parsePattern( fmt, NULL, m_priv->pattern );
 #endif
+	m_priv->setFixedFormat(fmt);
 
 	for ( PatternTokenList::iterator iter = m_priv->pattern.begin(); iter != m_priv->pattern.end(); iter++ )
 	{
@@ -830,6 +959,7 @@ SimpleDateFormat::SimpleDateFormat( const LogString& fmt ) : m_priv(std::make_un
 SimpleDateFormat::SimpleDateFormat( const LogString& fmt, const std::locale* locale ) : m_priv(std::make_unique<SimpleDateFormatPrivate>())
 {
 	parsePattern( fmt, locale, m_priv->pattern );
+	m_priv->setFixedFormat(fmt);
 
 	for ( PatternTokenList::iterator iter = m_priv->pattern.begin(); iter != m_priv->pattern.end(); iter++ )
 	{
@@ -854,6 +984,11 @@ void SimpleDateFormat::format( LogString& s, log4cxx_time_t time, Pool& p ) cons
 
 	if ( stat == APR_SUCCESS )
 	{
+		if (m_priv->fixedFormat != SimpleDateFormatPrivate::Tokens && m_priv->formatFixed(s, exploded, p))
+		{
+			return;
+		}
+
 		for ( PatternTokenList::const_iterator iter = m_priv->pattern.begin(); iter != m_priv->pattern.end(); iter++ )
 		{
 			( * iter )->format( s, exploded, p );
@@ -30,7 +30,7 @@ void SimpleLayout::format(LogString& output,
 	const spi::LoggingEventPtr& event,
 	log4cxx::helpers::Pool&) const
 {
-	output.append(event->getLevel()->toString());
+	output.append(event->getLevel()->getName());
 	output.append(LOG4CXX_STR(" - "));
 	output.append(event->getRenderedMessage());
 	output.append(LOG4CXX_EOL);
@@ -19,6 +19,7 @@
 #include <log4cxx/pattern/threadpatternconverter.h>
 #include <log4cxx/spi/loggingevent.h>
 #include <log4cxx/spi/location/locationinfo.h>
+#include <log4cxx/helpers/transcoder.h>
 
 using namespace log4cxx;
 using namespace log4cxx::pattern;
@@ -48,3 +49,10 @@ void ThreadPatternConverter::format(
 	toAppendTo.append(event->getThreadName());
 }
 
+void ThreadPatternConverter::formatUTF8(
+	const LoggingEventPtr& event,
+	std::string& toAppendTo,
+	Pool& /* p */) const
+{
+	Transcoder::encodeUTF8(event->getThreadName(), toAppendTo);
+}
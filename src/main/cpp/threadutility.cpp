@@ -25,6 +25,9 @@
 
 #include <signal.h>
 #include <mutex>
+#include <condition_variable>
+#include <algorithm>
+#include <vector>
 
 #if WIN32
 	#include <windows.h>
@@ -48,8 +51,77 @@ struct ThreadUtility::priv_data
 	ThreadStartPre start_pre;
 	ThreadStarted started;
 	ThreadStartPost start_post;
+
+	struct PeriodicTask
+	{
+		LogString name;
+		std::function<void()> f;
+		Period delay;
+		std::chrono::steady_clock::time_point nextRun;
+	};
+	using TaskList = std::vector<PeriodicTask>;
+
+	std::mutex job_mutex;
+	std::condition_variable interrupt;
+	TaskList jobs;
+	LogString runningTask;
+	std::thread thread;
+	bool threadActive = false;
+
+	TaskList::iterator findTask(const LogString& name)
+	{
+		return std::find_if(jobs.begin(), jobs.end(),
+			[&name](const PeriodicTask& task) { return task.name == name; });
+	}
+
+	void doPeriodicTasks();
 };
 
+/**
+ * Run each task when it is due until no tasks remain.
+ */
+void ThreadUtility::priv_data::doPeriodicTasks()
+{
+	std::unique_lock<std::mutex> lock(job_mutex);
+
+	while (!jobs.empty())
+	{
+		auto next = std::min_element(jobs.begin(), jobs.end(),
+			[](const PeriodicTask& lhs, const PeriodicTask& rhs) { return lhs.nextRun < rhs.nextRun; });
+		auto now = std::chrono::steady_clock::now();
+
+		if (now < next->nextRun)
+		{
+			interrupt.wait_until(lock, next->nextRun);
+			continue;
+		}
+
+		next->nextRun = now + next->delay;
+		auto f = next->f;
+		auto name = next->name;
+		runningTask = name;
+		lock.unlock();
+
+		try
+		{
+			f();
+		}
+		catch (std::exception& ex)
+		{
+			LogLog::warn(name, ex);
+		}
+
+		lock.lock();
+		runningTask.clear();
+		interrupt.notify_all();
+	}
+
+	threadActive = false;
+}
+
+// Appenders destroyed after the ThreadUtility singleton must not use it
+static bool periodicTasksStopped = false;
+
 #if LOG4CXX_HAS_PTHREAD_SIGMASK
 	static thread_local sigset_t old_mask;
 	static thread_local bool sigmask_valid;
@@ -64,7 +136,11 @@ ThreadUtility::ThreadUtility() :
 		std::bind( &ThreadUtility::postThreadUnblockSignals, this ) );
 }
 
-ThreadUtility::~ThreadUtility() {}
+ThreadUtility::~ThreadUtility()
+{
+	removeAllPeriodicTasks();
+	periodicTasksStopped = true;
+}
 
 ThreadUtility* ThreadUtility::instance()
 {
@@ -198,5 +274,99 @@ ThreadStartPost ThreadUtility::postStartFunction()
 	return m_priv->start_post;
 }
 
+void ThreadUtility::addPeriodicTask(const LogString& name, std::function<void()> f, const Period& delay)
+{
+	if (periodicTasksStopped)
+	{
+		return;
+	}
+
+	std::lock_guard<std::mutex> lock(m_priv->job_mutex);
+	auto nextRun = std::chrono::steady_clock::now() + delay;
+	auto pTask = m_priv->findTask(name);
+
+	if (pTask != m_priv->jobs.end())
+	{
+		pTask->f = f;
+		pTask->delay = delay;
+		pTask->nextRun = nextRun;
+	}
+	else
+	{
+		m_priv->jobs.push_back(priv_data::PeriodicTask{name, f, delay, nextRun});
+	}
+
+	if (!m_priv->threadActive)
+	{
+		if (m_priv->thread.joinable())
+		{
+			m_priv->thread.join();
+		}
+
+		m_priv->threadActive = true;
+		m_priv->thread = createThread(LOG4CXX_STR("log4cxx"), &priv_data::doPeriodicTasks, m_priv.get());
+	}
+
+	m_priv->interrupt.notify_all();
+}
+
+bool ThreadUtility::hasPeriodicTask(const LogString& name)
+{
+	if (periodicTasksStopped)
+	{
+		return false;
+	}
+
+	std::lock_guard<std::mutex> lock(m_priv->job_mutex);
+	return m_priv->findTask(name) != m_priv->jobs.end();
+}
+
+void ThreadUtility::removePeriodicTask(const LogString& name)
+{
+	if (periodicTasksStopped)
+	{
+		return;
+	}
+
+	std::unique_lock<std::mutex> lock(m_priv->job_mutex);
+	auto pTask = m_priv->findTask(name);
+
+	if (pTask != m_priv->jobs.end())
+	{
+		m_priv->jobs.erase(pTask);
+		m_priv->interrupt.notify_all();
+	}
+
+	if (std::this_thread::get_id() != m_priv->thread.get_id())
+	{
+		m_priv->interrupt.wait(lock, [this, &name] { return m_priv->runningTask != name; });
+	}
+}
+
+void ThreadUtility::removeAllPeriodicTasks()
+{
+	if (periodicTasksStopped)
+	{
+		return;
+	}
+
+	std::thread stopped;
+	{
+		std::lock_guard<std::mutex> lock(m_priv->job_mutex);
+		m_priv->jobs.clear();
+		m_priv->interrupt.notify_all();
+
+		if (m_priv->thread.joinable() && std::this_thread::get_id() != m_priv->thread.get_id())
+		{
+			stopped = std::move(m_priv->thread);
+		}
+	}
+
+	if (stopped.joinable())
+	{
+		stopped.join();
+	}
+}
+
 } //namespace helpers
 } //namespace log4cxx
@@ -19,6 +19,7 @@
 #include <log4cxx/logstring.h>
 #include <log4cxx/helpers/timezone.h>
 #include <stdlib.h>
+#include <time.h>
 
 #include <apr_time.h>
 #include <apr_pools.h>
@@ -27,6 +28,7 @@
 #include <log4cxx/helpers/stringhelper.h>
 #include <log4cxx/helpers/pool.h>
 #include <log4cxx/logger.h>
+#include <log4cxx/private/atomic_shared_ptr.h>
 
 using namespace log4cxx;
 using namespace log4cxx::helpers;
@@ -78,7 +80,7 @@ class GMTTimeZone : public TimeZone
 
 
 
-/** Time zone object that represents GMT. */
+/** Time zone object that represents the local time zone. */
 class LocalTimeZone : public TimeZone
 {
 	public:
@@ -89,9 +91,39 @@ class LocalTimeZone : public TimeZone
 			return tz;
 		}
 
-		/** Explode time to human readable form. */
+		/**
+		 * Explode time to human readable form.
+		 *
+		 * The UTC offset is cached along with the period in which it applies,
+		 * which ends at the next daylight saving transition (or a day later),
+		 * so within that period the time is exploded arithmetically
+		 * without calling the C library.
+		 * The cached offset is discarded when tzset() changes the C library's zone.
+		 */
 		log4cxx_status_t explode( apr_time_exp_t* result, log4cxx_time_t input ) const
 		{
+			if (0 <= input)
+			{
+				auto pWindow = window.load();
+				auto rules = getZoneRules();
+
+				if (!pWindow || input < pWindow->begin || pWindow->end <= input || !(pWindow->rules == rules))
+				{
+					pWindow = findWindow(input, rules);
+
+					if (pWindow)
+					{
+						window.store(pWindow);
+					}
+				}
+
+				if (pWindow)
+				{
+					explodeLocal(result, input, *pWindow);
+					return APR_SUCCESS;
+				}
+			}
+
 			apr_status_t stat;
 
 			//  APR 1.1 and early mishandles microseconds on dates
@@ -116,6 +148,164 @@ class LocalTimeZone : public TimeZone
 		}
 
 	private:
+		/** The C library's time zone, as last set by tzset(). */
+		struct ZoneRules
+		{
+			const char* standardName;
+			const char* daylightName;
+			long offset;
+
+			bool operator==(const ZoneRules& other) const
+			{
+				return standardName == other.standardName
+					&& daylightName == other.daylightName
+					&& offset == other.offset;
+			}
+		};
+
+		static ZoneRules getZoneRules()
+		{
+			ZoneRules result;
+#if defined(_WIN32)
+			result.standardName = _tzname[0];
+			result.daylightName = _tzname[1];
+			result.offset = _timezone;
+#else
+			result.standardName = tzname[0];
+			result.daylightName = tzname[1];
+#if defined(__GLIBC__) || defined(__APPLE__)
+			result.offset = timezone;
+#else
+			result.offset = 0;
+#endif
+#endif
+			return result;
+		}
+
+		/** A period in which the UTC offset does not change. */
+		struct OffsetWindow
+		{
+			log4cxx_time_t begin;
+			log4cxx_time_t end;
+			apr_int32_t gmtoff;
+			apr_int32_t isdst;
+			ZoneRules rules;
+		};
+		using OffsetWindowPtr = std::shared_ptr<const OffsetWindow>;
+
+		/** The period that contains the most recently exploded time. */
+		mutable AtomicSharedPtr<const OffsetWindow> window;
+
+		/** Does the C library apply \c gmtoff and \c isdst at \c time? */
+		static bool hasOffset(log4cxx_time_t time, apr_int32_t gmtoff, apr_int32_t isdst)
+		{
+			apr_time_exp_t exploded;
+			return apr_time_exp_lt(&exploded, time) == APR_SUCCESS
+				&& exploded.tm_gmtoff == gmtoff
+				&& exploded.tm_isdst == isdst;
+		}
+
+		/**
+		 * The whole second nearest to \c different that has the offset at \c same,
+		 * where the offset at \c different is not the same.
+		 */
+		static log4cxx_time_t lastSame(log4cxx_time_t same, log4cxx_time_t different, apr_int32_t gmtoff, apr_int32_t isdst)
+		{
+			same = apr_time_sec(same) * APR_USEC_PER_SEC;
+			different = apr_time_sec(different) * APR_USEC_PER_SEC;
+
+			while (APR_USEC_PER_SEC < (same < different ? different - same : same - different))
+			{
+				auto middle = apr_time_sec(same + (different - same) / 2) * APR_USEC_PER_SEC;
+
+				if (hasOffset(middle, gmtoff, isdst))
+				{
+					same = middle;
+				}
+				else
+				{
+					different = middle;
+				}
+			}
+
+			return same;
+		}
+
+		/** Find the period (of at most two days) that contains \c input under \c rules. */
+		static OffsetWindowPtr findWindow(log4cxx_time_t input, const ZoneRules& rules)
+		{
+			const log4cxx_time_t oneDay = APR_INT64_C(86400) * APR_USEC_PER_SEC;
+			apr_time_exp_t exploded;
+
+			if (apr_time_exp_lt(&exploded, input) != APR_SUCCESS)
+			{
+				return OffsetWindowPtr();
+			}
+
+			auto result = std::make_shared<OffsetWindow>();
+			result->gmtoff = exploded.tm_gmtoff;
+			result->isdst = exploded.tm_isdst;
+			result->rules = rules;
+
+			result->end = input + oneDay;
+
+			if (!hasOffset(result->end, result->gmtoff, result->isdst))
+			{
+				result->end = lastSame(input, result->end, result->gmtoff, result->isdst) + APR_USEC_PER_SEC;
+			}
+
+			result->begin = input < oneDay ? 0 : input - oneDay;
+
+			if (!hasOffset(result->begin, result->gmtoff, result->isdst))
+			{
+				result->begin = lastSame(input, result->begin, result->gmtoff, result->isdst);
+			}
+
+			return result;
+		}
+
+		/** Explode \c input using the offset that applies in \c w. */
+		static void explodeLocal(apr_time_exp_t* result, log4cxx_time_t input, const OffsetWindow& w)
+		{
+			static const int daysBeforeMonth[] =
+				{ 0, 31, 59, 90, 120, 151, 181, 212, 243, 273, 304, 334 };
+			const log4cxx_time_t secondsPerDay = 86400;
+			log4cxx_time_t seconds = apr_time_sec(input) + w.gmtoff;
+			log4cxx_time_t days = seconds / secondsPerDay;
+			log4cxx_time_t secondOfDay = seconds % secondsPerDay;
+
+			if (secondOfDay < 0)
+			{
+				secondOfDay += secondsPerDay;
+				--days;
+			}
+
+			result->tm_usec = (apr_int32_t) apr_time_usec(input);
+			result->tm_sec = (apr_int32_t) (secondOfDay % 60);
+			result->tm_min = (apr_int32_t) (secondOfDay / 60 % 60);
+			result->tm_hour = (apr_int32_t) (secondOfDay / 3600);
+			result->tm_wday = (apr_int32_t) ((days % 7 + 11) % 7); // 01.01.1970 was a Thursday
+
+			// Convert days since 01.01.1970 to a civil date (H. Hinnant's algorithm)
+			log4cxx_time_t z = days + 719468;
+			log4cxx_time_t era = (0 <= z ? z : z - 146096) / 146097;
+			log4cxx_time_t dayOfEra = z - era * 146097;
+			log4cxx_time_t yearOfEra = (dayOfEra - dayOfEra / 1460 + dayOfEra / 36524 - dayOfEra / 146096) / 365;
+			log4cxx_time_t dayOfYear = dayOfEra - (365 * yearOfEra + yearOfEra / 4 - yearOfEra / 100);
+			log4cxx_time_t mp = (5 * dayOfYear + 2) / 153;
+			int mday = (int) (dayOfYear - (153 * mp + 2) / 5 + 1);
+			int month = (int) (mp < 10 ? mp + 3 : mp - 9);
+			log4cxx_time_t year = yearOfEra + era * 400 + (month <= 2 ? 1 : 0);
+			bool isLeap = (year % 4 == 0 && year % 100 != 0) || year % 400 == 0;
+
+			result->tm_mday = mday;
+			result->tm_mon = month - 1;
+			result->tm_year = (apr_int32_t) (year - 1900);
+			result->tm_yday = daysBeforeMonth[month - 1] + mday - 1 + (isLeap && 2 < month ? 1 : 0);
+			result->tm_isdst = w.isdst;
+			result->tm_gmtoff = w.gmtoff;
+		}
+
 		static const LogString getTimeZoneName()
 		{
 			const int MAX_TZ_LENGTH = 255;
@@ -31,6 +31,7 @@
 	#define LOG4CXX 1
 #endif
 #include <log4cxx/private/log4cxx_private.h>
+#include <log4cxx/private/asciirun.h>
 
 #if LOG4CXX_CFSTRING_API
 	#include <CoreFoundation/CFString.h>
@@ -46,6 +47,12 @@ void Transcoder::decodeUTF8(const std::string& src, LogString& dst)
 
 	while (iter != src.end())
 	{
+		if (((unsigned char) *iter) < 0x80)
+		{
+			iter += AsciiRun::append(dst, &*iter, src.end() - iter);
+			continue;
+		}
+
 		unsigned int sv = decode(src, iter);
 
 		if (sv != 0xFFFF)
@@ -69,6 +76,12 @@ void Transcoder::encodeUTF8(const LogString& src, std::string& dst)
 
 	while (iter != src.end())
 	{
+		if (((unsigned int) *iter) < 0x80)
+		{
+			iter += AsciiRun::append(dst, &*iter, src.end() - iter);
+			continue;
+		}
+
 		unsigned int sv = decode(src, iter);
 
 		if (sv != 0xFFFF)
@@ -320,14 +333,7 @@ void Transcoder::decode(const std::string& src, LogString& dst)
 	dst.reserve(dst.size() + src.size());
 	std::string::const_iterator iter = src.begin();
 #if !LOG4CXX_CHARSET_EBCDIC
-
-	for (;
-		iter != src.end() && ((unsigned char) *iter) < 0x80;
-		iter++)
-	{
-		dst.append(1, *iter);
-	}
-
+	iter += AsciiRun::append(dst, src.data(), src.size());
 #endif
 
 	if (iter != src.end())
@@ -374,14 +380,7 @@ void Transcoder::encode(const LogString& src, std::string& dst)
 	dst.reserve(dst.size() + src.size());
 	LogString::const_iterator iter = src.begin();
 #if !LOG4CXX_CHARSET_EBCDIC
-
-	for (;
-		iter != src.end() && ((unsigned int) *iter) < 0x80;
-		iter++)
-	{
-		dst.append(1, *iter);
-	}
-
+	iter += AsciiRun::append(dst, src.data(), src.size());
 #endif
 
 	if (iter != src.end())
@@ -488,6 +487,12 @@ void Transcoder::decode(const std::wstring& src, LogString& dst)
 
 	while (i != src.end())
 	{
+		if (((unsigned int) *i) < 0x80)
+		{
+			i += AsciiRun::append(dst, &*i, src.end() - i);
+			continue;
+		}
+
 		unsigned int cp = decode(src, i);
 
 		if (cp != 0xFFFF)
@@ -512,6 +517,12 @@ void Transcoder::encode(const LogString& src, std::wstring& dst)
 
 	for (LogString::const_iterator i = src.begin(); i != src.end();)
 	{
+		if (((unsigned int) *i) < 0x80)
+		{
+			i += AsciiRun::append(dst, &*i, src.end() - i);
+			continue;
+		}
+
 		unsigned int cp = Transcoder::decode(src, i);
 
 		if (cp != 0xFFFF)
@@ -586,6 +597,12 @@ void Transcoder::decode(const std::basic_string<UniChar>& src, LogString& dst)
 	for (std::basic_string<UniChar>::const_iterator i = src.begin();
 		i != src.end();)
 	{
+		if (*i < 0x80)
+		{
+			i += AsciiRun::append(dst, &*i, src.end() - i);
+			continue;
+		}
+
 		unsigned int cp = decode(src, i);
 		encode(cp, dst);
 	}
@@ -602,6 +619,12 @@ void Transcoder::encode(const LogString& src, std::basic_string<UniChar>& dst)
 	for (LogString::const_iterator i = src.begin();
 		i != src.end();)
 	{
+		if (((unsigned int) *i) < 0x80)
+		{
+			i += AsciiRun::append(dst, &*i, src.end() - i);
+			continue;
+		}
+
 		unsigned int cp = decode(src, i);
 		encode(cp, dst);
 	}
@@ -18,6 +18,7 @@
 #include <log4cxx/logstring.h>
 #include <log4cxx/helpers/writer.h>
 #include <log4cxx/helpers/loglog.h>
+#include <log4cxx/helpers/transcoder.h>
 #include <stdexcept>
 
 using namespace log4cxx::helpers;
@@ -31,3 +32,15 @@ Writer::Writer()
 Writer::~Writer()
 {
 }
+
+bool Writer::isUTF8() const
+{
+	return false;
+}
+
+void Writer::writeUTF8(const std::string& bytes, Pool& p)
+{
+	LogString text;
+	Transcoder::decodeUTF8(bytes, text);
+	write(text, p);
+}
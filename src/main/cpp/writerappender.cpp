@@ -99,6 +99,23 @@ void WriterAppender::append(const spi::LoggingEventPtr& event, Pool& pool1)
 	subAppend(event, pool1);
 }
 
+void WriterAppender::append(const spi::LoggingEventList& events, Pool& pool1)
+{
+	// A derived class may have changed how each event is appended
+	if (!isGroupWritable())
+	{
+		AppenderSkeleton::append(events, pool1);
+		return;
+	}
+
+	if (!checkEntryConditions())
+	{
+		return;
+	}
+
+	subAppend(events, pool1);
+}
+
 /**
    This method determines if there is a sense in attempting to append.
 
@@ -252,8 +269,80 @@ void WriterAppender::setEncoding(const LogString& enc)
 
 void WriterAppender::subAppend(const spi::LoggingEventPtr& event, Pool& p)
 {
-	LogString msg;
-	_priv->layout->format(msg, event, p);
+#if !LOG4CXX_LOGCHAR_IS_UTF8
+	// Avoid encoding the formatted event
+	if (_priv->writer != NULL && _priv->writer->isUTF8())
+	{
+		auto& bytes = _priv->clearBuffer(_priv->byteBuffer);
+		_priv->formatUTF8(bytes, event, p);
+		_priv->writer->writeUTF8(bytes, p);
+
+		if (_priv->immediateFlush)
+		{
+			_priv->writer->flush(p);
+		}
+
+		return;
+	}
+#endif
+	auto& msg = _priv->clearBuffer(_priv->buffer);
+	_priv->layout->formatShared(msg, event, p);
+
+	if (_priv->writer != NULL)
+	{
+		_priv->writer->write(msg, p);
+
+		if (_priv->immediateFlush)
+		{
+			_priv->writer->flush(p);
+		}
+	}
+}
+
+
+bool WriterAppender::isGroupWritable() const
+{
+	return true;
+}
+
+void WriterAppender::subAppend(const spi::LoggingEventList& events, Pool& p)
+{
+	if (!isGroupWritable())
+	{
+		for (auto& event : events)
+		{
+			subAppend(event, p);
+		}
+
+		return;
+	}
+
+#if !LOG4CXX_LOGCHAR_IS_UTF8
+	if (_priv->writer != NULL && _priv->writer->isUTF8())
+	{
+		auto& bytes = _priv->clearBuffer(_priv->byteBuffer);
+
+		for (auto& event : events)
+		{
+			_priv->formatUTF8(bytes, event, p);
+		}
+
+		_priv->writer->writeUTF8(bytes, p);
+
+		if (_priv->immediateFlush)
+		{
+			_priv->writer->flush(p);
+		}
+
+		return;
+	}
+#endif
+	auto& msg = _priv->clearBuffer(_priv->buffer);
+
+	for (auto& event : events)
+	{
+		_priv->layout->formatShared(msg, event, p);
+	}
 
 	if (_priv->writer != NULL)
 	{
@@ -30,6 +30,7 @@ namespace spi
 {
 class LoggingEvent;
 typedef std::shared_ptr<LoggingEvent> LoggingEventPtr;
+typedef std::vector<LoggingEventPtr> LoggingEventList;
 
 class Filter;
 typedef std::shared_ptr<Filter> FilterPtr;
@@ -87,6 +88,21 @@ class LOG4CXX_EXPORT Appender :
 		virtual void doAppend(const spi::LoggingEventPtr& event,
 			log4cxx::helpers::Pool& pool) = 0;
 
+		/**
+		 Log each of \c events in <code>Appender</code> specific way.
+		 Appenders which can output a group of events more efficiently
+		 than one at a time should override this method.
+		 The default implementation calls <code>doAppend</code> for each event.
+		*/
+		virtual void doAppend(const spi::LoggingEventList& events,
+			log4cxx::helpers::Pool& pool)
+		{
+			for (auto& event : events)
+			{
+				doAppend(event, pool);
+			}
+		}
+
 
 		/**
 		 Get the name of this appender. The name uniquely identifies the
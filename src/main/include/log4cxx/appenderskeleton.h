@@ -50,8 +50,30 @@ class LOG4CXX_EXPORT AppenderSkeleton :
 		*/
 		virtual void append(const spi::LoggingEventPtr& event, log4cxx::helpers::Pool& p) = 0;
 
+		/**
+		Subclasses of <code>AppenderSkeleton</code> may implement this
+		method to output a group of events more efficiently than one at a time.
+		The default implementation calls <code>append</code> for each event.
+		*/
+		virtual void append(const spi::LoggingEventList& events, log4cxx::helpers::Pool& p);
+
 		void doAppendImpl(const spi::LoggingEventPtr& event, log4cxx::helpers::Pool& pool);
 
+		void doAppendImpl(const spi::LoggingEventList& events, log4cxx::helpers::Pool& pool);
+
+		/**
+		Allow #doAppend to be called by more than one thread at a time.
+
+		When \c value is true, the threshold check, the filter chain and #append
+		run without locking this appender, so a subclass must make #append
+		(including any layout formatting) safe to call concurrently
+		and synchronize only the step that commits the event,
+		for example pushing it onto a thread safe queue.
+		The threshold, filters and error handler may still be changed at any time.
+		An event is checked against the values that were current when its check started.
+		*/
+		void setConcurrent(bool value);
+
 	public:
 		DECLARE_ABSTRACT_LOG4CXX_OBJECT(AppenderSkeleton)
 		BEGIN_LOG4CXX_CAST_MAP()
@@ -140,13 +162,27 @@ class LOG4CXX_EXPORT AppenderSkeleton :
 		bool isAsSevereAsThreshold(const LevelPtr& level) const;
 
 
+		/**
+		Can #doAppend be called by more than one thread at a time?
+		*/
+		bool isConcurrent() const;
+
 		/**
 		* This method performs threshold checks and invokes filters before
 		* delegating actual logging to the subclasses specific
 		* AppenderSkeleton#append method.
+		* The appender is locked while doing so unless it #isConcurrent.
 		* */
 		void doAppend(const spi::LoggingEventPtr& event, helpers::Pool& pool) override;
 
+		/**
+		* This method performs threshold checks and invokes filters on each event
+		* before delegating actual logging of the accepted events to the subclasses specific
+		* AppenderSkeleton#append method.
+		* The appender is locked while doing so unless it #isConcurrent.
+		* */
+		void doAppend(const spi::LoggingEventList& events, helpers::Pool& pool) override;
+
 		/**
 		Set the {@link spi::ErrorHandler ErrorHandler} for this Appender.
 		*/
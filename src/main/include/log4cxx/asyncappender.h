@@ -25,10 +25,6 @@
 #include <thread>
 #include <condition_variable>
 
-#if defined(NON_BLOCKING)
-	#include <boost/lockfree/queue.hpp>
-#endif
-
 namespace log4cxx
 {
 LOG4CXX_LIST_DEF(LoggingEventList, log4cxx::spi::LoggingEventPtr);
@@ -44,6 +40,37 @@ attach multiple appenders to an AsyncAppender.
 <p>The AsyncAppender uses a separate thread to serve the events in
 its bounded buffer.
 
+<p>What happens to an event which arrives when the buffer is full
+is determined by the <b>OverflowPolicy</b> option:
+- <b>Block</b> - the logging thread waits until the buffer has drained
+  to the <b>LowWatermark</b> (by default, half the <b>BufferSize</b>). This is the default.
+- <b>DropNewest</b> - the new event is discarded.
+  This is the behavior when <b>Blocking</b> is false.
+- <b>DropOldest</b> - the oldest buffered event is discarded to make room.
+- <b>DropBelowLevel</b> - events below the <b>DropThreshold</b> level are discarded,
+  other events wait as with <b>Block</b>.
+- <b>BoundedWait</b> - the logging thread waits as with <b>Block</b>
+  for up to <b>MaxBlockingTime</b> milliseconds, then the new event is discarded.
+
+Discarded events are counted by logger and a summary
+message is appended after the contents of the buffer have been appended.
+The total is available from getDiscardedCount().
+
+<p>By default the bounded buffer is guarded by a mutex.
+When the <b>RingBuffer</b> option is set,
+a lock-free ring buffer is used instead so that logging threads
+only synchronize when the buffer is full.
+
+<p>When the <b>DispatchPerAppender</b> option is set,
+each attached appender has its own bounded buffer and dispatcher thread,
+so a slow appender cannot hold back the others.
+The overflow policy is then applied to each buffer separately
+and getDiscardedCount(const AppenderPtr&) reports the events
+a particular appender did not receive.
+
+<p>Logging threads do not lock the AsyncAppender itself (see AppenderSkeleton::isConcurrent),
+they only synchronize on the buffer.
+
 <p><b>Important note:</b> The <code>AsyncAppender</code> can only
 be script configured using the {@link xml::DOMConfigurator DOMConfigurator}.
 */
@@ -55,6 +82,18 @@ class LOG4CXX_EXPORT AsyncAppender :
 		struct AsyncAppenderPriv;
 
 	public:
+		/**
+		 * The action taken when an event arrives and the buffer is full.
+		 */
+		enum class OverflowPolicy
+		{
+			Block,
+			DropNewest,
+			DropOldest,
+			DropBelowLevel,
+			BoundedWait
+		};
+
 		DECLARE_LOG4CXX_OBJECT(AsyncAppender)
 		BEGIN_LOG4CXX_CAST_MAP()
 		LOG4CXX_CAST_ENTRY(AsyncAppender)
@@ -79,9 +118,6 @@ class LOG4CXX_EXPORT AsyncAppender :
 		*/
 		void addAppender(const AppenderPtr newAppender) override;
 
-		void doAppend(const spi::LoggingEventPtr& event,
-			helpers::Pool& pool1) override;
-
 		void append(const spi::LoggingEventPtr& event, helpers::Pool& p) override;
 
 		/**
@@ -160,6 +196,7 @@ class LOG4CXX_EXPORT AsyncAppender :
 		/**
 		 * Sets whether appender should wait if there is no
 		 * space available in the event buffer or immediately return.
+		 * Equivalent to an <b>OverflowPolicy</b> of Block or DropNewest.
 		 *
 		 * @param value true if appender should wait until available space in buffer.
 		 */
@@ -170,10 +207,135 @@ class LOG4CXX_EXPORT AsyncAppender :
 		 * If false, messages will be counted by logger and a summary
 		 * message appended after the contents of the buffer have been appended.
 		 *
-		 * @return true if calling thread will be blocked when buffer is full.
+		 * @return true if the <b>OverflowPolicy</b> is Block.
 		 */
 		bool getBlocking() const;
 
+		/**
+		 * Sets the action taken when an event arrives and the buffer is full.
+		 *
+		 * @param policy the new overflow policy.
+		 */
+		void setOverflowPolicy(OverflowPolicy policy);
+
+		/**
+		 * Sets the action taken when an event arrives and the buffer is full.
+		 *
+		 * @param policy one of Block, DropNewest, DropOldest, DropBelowLevel or BoundedWait.
+		 */
+		void setOverflowPolicy(const LogString& policy);
+
+		/**
+		 * Gets the action taken when an event arrives and the buffer is full.
+		 *
+		 * @return the current value of the <b>OverflowPolicy</b> option.
+		 */
+		OverflowPolicy getOverflowPolicy() const;
+
+		/**
+		 * Sets the number of buffered events at or below which
+		 * a logging thread waiting for space continues.
+		 * Zero waits until the dispatcher has taken every buffered event.
+		 * With a non-zero value, events the dispatcher has taken
+		 * but not yet appended are counted as buffered.
+		 * When not set, a logging thread continues once
+		 * no more than half the <b>BufferSize</b> events are waiting to be taken.
+		 *
+		 * @param value a non-negative number of events.
+		 */
+		void setLowWatermark(int value);
+
+		/**
+		 * Gets the number of buffered events at or below which
+		 * a logging thread waiting for space continues.
+		 *
+		 * @return the current value of the <b>LowWatermark</b> option,
+		 * half the <b>BufferSize</b> if it is not set.
+		 */
+		int getLowWatermark() const;
+
+		/**
+		 * Sets the lowest level which the DropBelowLevel policy will not discard.
+		 *
+		 * @param level the new threshold, WARN if null.
+		 */
+		void setDropThreshold(const LevelPtr& level);
+
+		/**
+		 * Gets the lowest level which the DropBelowLevel policy will not discard.
+		 *
+		 * @return the current value of the <b>DropThreshold</b> option.
+		 */
+		LevelPtr getDropThreshold() const;
+
+		/**
+		 * Sets the longest time a logging thread waits for space
+		 * under the BoundedWait policy.
+		 *
+		 * @param milliseconds a non-negative duration.
+		 */
+		void setMaxBlockingTime(int milliseconds);
+
+		/**
+		 * Gets the longest time a logging thread waits for space
+		 * under the BoundedWait policy.
+		 *
+		 * @return the current value of the <b>MaxBlockingTime</b> option.
+		 */
+		int getMaxBlockingTime() const;
+
+		/**
+		 * Gets the number of events discarded because the buffer was full.
+		 *
+		 * @return the total since this appender was created.
+		 */
+		size_t getDiscardedCount() const;
+
+		/**
+		 * Gets the number of events \c appender did not receive because its buffer was full.
+		 * Only non-zero when the <b>DispatchPerAppender</b> option is set.
+		 *
+		 * @param appender an attached appender.
+		 * @return the total since \c appender was attached.
+		 */
+		size_t getDiscardedCount(const AppenderPtr& appender) const;
+
+		/**
+		 * Sets whether events are passed to the dispatcher
+		 * through a lock-free ring buffer of <b>BufferSize</b> slots
+		 * instead of a mutex guarded list.
+		 * The <b>Blocking</b> option has the same effect in both modes.
+		 *
+		 * The buffer mode and size are fixed when the first event is appended.
+		 *
+		 * @param value true if the lock-free ring buffer is to be used.
+		 */
+		void setRingBuffer(bool value);
+
+		/**
+		 * Gets whether the lock-free ring buffer is used.
+		 *
+		 * @return the current value of the <b>RingBuffer</b> option.
+		 */
+		bool getRingBuffer() const;
+
+		/**
+		 * Sets whether each attached appender is served by its own
+		 * buffer and dispatcher thread instead of sharing one.
+		 *
+		 * The dispatch mode is fixed when the first event is appended.
+		 *
+		 * @param value true if each appender is to have its own dispatcher.
+		 */
+		void setDispatchPerAppender(bool value);
+
+		/**
+		 * Gets whether each attached appender has its own dispatcher thread.
+		 *
+		 * @return the current value of the <b>DispatchPerAppender</b> option.
+		 */
+		bool getDispatchPerAppender() const;
+
 
 		/**
 		\copybrief AppenderSkeleton::setOption()
@@ -183,6 +345,12 @@ class LOG4CXX_EXPORT AsyncAppender :
 		LocationInfo | True,False | False
 		BufferSize | int  | 128
 		Blocking | True,False | True
+		RingBuffer | True,False | False
+		DispatchPerAppender | True,False | False
+		OverflowPolicy | Block,DropNewest,DropOldest,DropBelowLevel,BoundedWait | Block
+		LowWatermark | int | BufferSize / 2
+		DropThreshold | Trace,Debug,Info,Warn,Error,Fatal | Warn
+		MaxBlockingTime | int (milliseconds) | 100
 
 		\sa AppenderSkeleton::setOption()
 		 */
@@ -193,11 +361,6 @@ class LOG4CXX_EXPORT AsyncAppender :
 		AsyncAppender(const AsyncAppender&);
 		AsyncAppender& operator=(const AsyncAppender&);
 
-		/**
-		 *  Dispatch routine.
-		 */
-		void dispatch();
-
 }; // class AsyncAppender
 LOG4CXX_PTR_DEF(AsyncAppender);
 }  //  namespace log4cxx
@@ -0,0 +1,166 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _LOG4CXX_BINARY_JOURNAL_APPENDER_H
+#define _LOG4CXX_BINARY_JOURNAL_APPENDER_H
+
+#include <log4cxx/appenderskeleton.h>
+#include <log4cxx/helpers/outputstream.h>
+
+namespace log4cxx
+{
+
+/**
+BinaryJournalAppender appends log events to a file in a compact binary form
+which is rendered into text only when it is read,
+for example by the <code>log4cxx-journal</code> program
+or a helpers::BinaryJournalReader.
+
+<p>No layout is used and no character set conversion is done
+beyond encoding strings as UTF-8.
+Logger names, thread names, level names, source locations and MDC keys
+are written once per file to a dictionary and then referred to by number,
+and each timestamp is written as the difference from the previous event.
+
+<p>The <b>BufferSize</b> option sets the number of bytes collected
+before they are written to the file
+when the <b>ImmediateFlush</b> option is false.
+*/
+class LOG4CXX_EXPORT BinaryJournalAppender : public AppenderSkeleton
+{
+	protected:
+		struct BinaryJournalAppenderPriv;
+
+	public:
+		DECLARE_LOG4CXX_OBJECT(BinaryJournalAppender)
+		BEGIN_LOG4CXX_CAST_MAP()
+		LOG4CXX_CAST_ENTRY(BinaryJournalAppender)
+		LOG4CXX_CAST_ENTRY_CHAIN(AppenderSkeleton)
+		END_LOG4CXX_CAST_MAP()
+
+		/**
+		The default constructor does not open a file.
+		*/
+		BinaryJournalAppender();
+
+		/**
+		Instantiate a <code>BinaryJournalAppender</code> and open the file
+		designated by <code>filename</code>.
+
+		@param filename the file to write.
+		@param append true if events are added to an existing file,
+		otherwise it is truncated.
+		*/
+		BinaryJournalAppender(const LogString& filename, bool append = true);
+
+		~BinaryJournalAppender();
+
+		/**
+		Open the file designated by the <b>File</b> option.
+		*/
+		void activateOptions(helpers::Pool& p) override;
+
+		/**
+		\copybrief AppenderSkeleton::setOption()
+
+		Supported options | Supported values | Default value
+		-------------- | ---------------- | ---------------
+		File | A path | -
+		Append | True,False | True
+		ImmediateFlush | True,False | True
+		BufferSize | (\ref journalSz1 "1") | 8 KB
+
+		\anchor journalSz1 (1) An integer in the range 0 - 2^63.
+		 You can specify the value with the suffixes "KB", "MB" or "GB" so that the integer is
+		 interpreted being expressed respectively in kilobytes, megabytes
+		 or gigabytes. For example, the value "10KB" will be interpreted as 10240.
+
+		\sa AppenderSkeleton::setOption()
+		*/
+		void setOption(const LogString& option, const LogString& value) override;
+
+		void append(const spi::LoggingEventPtr& event, helpers::Pool& p) override;
+
+		/**
+		Write any buffered events and close the file.
+		*/
+		void close() override;
+
+		/**
+		No layout is required.
+		*/
+		bool requiresLayout() const override;
+
+		/**
+		The file to which events are written.
+		*/
+		LogString getFile() const;
+
+		/**
+		Use \c file as the destination when activateOptions() is next called.
+		*/
+		void setFile(const LogString& file);
+
+		/**
+		Are events added to an existing file?
+		*/
+		bool getAppend() const;
+
+		/**
+		Use \c value to decide whether to add events to an existing file
+		when activateOptions() is next called.
+		*/
+		void setAppend(bool value);
+
+		/**
+		Is the file written after each event?
+		*/
+		bool getImmediateFlush() const;
+
+		/**
+		Use \c value to decide whether to write the file after each event.
+		*/
+		void setImmediateFlush(bool value);
+
+		/**
+		The number of bytes collected before they are written to the file.
+		*/
+		int getBufferSize() const;
+
+		/**
+		Collect up to \c value bytes before writing them to the file
+		when <b>ImmediateFlush</b> is false.
+		*/
+		void setBufferSize(int value);
+
+	protected:
+		/**
+		Write the journal to \c out instead of the file.
+		A new session is started, so a Header record is written first.
+		*/
+		void setOutputStream(const helpers::OutputStreamPtr& out, helpers::Pool& p);
+
+	private:
+		BinaryJournalAppender(const BinaryJournalAppender&);
+		BinaryJournalAppender& operator=(const BinaryJournalAppender&);
+};
+
+LOG4CXX_PTR_DEF(BinaryJournalAppender);
+
+} // namespace log4cxx
+
+#endif //_LOG4CXX_BINARY_JOURNAL_APPENDER_H
@@ -132,6 +132,14 @@ class LOG4CXX_EXPORT FileAppender : public WriterAppender
 		BufferedIO | True,False | False
 		ImmediateFlush | True,False | False
 		BufferSize | (\ref fileSz1 "1") | 8 KB
+		MaxFlushDelay | int | 0
+		MemoryMapped | True,False | False
+		MappedExtentSize | (\ref fileSz1 "1") | 8 MB
+		IOUring | True,False | False
+		IOUringQueueDepth | int | 8
+		SyncInterval | int | 0
+		SyncSize | (\ref fileSz1 "1") | 0
+		SyncLevel | Trace,Debug,Info,Warn,Error,Fatal,Off,All | -
 
 		\anchor fileSz1 (1) An integer in the range 0 - 2^63.
 		 You can specify the value with the suffixes "KB", "MB" or "GB" so that the integer is
@@ -142,6 +150,13 @@ class LOG4CXX_EXPORT FileAppender : public WriterAppender
 		*/
 		void setOption(const LogString& option, const LogString& value) override;
 
+		/**
+		\copybrief WriterAppender::close()
+
+		Also stops the periodic flush required by the <b>MaxFlushDelay</b> option.
+		*/
+		void close() override;
+
 		/**
 		Get the value of the <b>BufferedIO</b> option.
 
@@ -184,6 +199,169 @@ class LOG4CXX_EXPORT FileAppender : public WriterAppender
 		*/
 		void setBufferSize(int bufferSize1);
 
+		/**
+		Get the maximum time (in milliseconds) an event may remain in the IO buffer,
+		or zero for no time limit.
+		*/
+		int getMaxFlushDelay() const;
+
+		/**
+		The <b>MaxFlushDelay</b> option takes an integer value.
+		When greater than zero and <b>BufferedIO</b> is true,
+		the IO buffer is written to the file at most this many milliseconds
+		after an event is appended, so the file is up to date during quiet periods.
+		The buffers of all appenders are flushed by a single shared thread
+		(see helpers::ThreadUtility::addPeriodicTask).
+		<p>Note: The new value takes effect when the file is next opened.
+		*/
+		void setMaxFlushDelay(int milliseconds);
+
+		/**
+		Get the value of the <b>MemoryMapped</b> option.
+		*/
+		bool getMemoryMapped() const;
+
+		/**
+		The <b>MemoryMapped</b> option takes a boolean value. It is set to
+		<code>false</code> by default. If true, then <code>File</code>
+		is extended in large steps and each event is copied into
+		a memory mapped region of the file, avoiding a system call per event.
+		The file is truncated to the length written when it is closed.
+		If memory mapped files are not supported on the platform,
+		or the file system cannot preallocate space for them,
+		the file is written normally.
+		<p>Note: Actual opening of the file is made when
+		#activateOptions is called, not when the options are set.
+		*/
+		void setMemoryMapped(bool memoryMapped);
+
+		/**
+		Get the number of bytes by which a memory mapped file is extended.
+		*/
+		size_t getMappedExtentSize() const;
+
+		/**
+		Set the number of bytes by which a memory mapped file is extended
+		(the <b>MappedExtentSize</b> option).
+		*/
+		void setMappedExtentSize(size_t extentSize);
+
+		/**
+		Get the value of the <b>IOUring</b> option.
+		*/
+		bool getIOUring() const;
+
+		/**
+		The <b>IOUring</b> option takes a boolean value. It is set to
+		<code>false</code> by default. If true, then <code>File</code>
+		is written asynchronously using Linux io_uring,
+		so a slow disk delays logging only when
+		all <b>IOUringQueueDepth</b> buffers (of 64 KB) are waiting to be written.
+		Setting this option also sets <b>ImmediateFlush</b> to false.
+		If io_uring is not available, the file is written normally.
+		The <b>MemoryMapped</b> option takes precedence over this option.
+		<p>Note: Actual opening of the file is made when
+		#activateOptions is called, not when the options are set.
+		*/
+		void setIOUring(bool ioUring);
+
+		/**
+		Get the number of buffers that may be waiting to be written using io_uring.
+		*/
+		int getIOUringQueueDepth() const;
+
+		/**
+		Set the number of buffers that may be waiting to be written using io_uring
+		(the <b>IOUringQueueDepth</b> option).
+		When greater than one and <b>Append</b> is false,
+		buffers are written in parallel at offsets held by the appender,
+		so another process must not write to or truncate the file.
+		When appending, buffers are written one at a time to the end of the file.
+		*/
+		void setIOUringQueueDepth(int queueDepth);
+
+		/**
+		Get the maximum time (in milliseconds) written bytes remain
+		unsynchronized with the storage device, or zero for no time limit.
+		*/
+		int getSyncInterval() const;
+
+		/**
+		The <b>SyncInterval</b> option takes an integer value.
+		When greater than zero, the file is synchronized with the storage device
+		(using fdatasync or the platform equivalent) on a background thread
+		at most this many milliseconds after an event is written.
+		<p>Note: The new value takes effect when the file is next opened.
+		*/
+		void setSyncInterval(int milliseconds);
+
+		/**
+		Get the number of unsynchronized bytes that causes the file
+		to be synchronized with the storage device, or zero for no limit.
+		*/
+		size_t getSyncSize() const;
+
+		/**
+		The <b>SyncSize</b> option takes a file size value.
+		When greater than zero, the file is synchronized with the storage device
+		on a background thread once this many bytes have been written since the previous sync.
+		<p>Note: The new value takes effect when the file is next opened.
+		*/
+		void setSyncSize(size_t byteCount);
+
+		/**
+		Get the level at or above which an event is durable
+		when the logging request returns.
+		*/
+		LevelPtr getSyncLevel() const;
+
+		/**
+		The <b>SyncLevel</b> option takes a level value.
+		The thread logging an event of this level or higher
+		waits until the file is synchronized with the storage device.
+		Threads that are waiting at the same time share a single sync
+		(a group commit), and the appender is not locked while waiting.
+		<p>Note: The new value takes effect when the file is next opened.
+		*/
+		void setSyncLevel(const LevelPtr& level);
+
+		/**
+		The number and duration of file synchronizations
+		requested by the <b>SyncInterval</b>, <b>SyncSize</b> and <b>SyncLevel</b> options.
+		*/
+		struct SyncStatistics
+		{
+			/** The number of times the file was synchronized with the storage device. */
+			uint64_t syncCount;
+			/** The number of events that waited for a sync. */
+			uint64_t waitCount;
+			/** The time (in microseconds) spent synchronizing the file. */
+			uint64_t totalMicroseconds;
+			/** The longest time (in microseconds) taken by a single sync. */
+			uint64_t maxMicroseconds;
+		};
+
+		/**
+		Get the file synchronization statistics of this appender.
+		*/
+		SyncStatistics getSyncStatistics() const;
+
+		/**
+		\copybrief AppenderSkeleton::doAppend(const spi::LoggingEventPtr&, helpers::Pool&)
+
+		If the event level is at least <b>SyncLevel</b>,
+		waits until the file is synchronized with the storage device.
+		*/
+		void doAppend(const spi::LoggingEventPtr& event, helpers::Pool& pool) override;
+
+		/**
+		\copybrief AppenderSkeleton::doAppend(const spi::LoggingEventList&, helpers::Pool&)
+
+		If any event level is at least <b>SyncLevel</b>,
+		waits until the file is synchronized with the storage device.
+		*/
+		void doAppend(const spi::LoggingEventList& events, helpers::Pool& pool) override;
+
 		/**
 		 *   Replaces double backslashes with single backslashes
 		 *   for compatibility with paths from earlier XML configurations files.
@@ -221,7 +399,33 @@ class LOG4CXX_EXPORT FileAppender : public WriterAppender
 
 		void setFileInternal(const LogString& file);
 
+		/**
+		An output stream that writes to \c file,
+		a helpers::MappedFileOutputStream if the <b>MemoryMapped</b> option is set
+		or a helpers::IOUringFileOutputStream if the <b>IOUring</b> option is set.
+		The stream is synchronized with the storage device
+		as required by the <b>SyncInterval</b>, <b>SyncSize</b> and <b>SyncLevel</b> options.
+		@param file The path to the log file.
+		@param append If true will append to file. Otherwise will truncate file.
+		@throws IOException
+		*/
+		helpers::OutputStreamPtr createOutputStream(const LogString& file, bool append);
+
+		/**
+		Writes \c event and marks the buffer for the periodic flush.
+		*/
+		void subAppend(const spi::LoggingEventPtr& event, helpers::Pool& p) override;
+
+		/**
+		Writes \c events and marks the buffer for the periodic flush.
+		*/
+		void subAppend(const spi::LoggingEventList& events, helpers::Pool& p) override;
+
 	private:
+		void waitDurable(helpers::Pool& p);
+		void flushBuffer();
+		void stopFlushTask();
+
 		FileAppender(const FileAppender&);
 		FileAppender& operator=(const FileAppender&);
 	protected:
@@ -31,6 +31,7 @@ namespace spi
 {
 class LoggingEvent;
 typedef std::shared_ptr<LoggingEvent> LoggingEventPtr;
+typedef std::vector<LoggingEventPtr> LoggingEventList;
 }
 
 namespace helpers
@@ -69,6 +70,13 @@ class LOG4CXX_EXPORT AppenderAttachableImpl :
 		int appendLoopOnAppenders(const spi::LoggingEventPtr& event,
 			log4cxx::helpers::Pool& p);
 
+		/**
+		 Call the <code>doAppend</code> method on all attached appenders
+		 passing all of \c events in a single call.
+		*/
+		int appendLoopOnAppenders(const spi::LoggingEventList& events,
+			log4cxx::helpers::Pool& p);
+
 		/**
 		 * Get all previously added appenders as an Enumeration.
 		 */
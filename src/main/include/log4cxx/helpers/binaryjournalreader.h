@@ -0,0 +1,68 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _LOG4CXX_HELPERS_BINARY_JOURNAL_READER_H
+#define _LOG4CXX_HELPERS_BINARY_JOURNAL_READER_H
+
+#include <log4cxx/spi/loggingevent.h>
+#include <log4cxx/file.h>
+
+namespace log4cxx
+{
+namespace helpers
+{
+
+/**
+ * Recreates the logging events in a file written by BinaryJournalAppender.
+ *
+ * The location information of an event refers to memory owned by this reader,
+ * so an event must not be used after this reader is destroyed.
+ */
+class LOG4CXX_EXPORT BinaryJournalReader
+{
+	public:
+		/**
+		 * Open \c file for reading.
+		 *
+		 * @throws IOException if \c file cannot be opened.
+		 */
+		BinaryJournalReader(const File& file);
+
+		~BinaryJournalReader();
+
+		/**
+		 * The next event in the journal.
+		 *
+		 * A record cut short by the end of the file
+		 * (for example, because the writing process was killed) is ignored.
+		 *
+		 * @return null at the end of the journal.
+		 * @throws IOException if the file is not a journal or a record is malformed.
+		 */
+		spi::LoggingEventPtr read();
+
+	private:
+		LOG4CXX_DECLARE_PRIVATE_MEMBER_PTR(BinaryJournalReaderPrivate, m_priv)
+
+		BinaryJournalReader(const BinaryJournalReader&);
+		BinaryJournalReader& operator=(const BinaryJournalReader&);
+};
+
+} // namespace helpers
+} // namespace log4cxx
+
+#endif //_LOG4CXX_HELPERS_BINARY_JOURNAL_READER_H
@@ -24,6 +24,14 @@ namespace log4cxx
 {
 namespace pattern
 {
+/**
+ * A DateFormat which reuses the text of a wrapped DateFormat
+ * for times within the same integral second,
+ * updating only the millisecond or microsecond field.
+ *
+ * Threads may share an instance without locking.
+ * setTimeZone must not be called while other threads are formatting.
+ */
 class LOG4CXX_EXPORT CachedDateFormat : public log4cxx::helpers::DateFormat
 {
 	public:
@@ -122,6 +122,11 @@ class LOG4CXX_EXPORT CharsetEncoder : public Object
 		*/
 		static bool isTriviallyCopyable(const LogString& src, const CharsetEncoderPtr& enc);
 
+		/**
+		* Does \c enc produce UTF-8?
+		*/
+		static bool isUTF8(const CharsetEncoderPtr& enc);
+
 
 	private:
 		/**
@@ -0,0 +1,216 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _LOG4CXX_HELPERS_DEFERRED_FORMAT_H
+#define _LOG4CXX_HELPERS_DEFERRED_FORMAT_H
+
+#include <log4cxx/helpers/deferredmessage.h>
+#include <log4cxx/helpers/transcoder.h>
+#include <fmt/format.h>
+#if LOG4CXX_WCHAR_T_API
+#include <fmt/xchar.h>
+#endif
+#include <cstddef>
+#include <new>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#if __cpp_lib_string_view || (_MSVC_LANG >= 201703L)
+#include <string_view>
+#endif
+
+namespace log4cxx
+{
+namespace helpers
+{
+
+/**
+ * How a FmtDeferredMessage holds an argument of type \c T.
+ *
+ * Only values that do not refer to memory owned by the caller
+ * can be formatted after the logging request has returned.
+ * Being trivially copyable is not enough: a \c fmt::join result,
+ * a \c std::span or a \c std::reference_wrapper refers to the caller's data.
+ * Numbers, enumerations and strings are deferred;
+ * specialize this template, with \c deferrable set to true,
+ * for a type whose copy does not refer to other memory.
+ */
+template <typename T>
+struct DeferredArgument
+{
+	typedef T type;
+	static constexpr bool deferrable = std::is_arithmetic<T>::value || std::is_enum<T>::value;
+};
+
+template <>
+struct DeferredArgument<const void*>
+{
+	typedef const void* type;
+	static constexpr bool deferrable = true;
+};
+
+template <>
+struct DeferredArgument<void*> : DeferredArgument<const void*> {};
+
+/**
+ * Character strings are copied.
+ */
+template <typename Char>
+struct DeferredString
+{
+	typedef std::basic_string<Char> type;
+	static constexpr bool deferrable = true;
+};
+
+template <>
+struct DeferredArgument<char*> : DeferredString<char> {};
+
+template <>
+struct DeferredArgument<const char*> : DeferredString<char> {};
+
+template <>
+struct DeferredArgument<wchar_t*> : DeferredString<wchar_t> {};
+
+template <>
+struct DeferredArgument<const wchar_t*> : DeferredString<wchar_t> {};
+
+template <typename Char, typename Traits, typename Alloc>
+struct DeferredArgument<std::basic_string<Char, Traits, Alloc> >
+{
+	typedef std::basic_string<Char, Traits, Alloc> type;
+	static constexpr bool deferrable = true;
+};
+
+template <typename Char>
+struct DeferredArgument<fmt::basic_string_view<Char> > : DeferredString<Char> {};
+
+#if __cpp_lib_string_view || (_MSVC_LANG >= 201703L)
+template <typename Char, typename Traits>
+struct DeferredArgument<std::basic_string_view<Char, Traits> > : DeferredString<Char> {};
+#endif
+
+/**
+ * A libfmt format string and a copy of its arguments.
+ */
+template <typename Char, typename... Stored>
+class FmtDeferredMessage : public DeferredMessage
+{
+	public:
+		template <typename... Args>
+		FmtDeferredMessage(fmt::basic_string_view<Char> format, Args&&... args)
+			: m_format(format)
+			, m_args(std::forward<Args>(args)...)
+		{
+		}
+
+		void format(LogString& dest) const override
+		{
+			Transcoder::decode(vformat(std::index_sequence_for<Stored...>()), dest);
+		}
+
+		DeferredMessage* moveTo(void* storage) override
+		{
+			return new (storage) FmtDeferredMessage(std::move(*this));
+		}
+
+	private:
+		template <std::size_t... I>
+		std::basic_string<Char> vformat(std::index_sequence<I...>) const
+		{
+			return fmt::vformat(m_format, fmt::make_format_args<fmt::buffer_context<Char> >(std::get<I>(m_args)...));
+		}
+
+		/** A string literal, so it outlives the logging event. */
+		fmt::basic_string_view<Char> m_format;
+		std::tuple<Stored...> m_args;
+};
+
+template <typename Char, typename... Args>
+using FmtDeferredMessageFor = FmtDeferredMessage<Char, typename DeferredArgument<typename std::decay<Args>::type>::type...>;
+
+template <bool... B>
+struct BoolPack {};
+
+/**
+ * Can the logging event hold a message with these arguments?
+ */
+template <typename Char, typename... Args>
+struct CanDeferFormat
+{
+	static constexpr bool value =
+		std::is_same<BoolPack<true, DeferredArgument<typename std::decay<Args>::type>::deferrable...>
+			, BoolPack<DeferredArgument<typename std::decay<Args>::type>::deferrable..., true> >::value
+		&& sizeof(FmtDeferredMessageFor<Char, Args...>) <= DeferredMessage::MaxSize
+		&& alignof(FmtDeferredMessageFor<Char, Args...>) <= alignof(std::max_align_t);
+};
+
+#if FMT_VERSION >= 80000
+/**
+ * A message that formats \c args using \c format when first requested.
+ * If an argument could refer to memory owned by the caller
+ * or the arguments will not fit in the logging event,
+ * the message is formatted immediately.
+ *
+ * @param format a string literal.
+ */
+template <typename... Args>
+typename std::enable_if<CanDeferFormat<char, Args...>::value, FmtDeferredMessageFor<char, Args...> >::type
+deferFormat(fmt::format_string<Args...> format, Args&&... args)
+{
+	return FmtDeferredMessageFor<char, Args...>(format, std::forward<Args>(args)...);
+}
+
+template <typename... Args>
+typename std::enable_if<!CanDeferFormat<char, Args...>::value, std::string>::type
+deferFormat(fmt::format_string<Args...> format, Args&&... args)
+{
+	return fmt::format(format, std::forward<Args>(args)...);
+}
+
+#if LOG4CXX_WCHAR_T_API
+template <typename... Args>
+typename std::enable_if<CanDeferFormat<wchar_t, Args...>::value, FmtDeferredMessageFor<wchar_t, Args...> >::type
+deferFormat(fmt::wformat_string<Args...> format, Args&&... args)
+{
+	return FmtDeferredMessageFor<wchar_t, Args...>(format, std::forward<Args>(args)...);
+}
+
+template <typename... Args>
+typename std::enable_if<!CanDeferFormat<wchar_t, Args...>::value, std::wstring>::type
+deferFormat(fmt::wformat_string<Args...> format, Args&&... args)
+{
+	return fmt::format(format, std::forward<Args>(args)...);
+}
+#endif // LOG4CXX_WCHAR_T_API
+
+#else // FMT_VERSION < 80000
+/**
+ * Earlier versions of libfmt do not provide a checked format string type,
+ * so the message is formatted immediately.
+ */
+template <typename... Args>
+auto deferFormat(Args&&... args) -> decltype(fmt::format(std::forward<Args>(args)...))
+{
+	return fmt::format(std::forward<Args>(args)...);
+}
+#endif // FMT_VERSION
+
+} // namespace helpers
+} // namespace log4cxx
+
+#endif //_LOG4CXX_HELPERS_DEFERRED_FORMAT_H
@@ -0,0 +1,61 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _LOG4CXX_HELPERS_DEFERRED_MESSAGE_H
+#define _LOG4CXX_HELPERS_DEFERRED_MESSAGE_H
+
+#include <log4cxx/logstring.h>
+
+namespace log4cxx
+{
+namespace helpers
+{
+
+/**
+ * The text of a logging event that is produced when it is first requested.
+ *
+ * A logging event holds the message in storage of its own
+ * and calls format() at most once, on whichever thread first needs the text.
+ */
+class LOG4CXX_EXPORT DeferredMessage
+{
+	public:
+		/**
+		 * The number of bytes available to a message held by a logging event.
+		 */
+		enum { MaxSize = 128 };
+
+		virtual ~DeferredMessage() {}
+
+		/**
+		 * Append the text of this message to \c dest.
+		 */
+		virtual void format(LogString& dest) const = 0;
+
+		/**
+		 * Move this message into the DeferredMessage::MaxSize bytes at \c storage,
+		 * which are suitably aligned for any scalar type.
+		 *
+		 * @return the message at \c storage.
+		 */
+		virtual DeferredMessage* moveTo(void* storage) = 0;
+};
+
+} // namespace helpers
+} // namespace log4cxx
+
+#endif //_LOG4CXX_HELPERS_DEFERRED_MESSAGE_H
@@ -0,0 +1,107 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _LOG4CXX_HELPERS_IOURINGFILEOUTPUTSTREAM_H
+#define _LOG4CXX_HELPERS_IOURINGFILEOUTPUTSTREAM_H
+
+#include <log4cxx/helpers/outputstream.h>
+#include <log4cxx/file.h>
+#include <log4cxx/helpers/pool.h>
+
+namespace log4cxx
+{
+
+namespace helpers
+{
+
+/**
+*   OutputStream that writes a file asynchronously using Linux io_uring.
+*
+*   Bytes are copied into one of a pool of (registered) buffers.
+*   A buffer is submitted when it is full or when no write is in progress,
+*   so #write waits only when every buffer is being written.
+*   Buffers are written in order:
+*   at consecutive offsets of a regular file this stream truncated,
+*   and otherwise one at a time.
+*   #flush and #close wait until all buffers are written.
+*
+*   When appending, or with a queue depth of one, the file is opened for appending,
+*   so bytes written by another process are kept, and buffers are written one at a time.
+*   Otherwise the file is truncated and buffers are written in parallel
+*   at offsets held by this stream, so bytes written by another process,
+*   or a truncation of the file, are overwritten or leave a gap.
+*
+*   io_uring is not available on every system, see #isSupported.
+*/
+class LOG4CXX_EXPORT IOUringFileOutputStream : public OutputStream
+{
+	private:
+		LOG4CXX_DECLARE_PRIVATE_MEMBER_PTR(IOUringFileOutputStreamPrivate, m_priv)
+
+	public:
+		DECLARE_ABSTRACT_LOG4CXX_OBJECT(IOUringFileOutputStream)
+		BEGIN_LOG4CXX_CAST_MAP()
+		LOG4CXX_CAST_ENTRY(IOUringFileOutputStream)
+		LOG4CXX_CAST_ENTRY_CHAIN(OutputStream)
+		END_LOG4CXX_CAST_MAP()
+
+		enum
+		{
+			DefaultQueueDepth = 8,
+			BufferSize = 64 * 1024
+		};
+
+		/**
+		 * Open \c filename for writing.
+		 *
+		 * @param filename The path to the file.
+		 * @param append If true bytes are added to the end of the file,
+		 * otherwise the file is truncated.
+		 * @param queueDepth The number of buffers (each of #BufferSize bytes)
+		 * that may be waiting to be written, in parallel only if \c append is false.
+		 * @throws IOException if the file cannot be opened or io_uring is not available.
+		 */
+		IOUringFileOutputStream(const LogString& filename, bool append = false,
+			int queueDepth = DefaultQueueDepth);
+		virtual ~IOUringFileOutputStream();
+
+		/**
+		 * Can io_uring be used on this system?
+		 */
+		static bool isSupported();
+
+		void close(Pool& p) override;
+		void flush(Pool& p) override;
+		void write(ByteBuffer& buf, Pool& p) override;
+
+		/**
+		 * The open file, or null after #close.
+		 */
+		apr_file_t* getFilePtr() const;
+
+	private:
+		IOUringFileOutputStream(const IOUringFileOutputStream&);
+		IOUringFileOutputStream& operator=(const IOUringFileOutputStream&);
+};
+
+LOG4CXX_PTR_DEF(IOUringFileOutputStream);
+
+} // namespace helpers
+
+}  //namespace log4cxx
+
+#endif //_LOG4CXX_HELPERS_IOURINGFILEOUTPUTSTREAM_H
@@ -0,0 +1,110 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _LOG4CXX_HELPERS_MAPPEDFILEOUTPUTSTREAM_H
+#define _LOG4CXX_HELPERS_MAPPEDFILEOUTPUTSTREAM_H
+
+#include <log4cxx/helpers/outputstream.h>
+#include <log4cxx/file.h>
+#include <log4cxx/helpers/pool.h>
+
+namespace log4cxx
+{
+
+namespace helpers
+{
+
+/**
+*   OutputStream that copies bytes into a memory mapped region of a file.
+*
+*   The file is extended and mapped in extents of (by default) 8 MB,
+*   so writing usually requires no system call.
+*   Bytes written are in the operating system's page cache
+*   and are not lost if the process terminates abnormally.
+*   #flush asks the operating system to (asynchronously) write completed pages to disk.
+*
+*   The file is truncated to the length written when the stream is closed.
+*   A file that was not closed (for example, after a crash)
+*   ends with up to one extent of zero bytes and a trailer
+*   recording the length written when the stream was last flushed.
+*   These are removed when the file is next opened in append mode.
+*
+*   Space is allocated with posix_fallocate, so a full disk
+*   is reported as an IOException rather than by a SIGBUS signal.
+*   Memory mapped files are not supported on every platform,
+*   see #isSupported.
+*/
+class LOG4CXX_EXPORT MappedFileOutputStream : public OutputStream
+{
+	private:
+		LOG4CXX_DECLARE_PRIVATE_MEMBER_PTR(MappedFileOutputStreamPrivate, m_priv)
+
+	public:
+		DECLARE_ABSTRACT_LOG4CXX_OBJECT(MappedFileOutputStream)
+		BEGIN_LOG4CXX_CAST_MAP()
+		LOG4CXX_CAST_ENTRY(MappedFileOutputStream)
+		LOG4CXX_CAST_ENTRY_CHAIN(OutputStream)
+		END_LOG4CXX_CAST_MAP()
+
+		/**
+		 * Open \c filename for writing.
+		 *
+		 * @param filename The path to the file.
+		 * @param append If true bytes are added to the end of the file,
+		 * otherwise the file is truncated.
+		 * @param extentSize The number of bytes by which the file is extended,
+		 * rounded up to a multiple of the page size.
+		 * @throws IOException if the file cannot be opened or memory mapped,
+		 * or the file system cannot preallocate space.
+		 */
+		MappedFileOutputStream(const LogString& filename, bool append = false,
+			size_t extentSize = DefaultExtentSize);
+		virtual ~MappedFileOutputStream();
+
+		enum { DefaultExtentSize = 8 * 1024 * 1024 };
+
+		/**
+		 * Are memory mapped files and posix_fallocate available on this platform?
+		 */
+		static bool isSupported();
+
+		void close(Pool& p) override;
+		void flush(Pool& p) override;
+		void write(ByteBuffer& buf, Pool& p) override;
+
+		/**
+		 * The open file, or null after #close.
+		 */
+		apr_file_t* getFilePtr() const;
+
+		/**
+		 * The number of bytes in the file, excluding preallocated space.
+		 */
+		size_t length() const;
+
+	private:
+		MappedFileOutputStream(const MappedFileOutputStream&);
+		MappedFileOutputStream& operator=(const MappedFileOutputStream&);
+};
+
+LOG4CXX_PTR_DEF(MappedFileOutputStream);
+
+} // namespace helpers
+
+}  //namespace log4cxx
+
+#endif //_LOG4CXX_HELPERS_MAPPEDFILEOUTPUTSTREAM_H
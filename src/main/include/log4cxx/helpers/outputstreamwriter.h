@@ -50,6 +50,17 @@ class LOG4CXX_EXPORT OutputStreamWriter : public Writer
 		void close(Pool& p) override;
 		void flush(Pool& p) override;
 		void write(const LogString& str, Pool& p) override;
+
+		/**
+		 * Is the encoding UTF-8?
+		 */
+		bool isUTF8() const override;
+
+		/**
+		 * Write \c bytes to the output stream, re-encoding them
+		 * only if the encoding is not UTF-8.
+		 */
+		void writeUTF8(const std::string& bytes, Pool& p) override;
 		LogString getEncoding() const;
 
 		OutputStreamPtr getOutputStreamPtr() const;
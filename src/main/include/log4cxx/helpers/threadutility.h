@@ -21,6 +21,7 @@
 #include <thread>
 #include <functional>
 #include <memory>
+#include <chrono>
 
 #include "log4cxx/logstring.h"
 #include "widelife.h"
@@ -120,6 +121,39 @@ class LOG4CXX_EXPORT ThreadUtility
 		 */
 		void postThreadUnblockSignals();
 
+		/**
+		 * The time between runs of a periodic task.
+		 */
+		using Period = std::chrono::milliseconds;
+
+		/**
+		 * Call \c f every \c delay on a thread shared by all periodic tasks,
+		 * replacing any task named \c name.
+		 * The thread is started when the first task is added
+		 * and stops when no tasks remain.
+		 * A task should not block, as it delays the other tasks.
+		 */
+		void addPeriodicTask(const LogString& name, std::function<void()> f, const Period& delay);
+
+		/**
+		 * Is there a periodic task named \c name?
+		 */
+		bool hasPeriodicTask(const LogString& name);
+
+		/**
+		 * Remove the periodic task named \c name.
+		 * If the task is running on another thread, wait until it completes.
+		 */
+		void removePeriodicTask(const LogString& name);
+
+		/**
+		 * Remove all periodic tasks and stop the thread that runs them.
+		 * This includes the tasks of appenders (for example, the <b>MaxFlushDelay</b>
+		 * flush of a FileAppender), which are not restarted,
+		 * so it is intended for use at shutdown.
+		 */
+		void removeAllPeriodicTasks();
+
 		/**
 		 * Start a thread
 		 */
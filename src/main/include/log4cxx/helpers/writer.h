@@ -47,6 +47,18 @@ class LOG4CXX_EXPORT Writer : public Object
 		virtual void flush(Pool& p) = 0;
 		virtual void write(const LogString& str, Pool& p) = 0;
 
+		/**
+		 * Does writeUTF8 send its bytes to the destination unchanged?
+		 * The base class returns false.
+		 */
+		virtual bool isUTF8() const;
+
+		/**
+		 * Write the UTF-8 encoded \c bytes.
+		 * The base class decodes \c bytes and calls write.
+		 */
+		virtual void writeUTF8(const std::string& bytes, Pool& p);
+
 	private:
 		Writer(const Writer&);
 		Writer& operator=(const Writer&);
@@ -220,7 +220,7 @@ class LOG4CXX_EXPORT Hierarchy : public spi::LoggerRepository
 		virtual void setConfigured(bool configured) override;
 
 		/**
-		Refresh the threshold in children of parent
+		Refresh the threshold in \c parent and its descendants.
 		*/
 		void updateChildren(const Logger* parent);
 
@@ -47,6 +47,15 @@ class LOG4CXX_EXPORT Layout :
 		virtual void format(LogString& output,
 			const spi::LoggingEventPtr& event, log4cxx::helpers::Pool& pool) const = 0;
 
+		/**
+		Append the UTF-8 encoded output of format() to \c output.
+		Override this to avoid encoding the output of format()
+		when LogString does not hold UTF-8.
+		The base class encodes the output of format().
+		*/
+		virtual void formatUTF8(std::string& output,
+			const spi::LoggingEventPtr& event, log4cxx::helpers::Pool& pool) const;
+
 		/**
 		Returns the content type output by this layout. The base class
 		returns "text/plain".
@@ -76,6 +85,21 @@ class LOG4CXX_EXPORT Layout :
 		*/
 		virtual bool ignoresThrowable() const = 0;
 
+		/**
+		An identifier shared by layouts that produce the same output
+		for every event, or null if the output is not to be shared.
+		The base class returns null.
+		*/
+		virtual const void* getFormatKey() const;
+
+		/**
+		Append the output of format() for \c event, sharing it
+		with other layouts that have the same getFormatKey()
+		when the event is to be formatted by more than one of them.
+		*/
+		void formatShared(LogString& output,
+			const spi::LoggingEventPtr& event, log4cxx::helpers::Pool& pool) const;
+
 	protected:
 		/**
 		 * The expected length of a formatted event excluding the message text
@@ -194,6 +194,11 @@ class LOG4CXX_EXPORT Level : public helpers::Object
 		*/
 		LogString toString() const;
 
+		/**
+		Returns the name of this level without copying it.
+		*/
+		const LogString& getName() const;
+
 		/**
 		Convert an integer passed as argument to a level. If the
 		conversion fails, then this method returns DEBUG.
@@ -24,6 +24,8 @@
 #include <log4cxx/spi/location/locationinfo.h>
 #include <log4cxx/helpers/resourcebundle.h>
 #include <log4cxx/helpers/messagebuffer.h>
+#include <log4cxx/helpers/deferredmessage.h>
+#include <atomic>
 
 namespace log4cxx
 {
@@ -58,7 +60,7 @@ class LOG4CXX_EXPORT Logger :
 
 	private:
 		LOG4CXX_DECLARE_PRIVATE_MEMBER_PTR(LoggerPrivate, m_priv)
-		int m_threshold; //!< The cached level of this logger
+		std::atomic<int> m_threshold; //!< The lowest level enabled by this logger and its hierarchy
 
 	public:
 		/**
@@ -596,6 +598,16 @@ class LOG4CXX_EXPORT Logger :
 		*/
 		void forcedLog(const LevelPtr& level, const CFStringRef& message) const;
 #endif
+		/**
+		Add a new logging event to attached appender(s) without further checks.
+		The text of the event is produced by \c message when it is first requested.
+		@param level The logging event level.
+		@param message The source of the text of the logging event.
+		@param location The source code location of the logging request.
+		*/
+		void addEvent(const LevelPtr& level, helpers::DeferredMessage&& message
+			, const spi::LocationInfo& location = spi::LocationInfo::getLocationUnavailable()) const;
+
 		/**
 		Add a new logging event containing \c message and \c location to attached appender(s).
 		without further checks.
@@ -1047,7 +1059,7 @@ class LOG4CXX_EXPORT Logger :
 		 **/
 		inline static bool isDebugEnabledFor(const LoggerPtr& logger)
 		{
-			return logger && logger->m_threshold <= Level::DEBUG_INT && logger->isDebugEnabled();
+			return logger && logger->m_threshold.load(std::memory_order_relaxed) <= Level::DEBUG_INT;
 		}
 
 		/**
@@ -1081,7 +1093,7 @@ class LOG4CXX_EXPORT Logger :
 		*/
 		inline static bool isInfoEnabledFor(const LoggerPtr& logger)
 		{
-			return logger && logger->m_threshold <= Level::INFO_INT && logger->isInfoEnabled();
+			return logger && logger->m_threshold.load(std::memory_order_relaxed) <= Level::INFO_INT;
 		}
 
 		/**
@@ -1107,7 +1119,7 @@ class LOG4CXX_EXPORT Logger :
 		*/
 		inline static bool isWarnEnabledFor(const LoggerPtr& logger)
 		{
-			return logger && logger->m_threshold <= Level::WARN_INT && logger->isWarnEnabled();
+			return logger && logger->m_threshold.load(std::memory_order_relaxed) <= Level::WARN_INT;
 		}
 
 		/**
@@ -1133,7 +1145,7 @@ class LOG4CXX_EXPORT Logger :
 		*/
 		inline static bool isErrorEnabledFor(const LoggerPtr& logger)
 		{
-			return logger && logger->m_threshold <= Level::ERROR_INT && logger->isErrorEnabled();
+			return logger && logger->m_threshold.load(std::memory_order_relaxed) <= Level::ERROR_INT;
 		}
 
 		/**
@@ -1159,7 +1171,7 @@ class LOG4CXX_EXPORT Logger :
 		*/
 		inline static bool isFatalEnabledFor(const LoggerPtr& logger)
 		{
-			return logger && logger->m_threshold <= Level::FATAL_INT && logger->isFatalEnabled();
+			return logger && logger->m_threshold.load(std::memory_order_relaxed) <= Level::FATAL_INT;
 		}
 
 		/**
@@ -1185,7 +1197,7 @@ class LOG4CXX_EXPORT Logger :
 		*/
 		inline static bool isTraceEnabledFor(const LoggerPtr& logger)
 		{
-			return logger && logger->m_threshold <= Level::TRACE_INT && logger->isTraceEnabled();
+			return logger && logger->m_threshold.load(std::memory_order_relaxed) <= Level::TRACE_INT;
 		}
 
 		/**
@@ -1675,6 +1687,11 @@ class LOG4CXX_EXPORT Logger :
 		Only the Hierarchy class can change the threshold of a logger.
 		*/
 		void updateThreshold();
+		/**
+		Only the Hierarchy class can set the level of a logger
+		without refreshing the thresholds it affects.
+		*/
+		void setLevelInternal(const LevelPtr& level);
 
 	private:
 		spi::LoggerRepository* getHierarchy() const;
@@ -2015,6 +2032,27 @@ LOG4CXX_LIST_DEF(LoggerList, LoggerPtr);
 #define LOG4CXX_STACKTRACE
 #endif
 
+/**
+The message of a <code>LOG4CXX_[level]_FMT</code> logging request.
+
+When \c LOG4CXX_DEFERRED_FORMAT is defined, the format string and
+a copy of the parameters are held by the logging event and the message is
+formatted when first requested, typically by an AsyncAppender dispatch thread.
+The format string must then be a string literal.
+Parameters are copied when they are numbers, enumerations or strings,
+or types for which log4cxx::helpers::DeferredArgument is specialized;
+a request with any other parameter type is formatted immediately.
+Deferred formatting requires libfmt 8 or later.
+*/
+#if !defined(LOG4CXX_FMT_MESSAGE)
+#if defined(LOG4CXX_DEFERRED_FORMAT)
+#include <log4cxx/helpers/deferredformat.h>
+#define LOG4CXX_FMT_MESSAGE(...) ::log4cxx::helpers::deferFormat( __VA_ARGS__ )
+#else
+#define LOG4CXX_FMT_MESSAGE(...) fmt::format( __VA_ARGS__ )
+#endif
+#endif
+
 
 /**
 Add a new logging event containing \c message to attached appender(s) if this logger is enabled for \c events.
@@ -2037,7 +2075,7 @@ Add a new logging event containing libfmt formatted <code>...</code> to attached
 */
 #define LOG4CXX_LOG_FMT(logger, level, ...) do { \
 		if (logger->isEnabledFor(level)) {\
-			logger->addEvent(level, fmt::format( __VA_ARGS__ ), LOG4CXX_LOCATION); }} while (0)
+			logger->addEvent(level, LOG4CXX_FMT_MESSAGE( __VA_ARGS__ ), LOG4CXX_LOCATION); }} while (0)
 
 /**
 Add a new logging event containing \c message to attached appender(s) if this logger is enabled for \c events.
@@ -2083,7 +2121,7 @@ Add a new logging event containing libfmt formatted <code>...</code> to attached
 */
 #define LOG4CXX_DEBUG_FMT(logger, ...) do { \
 		if (LOG4CXX_UNLIKELY(::log4cxx::Logger::isDebugEnabledFor(logger))) {\
-			logger->addEvent(::log4cxx::Level::getDebug(), fmt::format( __VA_ARGS__ ), LOG4CXX_LOCATION); }} while (0)
+			logger->addEvent(::log4cxx::Level::getDebug(), LOG4CXX_FMT_MESSAGE( __VA_ARGS__ ), LOG4CXX_LOCATION); }} while (0)
 #else
 #define LOG4CXX_DEBUG(logger, message)
 #define LOG4CXX_DEBUG_FMT(logger, ...)
@@ -2115,7 +2153,7 @@ Add a new logging event containing libfmt formatted <code>...</code> to attached
 */
 #define LOG4CXX_TRACE_FMT(logger, ...) do { \
 		if (LOG4CXX_UNLIKELY(::log4cxx::Logger::isTraceEnabledFor(logger))) {\
-			logger->addEvent(::log4cxx::Level::getTrace(), fmt::format( __VA_ARGS__ ), LOG4CXX_LOCATION); }} while (0)
+			logger->addEvent(::log4cxx::Level::getTrace(), LOG4CXX_FMT_MESSAGE( __VA_ARGS__ ), LOG4CXX_LOCATION); }} while (0)
 #else
 #define LOG4CXX_TRACE(logger, message)
 #define LOG4CXX_TRACE_FMT(logger, ...)
@@ -2151,7 +2189,7 @@ Add a new logging event containing libfmt formatted <code>...</code> to attached
 */
 #define LOG4CXX_INFO_FMT(logger, ...) do { \
 		if (::log4cxx::Logger::isInfoEnabledFor(logger)) {\
-			logger->addEvent(::log4cxx::Level::getInfo(), fmt::format( __VA_ARGS__ ), LOG4CXX_LOCATION); }} while (0)
+			logger->addEvent(::log4cxx::Level::getInfo(), LOG4CXX_FMT_MESSAGE( __VA_ARGS__ ), LOG4CXX_LOCATION); }} while (0)
 #else
 #define LOG4CXX_INFO(logger, message)
 #define LOG4CXX_INFO_FMT(logger, ...)
@@ -2185,7 +2223,7 @@ Add a new logging event containing libfmt formatted <code>...</code> to attached
 */
 #define LOG4CXX_WARN_FMT(logger, ...) do { \
 		if (::log4cxx::Logger::isWarnEnabledFor(logger)) {\
-			logger->addEvent(::log4cxx::Level::getWarn(), fmt::format( __VA_ARGS__ ), LOG4CXX_LOCATION); }} while (0)
+			logger->addEvent(::log4cxx::Level::getWarn(), LOG4CXX_FMT_MESSAGE( __VA_ARGS__ ), LOG4CXX_LOCATION); }} while (0)
 #else
 #define LOG4CXX_WARN(logger, message)
 #define LOG4CXX_WARN_FMT(logger, ...)
@@ -2219,7 +2257,7 @@ Add a new logging event containing libfmt formatted <code>...</code> to attached
 */
 #define LOG4CXX_ERROR_FMT(logger, ...) do { \
 		if (::log4cxx::Logger::isErrorEnabledFor(logger)) {\
-			logger->addEvent(::log4cxx::Level::getError(), fmt::format( __VA_ARGS__ ), LOG4CXX_LOCATION); }} while (0)
+			logger->addEvent(::log4cxx::Level::getError(), LOG4CXX_FMT_MESSAGE( __VA_ARGS__ ), LOG4CXX_LOCATION); }} while (0)
 
 /**
 If \c condition is not true, add a new logging event containing \c message to attached appender(s) if \c logger is enabled for <code>ERROR</code> events.
@@ -2244,7 +2282,7 @@ If \c condition is not true, add a new logging event containing libfmt formatted
 #define LOG4CXX_ASSERT_FMT(logger, condition, ...) do { \
 		if (!(condition) && ::log4cxx::Logger::isErrorEnabledFor(logger)) {\
 			LOG4CXX_STACKTRACE \
-			logger->addEvent(::log4cxx::Level::getError(), fmt::format( __VA_ARGS__ ), LOG4CXX_LOCATION); }} while (0)
+			logger->addEvent(::log4cxx::Level::getError(), LOG4CXX_FMT_MESSAGE( __VA_ARGS__ ), LOG4CXX_LOCATION); }} while (0)
 
 #else
 #define LOG4CXX_ERROR(logger, message)
@@ -2278,7 +2316,7 @@ Add a new logging event containing libfmt formatted <code>...</code> to attached
 */
 #define LOG4CXX_FATAL_FMT(logger, ...) do { \
 		if (::log4cxx::Logger::isFatalEnabledFor(logger)) {\
-			logger->addEvent(::log4cxx::Level::getFatal(), fmt::format( __VA_ARGS__ ), LOG4CXX_LOCATION); }} while (0)
+			logger->addEvent(::log4cxx::Level::getFatal(), LOG4CXX_FMT_MESSAGE( __VA_ARGS__ ), LOG4CXX_LOCATION); }} while (0)
 #else
 #define LOG4CXX_FATAL(logger, message)
 #define LOG4CXX_FATAL_FMT(logger, ...)
@@ -0,0 +1,75 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _LOG4CXX_MAPPED_FILE_APPENDER_H
+#define _LOG4CXX_MAPPED_FILE_APPENDER_H
+
+#include <log4cxx/fileappender.h>
+
+namespace log4cxx
+{
+
+/**
+*  MappedFileAppender appends log events to a memory mapped file.
+*
+*  Each formatted event is copied into a memory mapped region of the file,
+*  so writing an event usually requires no system call.
+*  The file is extended in steps of <b>MappedExtentSize</b> bytes (8 MB by default)
+*  and is truncated to the length written when the appender is closed.
+*  Events already written are kept by the operating system
+*  if the process terminates abnormally.
+*
+*  This is a FileAppender with the <b>MemoryMapped</b> option set.
+*  To roll over memory mapped files, set the <b>MemoryMapped</b> option
+*  of a rolling::RollingFileAppender.
+*/
+class LOG4CXX_EXPORT MappedFileAppender : public FileAppender
+{
+	public:
+		DECLARE_LOG4CXX_OBJECT(MappedFileAppender)
+		BEGIN_LOG4CXX_CAST_MAP()
+		LOG4CXX_CAST_ENTRY(MappedFileAppender)
+		LOG4CXX_CAST_ENTRY_CHAIN(FileAppender)
+		END_LOG4CXX_CAST_MAP()
+
+		/**
+		The default constructor does not do anything.
+		*/
+		MappedFileAppender();
+
+		/**
+		Instantiate a <code>MappedFileAppender</code> and open the file
+		designated by <code>filename</code>.
+
+		<p>If the <code>append</code> parameter is true, the file will be
+		appended to. Otherwise, the file designated by
+		<code>filename</code> will be truncated before being opened.
+		*/
+		MappedFileAppender(const LayoutPtr& layout, const LogString& filename, bool append = true);
+
+		~MappedFileAppender();
+
+	private:
+		MappedFileAppender(const MappedFileAppender&);
+		MappedFileAppender& operator=(const MappedFileAppender&);
+}; // class MappedFileAppender
+
+LOG4CXX_PTR_DEF(MappedFileAppender);
+
+}  // namespace log4cxx
+
+#endif
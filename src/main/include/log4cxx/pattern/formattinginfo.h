@@ -92,6 +92,15 @@ class LOG4CXX_EXPORT FormattingInfo : public virtual log4cxx::helpers::Object
 		 * @param buffer buffer to be modified.
 		 */
 		void format(const int fieldStart, LogString& buffer) const;
+
+		/**
+		 * Adjust the UTF-8 encoded content of the buffer based on the specified lengths and alignment.
+		 * Lengths are measured in characters, not bytes.
+		 *
+		 * @param fieldStart start of field in buffer.
+		 * @param buffer buffer to be modified.
+		 */
+		void formatUTF8(const int fieldStart, std::string& buffer) const;
 };
 LOG4CXX_PTR_DEF(FormattingInfo);
 }
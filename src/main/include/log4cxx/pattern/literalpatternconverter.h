@@ -53,6 +53,10 @@ class LOG4CXX_EXPORT LiteralPatternConverter : public LoggingEventPatternConvert
 			LogString& toAppendTo,
 			helpers::Pool& p) const override;
 
+		void formatUTF8(const spi::LoggingEventPtr& event,
+			std::string& toAppendTo,
+			helpers::Pool& p) const override;
+
 		void format(const helpers::ObjectPtr& obj,
 			LogString& toAppendTo,
 			helpers::Pool& p) const override;
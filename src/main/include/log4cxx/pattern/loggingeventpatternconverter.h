@@ -65,6 +65,18 @@ class LOG4CXX_EXPORT LoggingEventPatternConverter : public PatternConverter
 			LogString& toAppendTo,
 			helpers::Pool& p) const = 0;
 
+		/**
+		 * Appends the UTF-8 encoded output of format().
+		 * The base class encodes the output of format().
+		 * @param event event to format, may not be null.
+		 * @param toAppendTo bytes to which the formatted event will be appended.
+		 * @param p pool for memory allocations needing during format.
+		 */
+		virtual void formatUTF8(
+			const spi::LoggingEventPtr& event,
+			std::string& toAppendTo,
+			helpers::Pool& p) const;
+
 		void format(const helpers::ObjectPtr& obj,
 			LogString& toAppendTo,
 			helpers::Pool& p) const override;
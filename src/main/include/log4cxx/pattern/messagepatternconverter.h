@@ -56,6 +56,10 @@ class LOG4CXX_EXPORT MessagePatternConverter : public LoggingEventPatternConvert
 		void format(const spi::LoggingEventPtr& event,
 			LogString& toAppendTo,
 			helpers::Pool& p) const override;
+
+		void formatUTF8(const spi::LoggingEventPtr& event,
+			std::string& toAppendTo,
+			helpers::Pool& p) const override;
 };
 }
 }
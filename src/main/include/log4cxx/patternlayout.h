@@ -522,6 +522,19 @@ class LOG4CXX_EXPORT PatternLayout : public Layout
 			return true;
 		}
 
+		/**
+		 * Appends the UTF-8 encoded output of each pattern converter,
+		 * so that message text and literals are encoded only once.
+		 */
+		void formatUTF8(std::string& output,
+			const spi::LoggingEventPtr& event, helpers::Pool& pool) const override;
+
+		/**
+		 * PatternLayouts with the same conversion pattern and colors
+		 * share the text produced for an event.
+		 */
+		const void* getFormatKey() const override;
+
 		/**
 		 * Produces a formatted string as specified by the conversion pattern.
 		 */
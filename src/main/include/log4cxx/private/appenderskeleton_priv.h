@@ -20,7 +20,10 @@
 
 #include <log4cxx/appenderskeleton.h>
 #include <log4cxx/helpers/onlyonceerrorhandler.h>
+#include <log4cxx/private/atomic_shared_ptr.h>
 #include <memory>
+#include <atomic>
+#include <vector>
 
 namespace log4cxx
 {
@@ -30,13 +33,21 @@ struct AppenderSkeleton::AppenderSkeletonPrivate
 	AppenderSkeletonPrivate() :
 		threshold(Level::getAll()),
 		errorHandler(std::make_shared<log4cxx::helpers::OnlyOnceErrorHandler>()),
-		closed(false) {}
+		closed(false),
+		concurrent(false)
+	{
+		publishSettings();
+	}
 
 	AppenderSkeletonPrivate( LayoutPtr lay ) :
 		layout( lay ),
 		threshold(Level::getAll()),
 		errorHandler(std::make_shared<log4cxx::helpers::OnlyOnceErrorHandler>()),
-		closed(false) {}
+		closed(false),
+		concurrent(false)
+	{
+		publishSettings();
+	}
 
 	virtual ~AppenderSkeletonPrivate(){}
 
@@ -63,10 +74,45 @@ struct AppenderSkeleton::AppenderSkeletonPrivate
 	/** The last filter in the filter chain. */
 	spi::FilterPtr tailFilter;
 
+	/**
+	The threshold, filter chain and error handler read without locking the mutex.
+	*/
+	struct Settings
+	{
+		LevelPtr threshold;
+		std::vector<spi::FilterPtr> filters;
+		spi::ErrorHandlerPtr errorHandler;
+	};
+
+	/**
+	A copy of the current settings, replaced (with the mutex locked) when one of them changes.
+	Used by a concurrent appender and by accessors which do not lock the mutex.
+	*/
+	helpers::AtomicSharedPtr<const Settings> snapshot;
+
+	void publishSettings()
+	{
+		auto settings = std::make_shared<Settings>();
+		settings->threshold = threshold;
+		settings->errorHandler = errorHandler;
+
+		for (auto f = headFilter; f; f = f->getNext())
+		{
+			settings->filters.push_back(f);
+		}
+
+		snapshot.store(settings);
+	}
+
 	/**
 	Is this appender closed?
 	*/
-	bool closed;
+	std::atomic<bool> closed;
+
+	/**
+	Is doAppend called without locking the mutex?
+	*/
+	std::atomic<bool> concurrent;
 
 	log4cxx::helpers::Pool pool;
 	mutable std::recursive_mutex mutex;
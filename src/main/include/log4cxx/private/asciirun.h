@@ -0,0 +1,150 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _LOG4CXX_ASCII_RUN_H
+#define _LOG4CXX_ASCII_RUN_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+namespace log4cxx
+{
+namespace helpers
+{
+
+/**
+ * Bulk handling of runs of ASCII characters, of which most logged text consists.
+ *
+ * Blocks of characters are checked and converted using AVX2 instructions
+ * when the processor supports them, otherwise SSE2 on x86-64 or NEON on AArch64.
+ * Other processors use a character at a time.
+ * Runs of characters that need no escaping in a JSON string are found the same way.
+ */
+class AsciiRun
+{
+	public:
+		/**
+		 * The number of leading characters of the \c count characters at \c src
+		 * that are less than 0x80.
+		 */
+		static size_t length(const uint8_t* src, size_t count);
+		static size_t length(const uint16_t* src, size_t count);
+		static size_t length(const uint32_t* src, size_t count);
+
+		/**
+		 * The number of leading characters of the \c count characters at \c src
+		 * that are not escaped in a JSON string, that is,
+		 * other than a double quote, backslash, backspace, tab, newline, form feed or carriage return.
+		 */
+		static size_t unescapedLength(const uint8_t* src, size_t count);
+		static size_t unescapedLength(const uint16_t* src, size_t count);
+		static size_t unescapedLength(const uint32_t* src, size_t count);
+
+		/**
+		 * Store at \c dst the \c count ASCII characters at \c src.
+		 */
+		static void copy(const uint8_t* src, size_t count, uint16_t* dst);
+		static void copy(const uint8_t* src, size_t count, uint32_t* dst);
+		static void copy(const uint16_t* src, size_t count, uint8_t* dst);
+		static void copy(const uint32_t* src, size_t count, uint8_t* dst);
+
+		static void copy(const uint8_t* src, size_t count, uint8_t* dst)
+		{
+			std::memcpy(dst, src, count);
+		}
+
+		template <class Src, class Dst>
+		static void copy(const Src* src, size_t count, Dst* dst)
+		{
+			for (size_t i = 0; i < count; ++i)
+			{
+				dst[i] = static_cast<Dst>(src[i]);
+			}
+		}
+
+		/**
+		 * Store at \c dst the \c count ASCII characters at \c src.
+		 */
+		template <class SrcChar, class DstChar>
+		static void convert(const SrcChar* src, size_t count, DstChar* dst)
+		{
+			copy(units(src), count, units(dst));
+		}
+
+		/**
+		 * The number of leading ASCII characters of the \c count characters at \c src.
+		 */
+		template <class Char>
+		static size_t length(const Char* src, size_t count)
+		{
+			return length(units(src), count);
+		}
+
+		/**
+		 * The number of leading characters of the \c count characters at \c src
+		 * that are not escaped in a JSON string.
+		 */
+		template <class Char>
+		static size_t unescapedLength(const Char* src, size_t count)
+		{
+			return unescapedLength(units(src), count);
+		}
+
+		/**
+		 * Append to \c dst the leading ASCII characters of the \c count characters at \c src.
+		 * @return the number of characters appended.
+		 */
+		template <class String, class Char>
+		static size_t append(String& dst, const Char* src, size_t count)
+		{
+			size_t result = length(units(src), count);
+
+			if (0 < result)
+			{
+				size_t start = dst.size();
+				dst.resize(start + result);
+				convert(src, result, &dst[start]);
+			}
+
+			return result;
+		}
+
+	private:
+		template <size_t Size> struct Unit;
+
+		template <class Char>
+		static const typename Unit<sizeof(Char)>::type* units(const Char* p)
+		{
+			return reinterpret_cast<const typename Unit<sizeof(Char)>::type*>(p);
+		}
+
+		template <class Char>
+		static typename Unit<sizeof(Char)>::type* units(Char* p)
+		{
+			return reinterpret_cast<typename Unit<sizeof(Char)>::type*>(p);
+		}
+};
+
+template <> struct AsciiRun::Unit<1> { typedef uint8_t type; };
+template <> struct AsciiRun::Unit<2> { typedef uint16_t type; };
+template <> struct AsciiRun::Unit<4> { typedef uint32_t type; };
+
+} // namespace helpers
+} // namespace log4cxx
+
+#endif //_LOG4CXX_ASCII_RUN_H
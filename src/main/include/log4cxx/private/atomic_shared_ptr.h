@@ -0,0 +1,76 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _LOG4CXX_ATOMIC_SHARED_PTR_H
+#define _LOG4CXX_ATOMIC_SHARED_PTR_H
+
+#include <memory>
+#include <atomic>
+
+namespace log4cxx
+{
+namespace helpers
+{
+
+/**
+ * A shared_ptr which threads may load and store concurrently.
+ *
+ * Uses std::atomic<std::shared_ptr> when the standard library provides it,
+ * otherwise the std::atomic_load and std::atomic_store overloads.
+ */
+template <class T>
+class AtomicSharedPtr
+{
+	public:
+		AtomicSharedPtr() {}
+
+		AtomicSharedPtr(const std::shared_ptr<T>& initialValue)
+			: value(initialValue) {}
+
+		std::shared_ptr<T> load() const
+		{
+#if defined(__cpp_lib_atomic_shared_ptr)
+			return value.load(std::memory_order_acquire);
+#else
+			return std::atomic_load_explicit(&value, std::memory_order_acquire);
+#endif
+		}
+
+		void store(const std::shared_ptr<T>& newValue)
+		{
+#if defined(__cpp_lib_atomic_shared_ptr)
+			value.store(newValue, std::memory_order_release);
+#else
+			std::atomic_store_explicit(&value, newValue, std::memory_order_release);
+#endif
+		}
+
+	private:
+#if defined(__cpp_lib_atomic_shared_ptr)
+		std::atomic<std::shared_ptr<T>> value;
+#else
+		std::shared_ptr<T> value;
+#endif
+
+		AtomicSharedPtr(const AtomicSharedPtr&) = delete;
+		AtomicSharedPtr& operator=(const AtomicSharedPtr&) = delete;
+};
+
+} // namespace helpers
+} // namespace log4cxx
+
+#endif //_LOG4CXX_ATOMIC_SHARED_PTR_H
@@ -0,0 +1,145 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _LOG4CXX_BINARY_JOURNAL_H
+#define _LOG4CXX_BINARY_JOURNAL_H
+
+#include <cstdint>
+#include <string>
+
+namespace log4cxx
+{
+namespace helpers
+{
+
+/**
+ * The layout of a file written by BinaryJournalAppender.
+ *
+ * A journal is a sequence of records, each of which is
+ * a varint byte count, a type byte and the fields of that type.
+ * Integers are unsigned LEB128 varints, signed integers are zigzag encoded,
+ * and strings are a varint byte count followed by UTF-8 bytes.
+ *
+ * Every session starts with a Header record, which resets the dictionary
+ * and the timestamp base, so a journal may be appended to.
+ * A Dictionary record assigns an identifier to a string
+ * which later records refer to by that identifier.
+ */
+namespace BinaryJournal
+{
+enum RecordType
+{
+	/** The Magic bytes followed by the Version. */
+	Header = 0,
+
+	/** An identifier followed by the bytes of the string, without a byte count. */
+	Dictionary = 1,
+
+	/** The fields of a logging event. */
+	Event = 2
+};
+
+/** The flags of an Event record. */
+enum EventFlags
+{
+	HasNDC = 1,
+	HasLocation = 2
+};
+
+static const char Magic[] = { 'l', '4', 'x', 'j' };
+static const unsigned Version = 1;
+
+/** The largest record, including its type byte, a reader accepts. */
+static const uint64_t MaxRecordSize = 256 * 1024 * 1024;
+
+inline void putVarint(std::string& dest, uint64_t value)
+{
+	while (0x80 <= value)
+	{
+		dest.push_back(static_cast<char>((value & 0x7F) | 0x80));
+		value >>= 7;
+	}
+
+	dest.push_back(static_cast<char>(value));
+}
+
+inline void putSignedVarint(std::string& dest, int64_t value)
+{
+	putVarint(dest, (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63));
+}
+
+inline void putString(std::string& dest, const char* data, size_t size)
+{
+	putVarint(dest, size);
+	dest.append(data, size);
+}
+
+/**
+ * Extract a varint from [\c next, \c end).
+ *
+ * @return false if the bytes end before the varint.
+ */
+inline bool getVarint(const char*& next, const char* end, uint64_t& value)
+{
+	value = 0;
+
+	for (int shift = 0; next < end && shift < 64; shift += 7)
+	{
+		uint64_t byte = static_cast<unsigned char>(*next++);
+		value |= (byte & 0x7F) << shift;
+
+		if (byte < 0x80)
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
+
+inline bool getSignedVarint(const char*& next, const char* end, int64_t& value)
+{
+	uint64_t zigzag;
+
+	if (!getVarint(next, end, zigzag))
+	{
+		return false;
+	}
+
+	value = static_cast<int64_t>(zigzag >> 1) ^ -static_cast<int64_t>(zigzag & 1);
+	return true;
+}
+
+inline bool getString(const char*& next, const char* end, std::string& value)
+{
+	uint64_t size;
+
+	if (!getVarint(next, end, size) || static_cast<uint64_t>(end - next) < size)
+	{
+		return false;
+	}
+
+	value.assign(next, static_cast<size_t>(size));
+	next += size;
+	return true;
+}
+
+} // namespace BinaryJournal
+} // namespace helpers
+} // namespace log4cxx
+
+#endif //_LOG4CXX_BINARY_JOURNAL_H
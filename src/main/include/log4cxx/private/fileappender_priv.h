@@ -20,9 +20,17 @@
 
 #include <log4cxx/private/writerappender_priv.h>
 #include <log4cxx/fileappender.h>
+#include <log4cxx/helpers/mappedfileoutputstream.h>
+#include <log4cxx/helpers/iouringfileoutputstream.h>
+#include <atomic>
+#include <climits>
 
 namespace log4cxx
 {
+namespace helpers
+{
+class GroupCommit;
+}
 
 struct FileAppender::FileAppenderPriv : public WriterAppender::WriterAppenderPriv
 {
@@ -38,6 +46,15 @@ struct FileAppender::FileAppenderPriv : public WriterAppender::WriterAppenderPri
 		, fileName(_fileName)
 		, bufferedIO(_bufferedIO)
 		, bufferSize(_bufferSize)
+		, maxFlushDelay(0)
+		, memoryMapped(false)
+		, mappedExtentSize(helpers::MappedFileOutputStream::DefaultExtentSize)
+		, ioUring(false)
+		, ioUringQueueDepth(helpers::IOUringFileOutputStream::DefaultQueueDepth)
+		, syncInterval(0)
+		, syncSize(0)
+		, syncThreshold(INT_MAX)
+		, unflushed(false)
 		{}
 
 	/** Append to or truncate the file? The default value for this
@@ -60,6 +77,54 @@ struct FileAppender::FileAppenderPriv : public WriterAppender::WriterAppenderPri
 	/**
 	How big should the IO buffer be? Default is 8K. */
 	int bufferSize;
+
+	/**
+	The maximum time (in milliseconds) an event may remain in the IO buffer. */
+	int maxFlushDelay;
+
+	/**
+	The name of the periodic task that flushes the IO buffer. */
+	LogString flushTaskName;
+
+	/**
+	Write to a memory mapped region of the file? */
+	bool memoryMapped;
+
+	/**
+	The number of bytes by which a memory mapped file is extended. */
+	size_t mappedExtentSize;
+
+	/**
+	Write asynchronously using io_uring? */
+	bool ioUring;
+
+	/**
+	The number of buffers that may be waiting to be written using io_uring. */
+	int ioUringQueueDepth;
+
+	/**
+	The maximum time (in milliseconds) written bytes remain unsynchronized. */
+	int syncInterval;
+
+	/**
+	The number of unsynchronized bytes that causes a sync. */
+	size_t syncSize;
+
+	/**
+	Events at or above this level wait for a sync. */
+	LevelPtr syncLevel;
+
+	/**
+	Synchronizes the file when required by the above options. */
+	std::shared_ptr<helpers::GroupCommit> groupCommit;
+
+	/**
+	The integer value of the sync level of the open file. */
+	std::atomic<int> syncThreshold;
+
+	/**
+	Has an event been written since the periodic task last flushed the buffer? */
+	bool unflushed;
 };
 
 }
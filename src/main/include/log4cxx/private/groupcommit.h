@@ -0,0 +1,158 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _LOG4CXX_GROUP_COMMIT_H
+#define _LOG4CXX_GROUP_COMMIT_H
+
+#include <log4cxx/fileappender.h>
+#include <log4cxx/helpers/outputstream.h>
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+namespace log4cxx
+{
+namespace helpers
+{
+
+/**
+ * Makes the bytes written to a file durable by calling a sync function
+ * (for example, fdatasync) on a background thread.
+ *
+ * The file is synchronized when it has unsynchronized bytes and
+ * the sync interval has elapsed, at least syncSize bytes were written
+ * or a thread is waiting in #waitDurable.
+ * Threads that wait while a sync is in progress share the next sync,
+ * so a single sync can make many events durable (a group commit).
+ * Bytes whose sync failed are never considered durable,
+ * even if a later sync succeeds, as the system may have discarded them.
+ *
+ * Positions are byte counts that keep increasing as files are replaced.
+ */
+class GroupCommit
+{
+	public:
+		typedef std::function<log4cxx_status_t()> SyncFunction;
+
+		/**
+		 * Start the sync thread.
+		 *
+		 * @param intervalMillis The maximum time (in milliseconds) bytes remain unsynchronized,
+		 * or zero for no time limit.
+		 * @param syncSize The number of unsynchronized bytes that triggers a sync,
+		 * or zero for no limit.
+		 */
+		GroupCommit(int intervalMillis, size_t syncSize);
+
+		/**
+		 * Stop the sync thread and log the sync statistics.
+		 */
+		~GroupCommit();
+
+		/**
+		 * Change the maximum time bytes remain unsynchronized and
+		 * the number of unsynchronized bytes that triggers a sync.
+		 */
+		void setPolicy(int intervalMillis, size_t syncSize);
+
+		/**
+		 * Use \c sync to make bytes written from now on durable.
+		 */
+		void attach(const SyncFunction& sync);
+
+		/**
+		 * Synchronize bytes written so far and stop using the current sync function.
+		 * Called before the file is closed.
+		 */
+		void detach();
+
+		/**
+		 * Add \c byteCount to the number of bytes written.
+		 */
+		void written(size_t byteCount);
+
+		/**
+		 * The number of bytes written.
+		 */
+		uint64_t getPosition() const;
+
+		/**
+		 * Block the calling thread until the bytes before \c position are durable
+		 * or a sync of them failed.
+		 * @return zero or the status of the failed sync.
+		 */
+		log4cxx_status_t waitDurable(uint64_t position);
+
+		/**
+		 * The number and duration of syncs so far.
+		 */
+		FileAppender::SyncStatistics getStatistics() const;
+
+	private:
+		void run();
+		void sync(std::unique_lock<std::mutex>& lock);
+
+		std::chrono::milliseconds interval;
+		std::atomic<uint64_t> syncSize;
+		std::atomic<uint64_t> position;
+		std::atomic<uint64_t> durable;
+		std::atomic<uint64_t> failed;
+		log4cxx_status_t failure;
+		std::atomic<bool> sizeReached;
+		uint64_t requested;
+		bool syncing;
+		bool stopping;
+		SyncFunction syncFunction;
+		FileAppender::SyncStatistics statistics;
+		mutable std::mutex mutex;
+		std::condition_variable due;
+		std::condition_variable done;
+		std::thread thread;
+};
+
+/**
+ * An OutputStream that counts the bytes passed to a GroupCommit.
+ */
+class GroupCommitOutputStream : public OutputStream
+{
+	public:
+		/**
+		 * Attach \c sync (which makes bytes written to \c os durable) to \c commit.
+		 */
+		GroupCommitOutputStream
+			( const OutputStreamPtr& os
+			, const std::shared_ptr<GroupCommit>& commit
+			, const GroupCommit::SyncFunction& sync
+			);
+		~GroupCommitOutputStream();
+
+		void close(Pool& p) override;
+		void flush(Pool& p) override;
+		void write(ByteBuffer& buf, Pool& p) override;
+
+	private:
+		OutputStreamPtr os;
+		std::shared_ptr<GroupCommit> commit;
+		bool attached;
+};
+
+} // namespace helpers
+} // namespace log4cxx
+
+#endif
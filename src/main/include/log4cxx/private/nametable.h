@@ -0,0 +1,62 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _LOG4CXX_NAME_TABLE_H
+#define _LOG4CXX_NAME_TABLE_H
+
+#include <log4cxx/logstring.h>
+#include <cstdint>
+
+namespace log4cxx
+{
+namespace helpers
+{
+
+/**
+ * Logger and thread names shared by logging events.
+ *
+ * An entry is never removed, so a reference to it remains valid
+ * after the logger or thread that used the name has gone.
+ */
+class NameTable
+{
+	public:
+		struct Entry
+		{
+			Entry(const LogString& name1, uint32_t id1) : name(name1), id(id1) {}
+
+			const LogString name;
+
+			/** A small integer unique to this name, starting at zero. */
+			const uint32_t id;
+		};
+
+		/**
+		 * The entry for \c name, added if not present.
+		 */
+		static const Entry& intern(const LogString& name);
+
+		/**
+		 * The entry with identifier \c id or null if there is none.
+		 */
+		static const Entry* find(uint32_t id);
+};
+
+} // namespace helpers
+} // namespace log4cxx
+
+#endif //_LOG4CXX_NAME_TABLE_H
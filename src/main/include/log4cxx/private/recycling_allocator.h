@@ -0,0 +1,281 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _LOG4CXX_RECYCLING_ALLOCATOR_H
+#define _LOG4CXX_RECYCLING_ALLOCATOR_H
+
+#include <atomic>
+#include <cstddef>
+#include <new>
+
+namespace log4cxx
+{
+namespace helpers
+{
+
+/**
+ * A cache of released memory blocks of \c Size bytes.
+ *
+ * A released block is kept by the releasing thread for its next allocation.
+ * When that thread already holds MaxLocalBlocks blocks, or is exiting,
+ * the block goes on a lock-free list shared by all threads,
+ * from which a thread holding no blocks takes up to MaxLocalBlocks blocks at once.
+ * Blocks released on the AsyncAppender dispatcher thread
+ * are thereby returned to the logging threads.
+ * A block released when the shared list holds MaxSharedBlocks blocks
+ * is returned to the system, so a burst of events does not stay resident.
+ */
+template <size_t Size, size_t Align>
+class BlockPool
+{
+	public:
+		static void* allocate()
+		{
+			LocalList& list = getLocalList();
+
+			if (!list.head && !list.closed)
+			{
+				ensureFlushed();
+				takeShared(list);
+			}
+
+			if (Block* result = list.head)
+			{
+				list.head = result->next;
+
+				if (0 < list.count)
+				{
+					--list.count;
+				}
+
+				return result;
+			}
+
+			return ::operator new(BlockSize);
+		}
+
+		static void deallocate(void* p)
+		{
+			Block* block = static_cast<Block*>(p);
+			LocalList& list = getLocalList();
+
+			if (!list.closed && list.count < MaxLocalBlocks)
+			{
+				ensureFlushed();
+				block->next = list.head;
+				list.head = block;
+				++list.count;
+			}
+			else
+			{
+				pushShared(block);
+			}
+		}
+
+	private:
+		struct Block
+		{
+			Block* next;
+		};
+
+		static constexpr size_t BlockSize = Size < sizeof(Block) ? sizeof(Block) : Size;
+		static_assert(Align <= alignof(std::max_align_t), "over-aligned types are not supported");
+
+		enum { MaxLocalBlocks = 256, MaxSharedBlocks = 4 * MaxLocalBlocks };
+
+		/**
+		 * Blocks held by a thread. Trivially destructible so that it remains
+		 * usable while other thread_local objects are destroyed.
+		 */
+		struct LocalList
+		{
+			Block* head;
+			size_t count;
+			bool closed;
+		};
+
+		/**
+		 * Moves a thread's blocks to the shared list when the thread exits.
+		 */
+		struct LocalListFlusher
+		{
+			~LocalListFlusher()
+			{
+				LocalList& list = getLocalList();
+				list.closed = true;
+
+				while (Block* block = list.head)
+				{
+					list.head = block->next;
+					pushShared(block);
+				}
+			}
+		};
+
+		static LocalList& getLocalList()
+		{
+			thread_local LocalList list;
+			return list;
+		}
+
+		static void ensureFlushed()
+		{
+			thread_local LocalListFlusher flusher;
+			(void)flusher;
+		}
+
+		static std::atomic<Block*>& getSharedList()
+		{
+			static std::atomic<Block*> list(0);
+			return list;
+		}
+
+		/**
+		 * The number of blocks on the shared list, or more while blocks are being taken.
+		 */
+		static std::atomic<size_t>& getSharedCount()
+		{
+			static std::atomic<size_t> count(0);
+			return count;
+		}
+
+		static void pushShared(Block* block)
+		{
+			std::atomic<size_t>& count = getSharedCount();
+
+			if (MaxSharedBlocks <= count.fetch_add(1, std::memory_order_relaxed))
+			{
+				count.fetch_sub(1, std::memory_order_relaxed);
+				::operator delete(block);
+				return;
+			}
+
+			pushSharedChain(block, block);
+		}
+
+		/**
+		 * Put the blocks from \c first to \c last on the shared list.
+		 */
+		static void pushSharedChain(Block* first, Block* last)
+		{
+			std::atomic<Block*>& list = getSharedList();
+			Block* head = list.load(std::memory_order_relaxed);
+
+			do
+			{
+				last->next = head;
+			}
+			while (!list.compare_exchange_weak(head, first, std::memory_order_release, std::memory_order_relaxed));
+		}
+
+		/**
+		 * Move up to MaxLocalBlocks blocks from the shared list to the empty \c list.
+		 * The whole list is taken at once, which avoids the ABA problem of
+		 * popping single blocks, and the excess is put back.
+		 */
+		static void takeShared(LocalList& list)
+		{
+			list.head = getSharedList().exchange(0, std::memory_order_acquire);
+			list.count = 0;
+
+			if (!list.head)
+			{
+				return;
+			}
+
+			Block* last = list.head;
+			size_t taken = 1;
+
+			while (last->next && taken < MaxLocalBlocks)
+			{
+				last = last->next;
+				++taken;
+			}
+
+			if (Block* excess = last->next)
+			{
+				last->next = 0;
+				Block* excessLast = excess;
+
+				while (excessLast->next)
+				{
+					excessLast = excessLast->next;
+				}
+
+				pushSharedChain(excess, excessLast);
+			}
+
+			list.count = taken;
+			getSharedCount().fetch_sub(taken, std::memory_order_relaxed);
+		}
+};
+
+/**
+ * A standard allocator which recycles single objects through a BlockPool.
+ * Use with std::allocate_shared to place an object and its
+ * reference count in one recycled block.
+ */
+template <class T>
+class RecyclingAllocator
+{
+	public:
+		typedef T value_type;
+
+		RecyclingAllocator() {}
+
+		template <class U>
+		RecyclingAllocator(const RecyclingAllocator<U>&) {}
+
+		T* allocate(size_t n)
+		{
+			if (n != 1)
+			{
+				return static_cast<T*>(::operator new(n * sizeof(T)));
+			}
+
+			return static_cast<T*>(BlockPool<sizeof(T), alignof(T)>::allocate());
+		}
+
+		void deallocate(T* p, size_t n)
+		{
+			if (n != 1)
+			{
+				::operator delete(p);
+			}
+			else
+			{
+				BlockPool<sizeof(T), alignof(T)>::deallocate(p);
+			}
+		}
+
+		template <class U>
+		bool operator==(const RecyclingAllocator<U>&) const
+		{
+			return true;
+		}
+
+		template <class U>
+		bool operator!=(const RecyclingAllocator<U>&) const
+		{
+			return false;
+		}
+};
+
+} // namespace helpers
+} // namespace log4cxx
+
+#endif //_LOG4CXX_RECYCLING_ALLOCATOR_H
@@ -16,6 +16,7 @@
  */
 
 #include <log4cxx/helpers/writer.h>
+#include <log4cxx/helpers/transcoder.h>
 #include <log4cxx/writerappender.h>
 #include <atomic>
 
@@ -73,6 +74,62 @@ struct WriterAppender::WriterAppenderPriv : public AppenderSkeleton::AppenderSke
 	*  This is the {@link Writer Writer} where we will write to.
 	*/
 	log4cxx::helpers::WriterPtr writer;
+
+	/**
+	*  Holds the formatted event. Retains its capacity between events.
+	*/
+	LogString buffer;
+
+#if !LOG4CXX_LOGCHAR_IS_UTF8
+	/**
+	*  Holds the UTF-8 encoded formatted event.
+	*/
+	std::string byteBuffer;
+#endif
+
+	/**
+	*  The largest buffer capacity retained after an event is written.
+	*/
+	enum { MaxRetainedBufferSize = 64 * 1024 };
+
+	/**
+	*  The empty \c buffer, released if an unusually large event enlarged it.
+	*/
+	template <class String>
+	static String& clearBuffer(String& buffer)
+	{
+		if (MaxRetainedBufferSize < buffer.capacity())
+		{
+			String().swap(buffer);
+		}
+		else
+		{
+			buffer.clear();
+		}
+
+		return buffer;
+	}
+
+#if !LOG4CXX_LOGCHAR_IS_UTF8
+	/**
+	*  Append the UTF-8 encoded output of the layout for \c event to \c bytes.
+	*  When the event shares the output of the layout with other appenders,
+	*  the shared text is encoded instead of formatting the event again.
+	*/
+	void formatUTF8(std::string& bytes, const spi::LoggingEventPtr& event, helpers::Pool& p)
+	{
+		if (event->isFormattedEventShared(layout->getFormatKey()))
+		{
+			auto& msg = clearBuffer(buffer);
+			layout->formatShared(msg, event, p);
+			helpers::Transcoder::encodeUTF8(msg, bytes);
+		}
+		else
+		{
+			layout->formatUTF8(bytes, event, p);
+		}
+	}
+#endif
 };
 
 }
@@ -80,6 +80,11 @@ class LOG4CXX_EXPORT MultiprocessRollingFileAppender : public FileAppender
 		*/
 		void subAppend(const spi::LoggingEventPtr& event, helpers::Pool& p) override;
 
+		/**
+		 Check the triggering policy before writing each event.
+		*/
+		void subAppend(const spi::LoggingEventList& events, helpers::Pool& p) override;
+
 		bool rolloverInternal(log4cxx::helpers::Pool& p);
 
 	public:
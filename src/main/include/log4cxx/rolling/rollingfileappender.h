@@ -179,8 +179,19 @@ class LOG4CXX_EXPORT RollingFileAppender : public FileAppender
 		*/
 		void subAppend(const spi::LoggingEventPtr& event, helpers::Pool& p) override;
 
+		/**
+		 Write the events between rollovers with a single write.
+		 The triggering policy is checked for each event, but the file length
+		 it is given does not include the preceding events of the group,
+		 so a size limit may be exceeded by up to one group of events.
+		*/
+		void subAppend(const spi::LoggingEventList& events, helpers::Pool& p) override;
+
 		bool rolloverInternal(log4cxx::helpers::Pool& p);
 
+	private:
+		void rolloverBefore(const spi::LoggingEventPtr& event, helpers::Pool& p);
+
 	public:
 		/**
 		 * The policy that implements the scheme for rolling over a log file.
@@ -129,6 +129,12 @@ class LOG4CXX_EXPORT LocationInfo
 		/** Returns the method name of the caller. */
 		const std::string getMethodName() const;
 
+		/**
+		 *   Returns the function signature from which the
+		 *   class and method names are extracted.
+		 */
+		const char* getFunctionName() const;
+
 
 	private:
 		/** Caller's line number. */
@@ -32,6 +32,7 @@ namespace log4cxx
 namespace helpers
 {
 class ObjectOutputStream;
+class DeferredMessage;
 }
 
 namespace spi
@@ -94,6 +95,48 @@ class LOG4CXX_EXPORT LoggingEvent :
 			const LevelPtr& level,   const LogString& message,
 			const log4cxx::spi::LocationInfo& location);
 
+		/**
+		Instantiate a LoggingEvent whose text is produced
+		by \c message when it is first requested.
+
+		@param logger The logger of this event.
+		@param level The level of this event.
+		@param location The source code location of the logging request.
+		@param message The source of the text of this event, moved into this event.
+		*/
+		LoggingEvent
+			( const LogString& logger
+			, const LevelPtr& level
+			, const spi::LocationInfo& location
+			, helpers::DeferredMessage&& message
+			);
+
+		/**
+		Instantiate a LoggingEvent from values recorded earlier,
+		for example by a BinaryJournalAppender.
+
+		@param logger The logger of this event.
+		@param level The level of this event.
+		@param message  The text of this event.
+		@param location The source code location of the logging request.
+		@param timeStamp The microseconds elapsed from 01.01.1970 when this event was created.
+		@param threadName The identifier of the thread that created this event.
+		@param threadUserName The name of the thread that created this event.
+		@param ndc The nested diagnostic context of this event or null.
+		@param mdc The mapped diagnostic context of this event.
+		*/
+		LoggingEvent
+			( const LogString& logger
+			, const LevelPtr& level
+			, const LogString& message
+			, const spi::LocationInfo& location
+			, log4cxx_time_t timeStamp
+			, const LogString& threadName
+			, const LogString& threadUserName
+			, const LogString* ndc
+			, const MDC::Map& mdc
+			);
+
 		~LoggingEvent();
 
 		/** Return the level of this event. */
@@ -195,6 +238,55 @@ class LOG4CXX_EXPORT LoggingEvent :
 		*/
 		void setProperty(const LogString& key, const LogString& value);
 
+		/**
+		* Allow text formatted for this event to be kept for use by other appenders.
+		* Called before the event is passed to any appender
+		* when it is to be formatted by more than one layout.
+		*
+		* @param keys identifies the layouts used by more than one appender,
+		* the only layouts whose output is kept.
+		*/
+		void shareFormattedText(const std::vector<const void*>& keys);
+
+		/**
+		* Is the output of layouts identified by \c key kept for other appenders?
+		*/
+		bool isFormattedEventShared(const void* key) const;
+
+		/**
+		* Append the text kept by keepFormattedEvent using \c key.
+		*
+		* @param key identifies layouts that produce the same output.
+		* @param dest string to which the text, if any, is appended.
+		* @return true if text was appended.
+		*/
+		bool getFormattedEvent(const void* key, LogString& dest) const;
+
+		/**
+		* Keep a copy of the \c length characters at \c text,
+		* the output of layouts identified by \c key, for use by other appenders.
+		* Text is kept only if isFormattedEventShared(key)
+		* and it is shorter than about a thousand bytes.
+		*/
+		void keepFormattedEvent(const void* key, const logchar* text, size_t length) const;
+
+		/**
+		* Append the text kept by keepFormattedField using \c key.
+		*
+		* @param key identifies pattern converters that produce the same output.
+		* @param dest string to which the text, if any, is appended.
+		* @return true if text was appended.
+		*/
+		bool getFormattedField(const void* key, LogString& dest) const;
+
+		/**
+		* Keep the \c length characters at \c text, the output of pattern converters
+		* identified by \c key, for use by other layouts.
+		* Only short text (for example, a formatted date) is kept,
+		* and only after shareFormattedText has been called.
+		*/
+		void keepFormattedField(const void* key, const logchar* text, size_t length) const;
+
 	private:
 		LOG4CXX_DECLARE_PRIVATE_MEMBER_PTR(LoggingEventPrivate, m_priv)
 
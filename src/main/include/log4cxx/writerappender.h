@@ -96,6 +96,17 @@ class LOG4CXX_EXPORT WriterAppender : public AppenderSkeleton
 		*/
 		void append(const spi::LoggingEventPtr& event, helpers::Pool& p) override;
 
+		/**
+		This method is called by the AppenderSkeleton#doAppend
+		method with a group of events.
+
+		<p>When #isGroupWritable is true, the formatted events are written
+		to the output stream with a single write.
+		Otherwise each event is passed to the single event <code>append</code>,
+		so a derived class sees every event in the overrides it provides.
+		*/
+		void append(const spi::LoggingEventList& events, helpers::Pool& p) override;
+
 
 	protected:
 		/**
@@ -177,6 +188,22 @@ class LOG4CXX_EXPORT WriterAppender : public AppenderSkeleton
 		*/
 		virtual void subAppend(const spi::LoggingEventPtr& event, log4cxx::helpers::Pool& p);
 
+		/**
+		 Actual writing of a group of events occurs here.
+		 Unless #isGroupWritable is true,
+		 the single event <code>subAppend</code> is called for each event.
+		*/
+		virtual void subAppend(const spi::LoggingEventList& events, log4cxx::helpers::Pool& p);
+
+		/**
+		 Can a group of events be written by the group <code>subAppend</code>?
+		 True unless overridden.
+		 A derived class that overrides the single event <code>subAppend</code>
+		 (or <code>append</code>) but not the group <code>subAppend</code>
+		 should return false, so it sees every event.
+		*/
+		virtual bool isGroupWritable() const;
+
 
 		/**
 		Write a footer as produced by the embedded layout's
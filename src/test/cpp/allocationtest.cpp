@@ -0,0 +1,119 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <log4cxx/logger.h>
+#include <log4cxx/fileappender.h>
+#include <log4cxx/patternlayout.h>
+#include <log4cxx/helpers/pool.h>
+#include "logunit.h"
+#include <cstdlib>
+#include <new>
+
+using namespace log4cxx;
+using namespace log4cxx::helpers;
+
+namespace
+{
+/** The number of heap allocations made by the current thread. */
+thread_local size_t allocationCount = 0;
+}
+
+void* operator new(std::size_t size)
+{
+	++allocationCount;
+	if (void* result = std::malloc(size ? size : 1))
+		return result;
+	throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept
+{
+	std::free(p);
+}
+
+void operator delete(void* p, std::size_t) noexcept
+{
+	std::free(p);
+}
+
+/**
+ * Checks the heap allocations made on the steady-state logging path.
+ */
+LOGUNIT_CLASS(AllocationTest)
+{
+	LOGUNIT_TEST_SUITE(AllocationTest);
+	LOGUNIT_TEST(testFileAppender);
+	LOGUNIT_TEST(testEncodedFileAppender);
+	LOGUNIT_TEST_SUITE_END();
+
+public:
+	void tearDown()
+	{
+		Logger::getRootLogger()->getLoggerRepository()->resetConfiguration();
+	}
+
+	/**
+	 * Once warmed up, logging to a file does not allocate.
+	 */
+	void testFileAppender()
+	{
+		LOGUNIT_ASSERT_EQUAL(0, countSteadyStateAllocations(LogString()));
+	}
+
+	/**
+	 * Once warmed up, logging to a file in an encoding
+	 * which differs from the internal representation does not allocate.
+	 */
+	void testEncodedFileAppender()
+	{
+		LOGUNIT_ASSERT_EQUAL(0, countSteadyStateAllocations(LOG4CXX_STR("UTF-16")));
+	}
+
+private:
+	int countSteadyStateAllocations(const LogString& encoding)
+	{
+		Pool p;
+		auto appender = std::make_shared<FileAppender>();
+		appender->setFile(LOG4CXX_STR("output/allocationtest.log"));
+		appender->setAppend(false);
+		appender->setEncoding(encoding);
+		appender->setLayout(std::make_shared<PatternLayout>(LOG4CXX_STR("%d %-5p [%t] %c - %m%n")));
+		appender->activateOptions(p);
+
+		auto logger = Logger::getLogger(LOG4CXX_STR("org.example.allocation"));
+		logger->setAdditivity(false);
+		logger->removeAllAppenders();
+		logger->addAppender(appender);
+
+		// Short enough to fit the small string buffer of every character type
+		const std::string message("Hi");
+		for (int i = 0; i < 100; ++i)
+		{
+			logger->info(message);
+		}
+
+		auto startCount = allocationCount;
+
+		for (int i = 0; i < 100; ++i)
+		{
+			logger->info(message);
+		}
+
+		return int(allocationCount - startCount);
+	}
+};
+
+LOGUNIT_TEST_SUITE_REGISTRATION(AllocationTest);
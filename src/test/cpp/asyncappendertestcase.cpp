@@ -32,6 +32,8 @@
 #include <log4cxx/spi/location/locationinfo.h>
 #include <log4cxx/xml/domconfigurator.h>
 #include <log4cxx/file.h>
+#include <atomic>
+#include <condition_variable>
 
 using namespace log4cxx;
 using namespace log4cxx::helpers;
@@ -63,6 +65,81 @@ class NullPointerAppender : public AppenderSkeleton
 		}
 };
 
+/**
+ * Appender that only counts the events it receives.
+ */
+class CountingAppender : public AppenderSkeleton
+{
+	public:
+		std::atomic<int> count;
+
+		CountingAppender() : count(0)
+		{
+		}
+
+		void append(const spi::LoggingEventPtr&, log4cxx::helpers::Pool&) override
+		{
+			++count;
+		}
+
+		void close() override
+		{
+		}
+
+		bool requiresLayout() const override
+		{
+			return false;
+		}
+};
+
+LOG4CXX_PTR_DEF(CountingAppender);
+
+/**
+ * Appender that records how many threads are in append at the same time.
+ */
+class ConcurrentAppender : public AppenderSkeleton
+{
+	public:
+		std::atomic<int> count;
+		std::atomic<int> inside;
+		std::atomic<int> maxInside;
+
+		ConcurrentAppender() : count(0), inside(0), maxInside(0)
+		{
+			setConcurrent(true);
+		}
+
+		void append(const spi::LoggingEventPtr&, log4cxx::helpers::Pool&) override
+		{
+			int current = ++inside;
+			int previous = maxInside;
+
+			while (previous < current && !maxInside.compare_exchange_weak(previous, current))
+			{
+			}
+
+			// Wait (for up to a second) for another thread to arrive
+			for (int i = 0; i < 1000 && maxInside < 2; ++i)
+			{
+				std::this_thread::sleep_for( std::chrono::milliseconds( 1 ) );
+			}
+
+			++count;
+			--inside;
+		}
+
+		void close() override
+		{
+		}
+
+		bool requiresLayout() const override
+		{
+			return false;
+		}
+};
+
+LOG4CXX_PTR_DEF(ConcurrentAppender);
+
 /**
  * Vector appender that can be explicitly blocked.
  */
@@ -108,6 +185,39 @@ class BlockableVectorAppender : public VectorAppender
 
 LOG4CXX_PTR_DEF(BlockableVectorAppender);
 
+/**
+ * Vector appender that appends an event only when allowed by step().
+ */
+class SteppingVectorAppender : public VectorAppender
+{
+	private:
+		std::mutex mutex;
+		std::condition_variable allowed;
+		int permits = 0;
+	public:
+		void append(const spi::LoggingEventPtr& event, log4cxx::helpers::Pool& p) override
+		{
+			{
+				std::unique_lock<std::mutex> lock(mutex);
+				allowed.wait(lock, [this]() { return 0 < permits; });
+				--permits;
+			}
+			VectorAppender::append(event, p);
+		}
+
+		/**
+		 * Allow \c count more events to be appended.
+		 */
+		void step(int count)
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			permits += count;
+			allowed.notify_all();
+		}
+};
+
+LOG4CXX_PTR_DEF(SteppingVectorAppender);
+
 #if APR_HAS_THREADS
 /**
  * Tests of AsyncAppender.
@@ -127,6 +237,17 @@ class AsyncAppenderTestCase : public AppenderSkeletonTestCase
 		LOGUNIT_TEST(testBadAppender);
 		LOGUNIT_TEST(testLocationInfoTrue);
 		LOGUNIT_TEST(testConfiguration);
+		LOGUNIT_TEST(testRingBufferMultiThread);
+		LOGUNIT_TEST(testRingBufferNonBlocking);
+		LOGUNIT_TEST(testOverflowPolicyOptions);
+		LOGUNIT_TEST(testDropOldest);
+		LOGUNIT_TEST(testDropBelowLevel);
+		LOGUNIT_TEST(testBoundedWait);
+		LOGUNIT_TEST(testLowWatermark);
+		LOGUNIT_TEST(testDispatchPerAppender);
+		LOGUNIT_TEST(testConcurrentAppender);
+		LOGUNIT_TEST(testConcurrentAsyncAppender);
+		LOGUNIT_TEST(testAppendAfterClose);
 		LOGUNIT_TEST_SUITE_END();
 
 #ifdef _DEBUG
@@ -320,6 +441,412 @@ class AsyncAppenderTestCase : public AppenderSkeletonTestCase
 			// LOGUNIT_ASSERT_EQUAL(true, vectorAppender->isClosed());
 		}
 
+		/**
+		 * Checks no events are lost by a blocking ring buffer
+		 * which is much smaller than the number of events.
+		 */
+		void testRingBufferMultiThread()
+		{
+			const int THREAD_COUNT = 4;
+			const int LEN = 10;
+			LoggerPtr root = Logger::getRootLogger();
+			VectorAppenderPtr vectorAppender = VectorAppenderPtr(new VectorAppender());
+			AsyncAppenderPtr asyncAppender = AsyncAppenderPtr(new AsyncAppender());
+			asyncAppender->setName(LOG4CXX_STR("async-testRingBufferMultiThread"));
+			asyncAppender->addAppender(vectorAppender);
+			asyncAppender->setOption(LOG4CXX_STR("RingBuffer"), LOG4CXX_STR("true"));
+			asyncAppender->setBufferSize(5);
+			Pool p;
+			asyncAppender->activateOptions(p);
+			LOGUNIT_ASSERT_EQUAL(true, asyncAppender->getRingBuffer());
+			root->addAppender(asyncAppender);
+
+			std::vector<std::thread> threads;
+
+			for (int t = 0; t < THREAD_COUNT; ++t)
+			{
+				threads.emplace_back([root, LEN]()
+				{
+					for (int i = 0; i < LEN; ++i)
+					{
+						LOG4CXX_INFO(root, "message" << i);
+					}
+				});
+			}
+
+			for (auto& t : threads)
+			{
+				t.join();
+			}
+
+			asyncAppender->close();
+
+			const std::vector<spi::LoggingEventPtr>& v = vectorAppender->getVector();
+			LOGUNIT_ASSERT_EQUAL((size_t) (THREAD_COUNT * LEN), v.size());
+			LOGUNIT_ASSERT_EQUAL(true, vectorAppender->isClosed());
+		}
+
+		/**
+		 * Tests non-blocking behavior of the ring buffer.
+		 */
+		void testRingBufferNonBlocking()
+		{
+			BlockableVectorAppenderPtr blockableAppender = BlockableVectorAppenderPtr(new BlockableVectorAppender());
+			blockableAppender->setName(LOG4CXX_STR("async-blockableVector"));
+			AsyncAppenderPtr async = AsyncAppenderPtr(new AsyncAppender());
+			async->setName(LOG4CXX_STR("async-testRingBufferNonBlocking"));
+			async->addAppender(blockableAppender);
+			async->setBufferSize(5);
+			async->setBlocking(false);
+			async->setRingBuffer(true);
+			Pool p;
+			async->activateOptions(p);
+			LoggerPtr rootLogger = Logger::getRootLogger();
+			rootLogger->addAppender(async);
+			{
+				std::unique_lock<std::mutex> sync(blockableAppender->getBlocker());
+
+				for (int i = 0; i < 140; i++)
+				{
+					LOG4CXX_INFO(rootLogger, "Hello, World");
+					std::this_thread::sleep_for( std::chrono::milliseconds( 1 ) );
+				}
+
+				LOG4CXX_ERROR(rootLogger, "That's all folks.");
+			}
+			async->close();
+			const std::vector<spi::LoggingEventPtr>& events = blockableAppender->getVector();
+			LOGUNIT_ASSERT(events.size() > 0);
+			LoggingEventPtr initialEvent = events[0];
+			LoggingEventPtr discardEvent = events[events.size() - 1];
+			LOGUNIT_ASSERT(initialEvent->getMessage() == LOG4CXX_STR("Hello, World"));
+			LOGUNIT_ASSERT(discardEvent->getMessage().substr(0, 10) == LOG4CXX_STR("Discarded "));
+			LOGUNIT_ASSERT(0 < async->getDiscardedCount());
+		}
+
+		void testOverflowPolicyOptions()
+		{
+			AsyncAppenderPtr async = AsyncAppenderPtr(new AsyncAppender());
+			LOGUNIT_ASSERT(AsyncAppender::OverflowPolicy::Block == async->getOverflowPolicy());
+			async->setOption(LOG4CXX_STR("OverflowPolicy"), LOG4CXX_STR("DropOldest"));
+			LOGUNIT_ASSERT(AsyncAppender::OverflowPolicy::DropOldest == async->getOverflowPolicy());
+			LOGUNIT_ASSERT_EQUAL(false, async->getBlocking());
+			async->setOption(LOG4CXX_STR("overflowpolicy"), LOG4CXX_STR("boundedwait"));
+			LOGUNIT_ASSERT(AsyncAppender::OverflowPolicy::BoundedWait == async->getOverflowPolicy());
+			async->setOption(LOG4CXX_STR("Blocking"), LOG4CXX_STR("true"));
+			LOGUNIT_ASSERT(AsyncAppender::OverflowPolicy::Block == async->getOverflowPolicy());
+			LOGUNIT_ASSERT_EQUAL(async->getBufferSize() / 2, async->getLowWatermark());
+			async->setOption(LOG4CXX_STR("LowWatermark"), LOG4CXX_STR("32"));
+			LOGUNIT_ASSERT_EQUAL(32, async->getLowWatermark());
+			async->setOption(LOG4CXX_STR("DropThreshold"), LOG4CXX_STR("ERROR"));
+			LOGUNIT_ASSERT_EQUAL(Level::getError(), async->getDropThreshold());
+			async->setOption(LOG4CXX_STR("MaxBlockingTime"), LOG4CXX_STR("250"));
+			LOGUNIT_ASSERT_EQUAL(250, async->getMaxBlockingTime());
+		}
+
+		/**
+		 * Create an appender with a 5 event buffer
+		 * whose dispatcher is stalled in \c blockableAppender
+		 * by the lock held by \c sync.
+		 */
+		AsyncAppenderPtr createStalledAppender
+			( const LogString& name
+			, const BlockableVectorAppenderPtr& blockableAppender
+			, std::unique_lock<std::mutex>& sync
+			)
+		{
+			AsyncAppenderPtr async = AsyncAppenderPtr(new AsyncAppender());
+			async->setName(name);
+			async->addAppender(blockableAppender);
+			async->setBufferSize(5);
+			Pool p;
+			async->activateOptions(p);
+			LoggerPtr rootLogger = Logger::getRootLogger();
+			rootLogger->addAppender(async);
+			sync = std::unique_lock<std::mutex>(blockableAppender->getBlocker());
+			LOG4CXX_DEBUG(rootLogger, "stall");
+			std::this_thread::sleep_for( std::chrono::milliseconds( 100 ) );
+			return async;
+		}
+
+		void testDropOldest()
+		{
+			BlockableVectorAppenderPtr blockableAppender = BlockableVectorAppenderPtr(new BlockableVectorAppender());
+			std::unique_lock<std::mutex> sync;
+			AsyncAppenderPtr async = createStalledAppender(LOG4CXX_STR("async-testDropOldest"), blockableAppender, sync);
+			async->setOverflowPolicy(AsyncAppender::OverflowPolicy::DropOldest);
+			LoggerPtr rootLogger = Logger::getRootLogger();
+
+			for (int i = 0; i < 20; i++)
+			{
+				LOG4CXX_DEBUG(rootLogger, "message" << i);
+			}
+
+			LOGUNIT_ASSERT_EQUAL((size_t) 15, async->getDiscardedCount());
+			sync.unlock();
+			async->close();
+			const std::vector<spi::LoggingEventPtr>& events = blockableAppender->getVector();
+			LOGUNIT_ASSERT_EQUAL((size_t) 7, events.size());
+			LOGUNIT_ASSERT(events[1]->getMessage() == LOG4CXX_STR("message15"));
+			LOGUNIT_ASSERT(events[5]->getMessage() == LOG4CXX_STR("message19"));
+			LOGUNIT_ASSERT(events[6]->getMessage().substr(0, 13) == LOG4CXX_STR("Discarded 15 "));
+		}
+
+		void testDropBelowLevel()
+		{
+			BlockableVectorAppenderPtr blockableAppender = BlockableVectorAppenderPtr(new BlockableVectorAppender());
+			std::unique_lock<std::mutex> sync;
+			AsyncAppenderPtr async = createStalledAppender(LOG4CXX_STR("async-testDropBelowLevel"), blockableAppender, sync);
+			async->setOverflowPolicy(AsyncAppender::OverflowPolicy::DropBelowLevel);
+			LoggerPtr rootLogger = Logger::getRootLogger();
+
+			for (int i = 0; i < 15; i++)
+			{
+				LOG4CXX_DEBUG(rootLogger, "message" << i);
+			}
+
+			LOGUNIT_ASSERT_EQUAL((size_t) 10, async->getDiscardedCount());
+
+			std::atomic<bool> warned(false);
+			std::thread warner([rootLogger, &warned]()
+			{
+				LOG4CXX_WARN(rootLogger, "kept");
+				warned = true;
+			});
+			std::this_thread::sleep_for( std::chrono::milliseconds( 50 ) );
+			LOGUNIT_ASSERT_EQUAL(false, warned.load());
+			sync.unlock();
+			warner.join();
+			async->close();
+			LOGUNIT_ASSERT_EQUAL((size_t) 10, async->getDiscardedCount());
+			const std::vector<spi::LoggingEventPtr>& events = blockableAppender->getVector();
+			bool found = false;
+
+			for (auto& event : events)
+			{
+				if (event->getMessage() == LOG4CXX_STR("kept"))
+				{
+					found = true;
+				}
+			}
+
+			LOGUNIT_ASSERT(found);
+		}
+
+		void testBoundedWait()
+		{
+			BlockableVectorAppenderPtr blockableAppender = BlockableVectorAppenderPtr(new BlockableVectorAppender());
+			std::unique_lock<std::mutex> sync;
+			AsyncAppenderPtr async = createStalledAppender(LOG4CXX_STR("async-testBoundedWait"), blockableAppender, sync);
+			async->setOverflowPolicy(AsyncAppender::OverflowPolicy::BoundedWait);
+			async->setMaxBlockingTime(20);
+			LoggerPtr rootLogger = Logger::getRootLogger();
+
+			for (int i = 0; i < 5; i++)
+			{
+				LOG4CXX_DEBUG(rootLogger, "message" << i);
+			}
+
+			auto start = std::chrono::steady_clock::now();
+			LOG4CXX_DEBUG(rootLogger, "message5");
+			auto elapsed = std::chrono::steady_clock::now() - start;
+			LOGUNIT_ASSERT(std::chrono::milliseconds(20) <= elapsed);
+			LOGUNIT_ASSERT_EQUAL((size_t) 1, async->getDiscardedCount());
+			sync.unlock();
+			async->close();
+		}
+
+		/**
+		 * A producer waiting for space must also wait for
+		 * the events taken by the dispatcher to be appended.
+		 */
+		void testLowWatermark()
+		{
+			SteppingVectorAppenderPtr steppingAppender = SteppingVectorAppenderPtr(new SteppingVectorAppender());
+			AsyncAppenderPtr async = AsyncAppenderPtr(new AsyncAppender());
+			async->setName(LOG4CXX_STR("async-testLowWatermark"));
+			async->addAppender(steppingAppender);
+			async->setBufferSize(5);
+			async->setLowWatermark(2);
+			Pool p;
+			async->activateOptions(p);
+			LoggerPtr rootLogger = Logger::getRootLogger();
+			rootLogger->addAppender(async);
+
+			LOG4CXX_DEBUG(rootLogger, "stall");
+			std::this_thread::sleep_for( std::chrono::milliseconds( 50 ) );
+
+			for (int i = 0; i < 5; i++)
+			{
+				LOG4CXX_DEBUG(rootLogger, "message" << i);
+			}
+
+			std::atomic<bool> logged(false);
+			std::thread producer([rootLogger, &logged]()
+			{
+				LOG4CXX_DEBUG(rootLogger, "message5");
+				logged = true;
+			});
+			std::this_thread::sleep_for( std::chrono::milliseconds( 50 ) );
+			LOGUNIT_ASSERT_EQUAL(false, logged.load());
+
+			// The dispatcher appends "stall" then takes the five buffered events
+			steppingAppender->step(1);
+			std::this_thread::sleep_for( std::chrono::milliseconds( 250 ) );
+			LOGUNIT_ASSERT_EQUAL(false, logged.load());
+
+			steppingAppender->step(5);
+			producer.join();
+			steppingAppender->step(1);
+			async->close();
+			LOGUNIT_ASSERT_EQUAL((size_t) 7, steppingAppender->getVector().size());
+			LOGUNIT_ASSERT_EQUAL((size_t) 0, async->getDiscardedCount());
+		}
+
+
+		/**
+		 * A stalled appender must not hold back other appenders
+		 * when each has its own dispatcher.
+		 */
+		void testDispatchPerAppender()
+		{
+			BlockableVectorAppenderPtr blockableAppender = BlockableVectorAppenderPtr(new BlockableVectorAppender());
+			CountingAppenderPtr countingAppender = CountingAppenderPtr(new CountingAppender());
+			AsyncAppenderPtr async = AsyncAppenderPtr(new AsyncAppender());
+			async->setName(LOG4CXX_STR("async-testDispatchPerAppender"));
+			async->setOption(LOG4CXX_STR("DispatchPerAppender"), LOG4CXX_STR("true"));
+			LOGUNIT_ASSERT(async->getDispatchPerAppender());
+			async->addAppender(blockableAppender);
+			async->addAppender(countingAppender);
+			async->setBufferSize(5);
+			async->setBlocking(false);
+			Pool p;
+			async->activateOptions(p);
+			LoggerPtr rootLogger = Logger::getRootLogger();
+			rootLogger->addAppender(async);
+			std::unique_lock<std::mutex> sync(blockableAppender->getBlocker());
+			LOG4CXX_DEBUG(rootLogger, "stall");
+			std::this_thread::sleep_for( std::chrono::milliseconds( 100 ) );
+
+			for (int i = 0; i < 20; i++)
+			{
+				LOG4CXX_DEBUG(rootLogger, "message" << i);
+
+				// Let the unblocked dispatcher keep up
+				while (countingAppender->count < i + 2)
+				{
+					std::this_thread::sleep_for( std::chrono::milliseconds( 1 ) );
+				}
+			}
+
+			LOGUNIT_ASSERT_EQUAL((size_t) 15, async->getDiscardedCount(blockableAppender));
+			LOGUNIT_ASSERT_EQUAL((size_t) 0, async->getDiscardedCount(countingAppender));
+			LOGUNIT_ASSERT_EQUAL((size_t) 15, async->getDiscardedCount());
+			sync.unlock();
+			async->close();
+			LOGUNIT_ASSERT_EQUAL(21, countingAppender->count.load());
+			const std::vector<spi::LoggingEventPtr>& events = blockableAppender->getVector();
+			LOGUNIT_ASSERT_EQUAL((size_t) 7, events.size());
+			LOGUNIT_ASSERT(events[6]->getMessage().substr(0, 13) == LOG4CXX_STR("Discarded 15 "));
+		}
+
+		/**
+		 * Threads must be able to append to a concurrent appender at the same time,
+		 * the threshold still being applied.
+		 */
+		void testConcurrentAppender()
+		{
+			ConcurrentAppenderPtr appender = ConcurrentAppenderPtr(new ConcurrentAppender());
+			LOGUNIT_ASSERT(appender->isConcurrent());
+			LOGUNIT_ASSERT(!CountingAppenderPtr(new CountingAppender())->isConcurrent());
+			appender->setThreshold(Level::getInfo());
+			LoggerPtr logger = Logger::getLogger(LOG4CXX_STR("AsyncAppenderTestCase.testConcurrentAppender"));
+			logger->setAdditivity(false);
+			logger->addAppender(appender);
+			std::vector<std::thread> threads;
+
+			for (int i = 0; i < 2; ++i)
+			{
+				threads.emplace_back([logger]()
+				{
+					LOG4CXX_INFO(logger, "concurrent");
+					LOG4CXX_DEBUG(logger, "below threshold");
+				});
+			}
+
+			for (auto& t : threads)
+			{
+				t.join();
+			}
+
+			logger->removeAllAppenders();
+			LOGUNIT_ASSERT_EQUAL(2, appender->count.load());
+			LOGUNIT_ASSERT_EQUAL(2, appender->maxInside.load());
+		}
+
+		/**
+		 * An event that passed the closed check before the appender was closed
+		 * must not start a dispatcher.
+		 */
+		void testAppendAfterClose()
+		{
+			CountingAppenderPtr countingAppender = CountingAppenderPtr(new CountingAppender());
+			AsyncAppenderPtr async = AsyncAppenderPtr(new AsyncAppender());
+			async->addAppender(countingAppender);
+			Pool p;
+			async->activateOptions(p);
+			async->close();
+			spi::LoggingEventPtr event = spi::LoggingEventPtr(new spi::LoggingEvent(LOG4CXX_STR("AsyncAppenderTestCase"),
+						Level::getInfo(),
+						LOG4CXX_STR("After close"),
+						LOG4CXX_LOCATION));
+			async->append(event, p);
+			std::this_thread::sleep_for(std::chrono::milliseconds(100));
+			LOGUNIT_ASSERT_EQUAL(0, countingAppender->count.load());
+		}
+
+		/**
+		 * A thread waiting for space in the buffer must not
+		 * prevent another thread discarding an event.
+		 */
+		void testConcurrentAsyncAppender()
+		{
+			BlockableVectorAppenderPtr blockableAppender = BlockableVectorAppenderPtr(new BlockableVectorAppender());
+			AsyncAppenderPtr async = AsyncAppenderPtr(new AsyncAppender());
+			LOGUNIT_ASSERT(async->isConcurrent());
+			async->setName(LOG4CXX_STR("async-testConcurrentAsyncAppender"));
+			async->addAppender(blockableAppender);
+			async->setBufferSize(1);
+			async->setOverflowPolicy(AsyncAppender::OverflowPolicy::DropBelowLevel);
+			async->setDropThreshold(Level::getWarn());
+			Pool p;
+			async->activateOptions(p);
+			LoggerPtr logger = Logger::getLogger(LOG4CXX_STR("AsyncAppenderTestCase.testConcurrentAsyncAppender"));
+			logger->setAdditivity(false);
+			logger->addAppender(async);
+			std::unique_lock<std::mutex> sync(blockableAppender->getBlocker());
+			LOG4CXX_DEBUG(logger, "stall");
+			std::this_thread::sleep_for( std::chrono::milliseconds( 100 ) );
+			LOG4CXX_DEBUG(logger, "fill");
+			std::atomic<bool> warned(false);
+			std::thread warner([logger, &warned]()
+			{
+				LOG4CXX_WARN(logger, "waits");
+				warned = true;
+			});
+			std::this_thread::sleep_for( std::chrono::milliseconds( 100 ) );
+			LOGUNIT_ASSERT(!warned);
+
+			LOG4CXX_DEBUG(logger, "discarded");
+			LOGUNIT_ASSERT_EQUAL((size_t) 1, async->getDiscardedCount());
+			LOGUNIT_ASSERT(!warned);
+
+			sync.unlock();
+			warner.join();
+			logger->removeAllAppenders();
+			async->close();
+			LOGUNIT_ASSERT(warned);
+		}
 
 };
 
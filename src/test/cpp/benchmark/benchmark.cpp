@@ -4,12 +4,64 @@
 #include <log4cxx/helpers/optionconverter.h>
 #include <log4cxx/helpers/stringhelper.h>
 #include <log4cxx/asyncappender.h>
+#include <log4cxx/fileappender.h>
+#include <log4cxx/helpers/pool.h>
 #include <fmt/format.h>
 #include <benchmark/benchmark.h>
 #include <thread>
+#include <atomic>
+#include <vector>
+#include <cstdlib>
+#include <new>
+#if !defined(_WIN32)
+#include <fcntl.h>
+#include <unistd.h>
+#endif
 
 using namespace log4cxx;
 
+namespace
+{
+/** The number of heap allocations made by the current thread. */
+thread_local size_t allocationCount = 0;
+}
+
+void* operator new(std::size_t size)
+{
+	++allocationCount;
+	if (void* result = std::malloc(size ? size : 1))
+		return result;
+	throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept
+{
+	std::free(p);
+}
+
+void operator delete(void* p, std::size_t) noexcept
+{
+	std::free(p);
+}
+
+/**
+ * Reports the heap allocations per iteration made by the benchmark thread.
+ */
+class AllocationCounter
+{
+	size_t m_start;
+public:
+	AllocationCounter() : m_start(allocationCount) {}
+
+	void report(benchmark::State& state)
+	{
+		state.counters["allocs"] = benchmark::Counter
+			( double(allocationCount - m_start)
+			, benchmark::Counter::kAvgIterations
+			);
+	}
+};
+
 class NullWriterAppender : public AppenderSkeleton
 {
 public:
@@ -132,12 +184,15 @@ BENCHMARK_REGISTER_F(benchmarker, logDisabledDebug)->Name("Logging disabled debu
 BENCHMARK_DEFINE_F(benchmarker, logStaticString)(benchmark::State& state)
 {
 	m_logger->setLevel(Level::getInfo());
+	AllocationCounter allocations;
 	for (auto _ : state)
 	{
 		LOG4CXX_INFO( m_logger, LOG4CXX_STR("This is a static string to see what happens"));
 	}
+	allocations.report(state);
 }
 BENCHMARK_REGISTER_F(benchmarker, logStaticString)->Name("Logging info static string");
+BENCHMARK_REGISTER_F(benchmarker, logStaticString)->Name("Logging info static string")->Threads(benchmarker::threadCount());
 
 BENCHMARK_DEFINE_F(benchmarker, logEnabledDebug)(benchmark::State& state)
 {
@@ -184,10 +239,12 @@ BENCHMARK_REGISTER_F(benchmarker, logIntValueFMT)->Name("Logging int value with
 BENCHMARK_DEFINE_F(benchmarker, logIntValueStream)(benchmark::State& state)
 {
 	int x = 0;
+	AllocationCounter allocations;
 	for (auto _ : state)
 	{
 		LOG4CXX_INFO( m_logger, "Hello m_logger: msg number " << ++x);
 	}
+	allocations.report(state);
 }
 BENCHMARK_REGISTER_F(benchmarker, logIntValueStream)->Name("Logging int value with std::ostream");
 BENCHMARK_REGISTER_F(benchmarker, logIntValueStream)->Name("Logging int value with std::ostream")->Threads(benchmarker::threadCount());
@@ -212,6 +269,40 @@ void logWithConversionPattern(benchmark::State& state, Args&&... args)
 BENCHMARK_CAPTURE(logWithConversionPattern, NoFormat, LOG4CXX_STR("%m%n"))->Name("NoFormat pattern: %m%n");
 BENCHMARK_CAPTURE(logWithConversionPattern, DateOnly, LOG4CXX_STR("[%d] %m%n"))->Name("DateOnly pattern: [%d] %m%n");
 BENCHMARK_CAPTURE(logWithConversionPattern, DateClassLevel, LOG4CXX_STR("[%d] [%c] [%p] %m%n"))->Name("DateClassLevel pattern: [%d] [%c] [%p] %m%n");
+BENCHMARK_CAPTURE(logWithConversionPattern, LevelThreadClass, LOG4CXX_STR("%-5p [%t] %c - %m%n"))->Name("LevelThreadClass pattern: %-5p [%t] %c - %m%n");
+BENCHMARK_CAPTURE(logWithConversionPattern, ShortClassLocation, LOG4CXX_STR("[%p] %c{1} %f:%L - %m%n"))->Name("ShortClassLocation pattern: [%p] %c{1} %f:%L - %m%n");
+
+static void SetDeepHierarchy(const benchmark::State& state)
+{
+	LoggerPtr top = Logger::getLogger( LOG4CXX_STR("bench_deep") );
+	top->removeAllAppenders();
+	top->setAdditivity( false );
+	top->setLevel( Level::getInfo() );
+
+	PatternLayoutPtr pattern(new PatternLayout);
+	pattern->setConversionPattern(LOG4CXX_STR("%m%n"));
+
+	NullWriterAppenderPtr topWriter(new NullWriterAppender);
+	topWriter->setLayout( pattern );
+	top->addAppender(topWriter);
+
+	LoggerPtr middle = Logger::getLogger( LOG4CXX_STR("bench_deep.a.b") );
+	middle->removeAllAppenders();
+	NullWriterAppenderPtr middleWriter(new NullWriterAppender);
+	middleWriter->setLayout( pattern );
+	middle->addAppender(middleWriter);
+}
+
+static void logToDeepHierarchy(benchmark::State& state)
+{
+	auto logger = Logger::getLogger( LOG4CXX_STR("bench_deep.a.b.c.d.e.f.g") );
+	for (auto _ : state)
+	{
+		LOG4CXX_INFO( logger, LOG4CXX_STR("This is a static string to see what happens"));
+	}
+}
+BENCHMARK(logToDeepHierarchy)->Name("Logging static string to an 8 level hierarchy")->Setup(SetDeepHierarchy);
+BENCHMARK(logToDeepHierarchy)->Name("Logging static string to an 8 level hierarchy")->Setup(SetDeepHierarchy)->Threads(benchmarker::threadCount());
 
 static void SetAsyncAppender(const benchmark::State& state)
 {
@@ -235,5 +326,154 @@ static void SetAsyncAppender(const benchmark::State& state)
 BENCHMARK_REGISTER_F(benchmarker, logIntValueStream)->Name("Logging int value with std::ostream to AsyncAppender")->Setup(SetAsyncAppender);
 BENCHMARK_REGISTER_F(benchmarker, logIntValueStream)->Name("Logging int value with std::ostream to AsyncAppender")->Threads(benchmarker::threadCount());
 
+static void SetAsyncAppenderBuffer(bool ringBuffer)
+{
+	LoggerPtr logger = Logger::getLogger( LOG4CXX_STR("bench_async_logger") );
+	logger->removeAllAppenders();
+	logger->setAdditivity( false );
+	logger->setLevel( Level::getInfo() );
+
+	PatternLayoutPtr pattern(new PatternLayout);
+	pattern->setConversionPattern(LOG4CXX_STR("%m%n"));
+
+	NullWriterAppenderPtr nullWriter(new NullWriterAppender);
+	nullWriter->setLayout( pattern );
+	AsyncAppenderPtr asyncAppender = AsyncAppenderPtr(new AsyncAppender());
+	asyncAppender->addAppender(nullWriter);
+	asyncAppender->setRingBuffer(ringBuffer);
+	helpers::Pool p;
+	asyncAppender->activateOptions(p);
+	logger->addAppender(asyncAppender);
+}
+
+static void SetAsyncAppenderListBuffer(const benchmark::State& state)
+{
+	SetAsyncAppenderBuffer(false);
+}
+
+static void SetAsyncAppenderRingBuffer(const benchmark::State& state)
+{
+	SetAsyncAppenderBuffer(true);
+}
+
+static void RemoveAsyncAppender(const benchmark::State& state)
+{
+	Logger::getLogger( LOG4CXX_STR("bench_async_logger") )->removeAllAppenders();
+}
+
+static void logIntValueStreamToAsync(benchmark::State& state)
+{
+	auto logger = Logger::getLogger( LOG4CXX_STR("bench_async_logger") );
+	int x = 0;
+	AllocationCounter allocations;
+	for (auto _ : state)
+	{
+		LOG4CXX_INFO( logger, "Hello m_logger: msg number " << ++x);
+	}
+	allocations.report(state);
+}
+BENCHMARK(logIntValueStreamToAsync)->Name("Logging int value with std::ostream to AsyncAppender list buffer")
+	->Setup(SetAsyncAppenderListBuffer)->Teardown(RemoveAsyncAppender)
+	->ThreadRange(1, std::max(1, benchmarker::threadCount()))->UseRealTime();
+BENCHMARK(logIntValueStreamToAsync)->Name("Logging int value with std::ostream to AsyncAppender ring buffer")
+	->Setup(SetAsyncAppenderRingBuffer)->Teardown(RemoveAsyncAppender)
+	->ThreadRange(1, std::max(1, benchmarker::threadCount()))->UseRealTime();
+
+#if !defined(_WIN32)
+/**
+ * Keeps the disk holding the log file busy: a background thread repeatedly
+ * writes 8 MB to another file in the same directory and synchronizes it,
+ * so writes to the (regular) log file wait for the disk, as on a congested system.
+ */
+class SlowDisk
+{
+	std::string m_path;
+	std::atomic<bool> m_stop{false};
+	std::thread m_writer;
+public:
+	SlowDisk(const std::string& path) : m_path(path)
+	{
+		m_writer = std::thread([this]()
+		{
+			std::vector<char> block(1024 * 1024, 'x');
+			int fd = open(m_path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0600);
+			while (0 <= fd && !m_stop)
+			{
+				for (int i = 0; i < 8 && !m_stop; ++i)
+				{
+					if (write(fd, block.data(), block.size()) < 0)
+						break;
+				}
+				fdatasync(fd);
+				lseek(fd, 0, SEEK_SET);
+			}
+			if (0 <= fd)
+				close(fd);
+		});
+	}
+
+	~SlowDisk()
+	{
+		m_stop = true;
+		m_writer.join();
+		unlink(m_path.c_str());
+	}
+};
+static std::unique_ptr<SlowDisk> slowDisk;
+
+static void SetSlowDiskAppender(bool ioUring)
+{
+	LoggerPtr logger = Logger::getLogger( LOG4CXX_STR("bench_slow_disk_logger") );
+	logger->removeAllAppenders();
+	logger->setAdditivity( false );
+	logger->setLevel( Level::getInfo() );
+
+	slowDisk = std::make_unique<SlowDisk>("benchmark-slow-disk.load");
+	auto appender = std::make_shared<FileAppender>();
+	appender->setLayout(std::make_shared<PatternLayout>(LOG4CXX_STR("%m%n")));
+	appender->setFile(LOG4CXX_STR("benchmark-slow-disk.log"));
+	// A truncated file lets io_uring write several buffers in parallel
+	appender->setAppend(false);
+	appender->setImmediateFlush(false);
+	appender->setIOUring(ioUring);
+	helpers::Pool p;
+	appender->activateOptions(p);
+	logger->addAppender(appender);
+}
+
+static void SetSlowDiskFileAppender(const benchmark::State& state)
+{
+	SetSlowDiskAppender(false);
+}
+
+static void SetSlowDiskIOUringAppender(const benchmark::State& state)
+{
+	SetSlowDiskAppender(true);
+}
+
+static void RemoveSlowDiskAppender(const benchmark::State& state)
+{
+	auto logger = Logger::getLogger( LOG4CXX_STR("bench_slow_disk_logger") );
+	for (auto& appender : logger->getAllAppenders())
+		appender->close();
+	logger->removeAllAppenders();
+	slowDisk.reset();
+}
+
+static void logIntValueStreamToSlowDisk(benchmark::State& state)
+{
+	auto logger = Logger::getLogger( LOG4CXX_STR("bench_slow_disk_logger") );
+	int x = 0;
+	for (auto _ : state)
+	{
+		LOG4CXX_INFO( logger, "Hello m_logger: msg number " << ++x);
+	}
+}
+BENCHMARK(logIntValueStreamToSlowDisk)->Name("Logging int value with std::ostream to a slow disk")
+	->Setup(SetSlowDiskFileAppender)->Teardown(RemoveSlowDiskAppender)->UseRealTime();
+BENCHMARK(logIntValueStreamToSlowDisk)->Name("Logging int value with std::ostream to a slow disk using io_uring")
+	->Setup(SetSlowDiskIOUringAppender)->Teardown(RemoveSlowDiskAppender)->UseRealTime();
+#endif
+
 BENCHMARK_MAIN();
 
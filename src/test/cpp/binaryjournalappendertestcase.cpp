@@ -0,0 +1,304 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "logunit.h"
+
+#include <log4cxx/logger.h>
+#include <log4cxx/binaryjournalappender.h>
+#include <log4cxx/patternlayout.h>
+#include <log4cxx/mdc.h>
+#include <log4cxx/ndc.h>
+#include <log4cxx/helpers/binaryjournalreader.h>
+#include <log4cxx/helpers/exception.h>
+#include <log4cxx/helpers/fileoutputstream.h>
+#include <log4cxx/helpers/pool.h>
+#include "appenderskeletontestcase.h"
+#include "vectorappender.h"
+#include "testchar.h"
+#include <fstream>
+#include <iterator>
+
+using namespace log4cxx;
+using namespace log4cxx::helpers;
+using namespace log4cxx::spi;
+
+namespace
+{
+/**
+ * A file stream whose next write can be made to fail.
+ */
+class FailingOutputStream : public OutputStream
+{
+	public:
+		FailingOutputStream(const LogString& fileName)
+			: file(fileName, false)
+			, failNext(false)
+		{
+		}
+
+		void close(Pool& p) override
+		{
+			file.close(p);
+		}
+
+		void flush(Pool& p) override
+		{
+			file.flush(p);
+		}
+
+		void write(ByteBuffer& buf, Pool& p) override
+		{
+			if (failNext)
+			{
+				failNext = false;
+				throw IOException(LOG4CXX_STR("write failed"));
+			}
+
+			file.write(buf, p);
+		}
+
+		FileOutputStream file;
+		bool failNext;
+};
+
+/**
+ * Exposes the protected stream setter.
+ */
+class StreamJournalAppender : public BinaryJournalAppender
+{
+	public:
+		using BinaryJournalAppender::setOutputStream;
+};
+}
+
+/**
+   Unit tests of log4cxx::BinaryJournalAppender and log4cxx::helpers::BinaryJournalReader
+ */
+class BinaryJournalAppenderTestCase : public AppenderSkeletonTestCase
+{
+		LOGUNIT_TEST_SUITE(BinaryJournalAppenderTestCase);
+		//
+		// tests inherited from AppenderSkeletonTestCase
+		//
+		LOGUNIT_TEST(testDefaultThreshold);
+		LOGUNIT_TEST(testSetOptionThreshold);
+
+		LOGUNIT_TEST(testRoundTrip);
+		LOGUNIT_TEST(testAppend);
+		LOGUNIT_TEST(testIncompleteRecord);
+		LOGUNIT_TEST(testOversizedRecord);
+		LOGUNIT_TEST(testNotAJournal);
+		LOGUNIT_TEST(testWriteFailure);
+		LOGUNIT_TEST_SUITE_END();
+
+		LoggerPtr logger;
+		VectorAppenderPtr vectorAppender;
+
+	public:
+		void setUp()
+		{
+			AppenderSkeletonTestCase::setUp();
+			logger = Logger::getLogger(LOG4CXX_STR("org.apache.log4cxx.journal"));
+			vectorAppender = std::make_shared<VectorAppender>();
+			logger->addAppender(vectorAppender);
+		}
+
+		void tearDown()
+		{
+			logger->getLoggerRepository()->resetConfiguration();
+			MDC::clear();
+			NDC::clear();
+			AppenderSkeletonTestCase::tearDown();
+		}
+
+		AppenderSkeleton* createAppenderSkeleton() const
+		{
+			return new BinaryJournalAppender();
+		}
+
+		/**
+		 * Log two events to \c fileName.
+		 */
+		void logTo(const LogString& fileName, bool append)
+		{
+			auto journal = std::make_shared<BinaryJournalAppender>(fileName, append);
+			logger->addAppender(journal);
+			MDC::put(LOG4CXX_TEST_STR("user"), LOG4CXX_TEST_STR("alice"));
+			NDC::push(LOG4CXX_TEST_STR("request"));
+			LOG4CXX_INFO(logger, "Hello, journal");
+			NDC::pop();
+			MDC::clear();
+			LOG4CXX_WARN(logger, "Goodbye");
+			logger->removeAppender(journal);
+			journal->close();
+		}
+
+		void assertSame(const LoggingEventPtr& expected, const LoggingEventPtr& actual)
+		{
+			LOGUNIT_ASSERT(actual);
+			LOGUNIT_ASSERT_EQUAL(expected->getLoggerName(), actual->getLoggerName());
+			LOGUNIT_ASSERT_EQUAL(expected->getLevel()->toInt(), actual->getLevel()->toInt());
+			LOGUNIT_ASSERT_EQUAL(expected->getMessage(), actual->getMessage());
+			LOGUNIT_ASSERT_EQUAL(expected->getTimeStamp(), actual->getTimeStamp());
+			LOGUNIT_ASSERT_EQUAL(expected->getThreadName(), actual->getThreadName());
+			LOGUNIT_ASSERT_EQUAL(expected->getThreadUserName(), actual->getThreadUserName());
+			const LocationInfo& expectedLocation = expected->getLocationInformation();
+			const LocationInfo& actualLocation = actual->getLocationInformation();
+			LOGUNIT_ASSERT_EQUAL(std::string(expectedLocation.getFileName()), std::string(actualLocation.getFileName()));
+			LOGUNIT_ASSERT_EQUAL(expectedLocation.getMethodName(), actualLocation.getMethodName());
+			LOGUNIT_ASSERT_EQUAL(expectedLocation.getLineNumber(), actualLocation.getLineNumber());
+		}
+
+		void testRoundTrip()
+		{
+			LogString fileName(LOG4CXX_STR("output/journal-roundtrip.bin"));
+			logTo(fileName, false);
+			auto& expected = vectorAppender->getVector();
+			LOGUNIT_ASSERT_EQUAL((size_t) 2, expected.size());
+
+			BinaryJournalReader reader(File().setPath(fileName));
+			auto first = reader.read();
+			assertSame(expected[0], first);
+			LogString value;
+			LOGUNIT_ASSERT(first->getMDC(LOG4CXX_STR("user"), value));
+			LOGUNIT_ASSERT_EQUAL((LogString) LOG4CXX_STR("alice"), value);
+			value.clear();
+			LOGUNIT_ASSERT(first->getNDC(value));
+			LOGUNIT_ASSERT_EQUAL((LogString) LOG4CXX_STR("request"), value);
+
+			auto second = reader.read();
+			assertSame(expected[1], second);
+			value.clear();
+			LOGUNIT_ASSERT(!second->getNDC(value));
+			LOGUNIT_ASSERT(second->getMDCKeySet().empty());
+			LOGUNIT_ASSERT(!reader.read());
+
+			Pool p;
+			PatternLayout layout(LOG4CXX_STR("%-5p %c %X{user} %x - %m"));
+			LogString text;
+			layout.format(text, first, p);
+			LOGUNIT_ASSERT_EQUAL((LogString) LOG4CXX_STR("INFO  org.apache.log4cxx.journal alice request - Hello, journal"), text);
+		}
+
+		void testAppend()
+		{
+			LogString fileName(LOG4CXX_STR("output/journal-append.bin"));
+			logTo(fileName, false);
+			logTo(fileName, true);
+			auto& expected = vectorAppender->getVector();
+			LOGUNIT_ASSERT_EQUAL((size_t) 4, expected.size());
+
+			BinaryJournalReader reader(File().setPath(fileName));
+
+			for (auto& event : expected)
+			{
+				assertSame(event, reader.read());
+			}
+
+			LOGUNIT_ASSERT(!reader.read());
+		}
+
+		void testIncompleteRecord()
+		{
+			LogString fileName(LOG4CXX_STR("output/journal-incomplete.bin"));
+			logTo(fileName, false);
+			std::string content;
+			{
+				std::ifstream in("output/journal-incomplete.bin", std::ios::binary);
+				content.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+			}
+			{
+				std::ofstream out("output/journal-incomplete.bin", std::ios::binary | std::ios::trunc);
+				out.write(content.data(), content.size() - 3);
+			}
+
+			BinaryJournalReader reader(File().setPath(fileName));
+			assertSame(vectorAppender->getVector()[0], reader.read());
+			LOGUNIT_ASSERT(!reader.read());
+		}
+
+		/**
+		 * A corrupt record size must be reported as malformed
+		 * rather than used to size the read buffer.
+		 */
+		void testOversizedRecord()
+		{
+			LogString fileName(LOG4CXX_STR("output/journal-oversized.bin"));
+			logTo(fileName, false);
+			std::string content;
+			{
+				std::ifstream in("output/journal-oversized.bin", std::ios::binary);
+				content.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+			}
+			{
+				// Keep the header record, then claim a record of nearly 2^63 bytes
+				std::ofstream out("output/journal-oversized.bin", std::ios::binary | std::ios::trunc);
+				out.write(content.data(), 1 + static_cast<unsigned char>(content[0]));
+				out.write("\xFF\xFF\xFF\xFF\xFF\xFF\xFF\xFF\x7F", 9);
+				out.write(content.data(), content.size());
+			}
+
+			BinaryJournalReader reader(File().setPath(fileName));
+
+			try
+			{
+				reader.read();
+				LOGUNIT_FAIL("IOException expected");
+			}
+			catch (IOException&)
+			{
+			}
+		}
+
+		void testNotAJournal()
+		{
+			BinaryJournalReader reader(File().setPath(LOG4CXX_STR("input/patternLayout1.properties")));
+
+			try
+			{
+				reader.read();
+				LOGUNIT_FAIL("IOException expected");
+			}
+			catch (IOException&)
+			{
+			}
+		}
+
+		/**
+		 * Records written after a failed write must not refer to
+		 * dictionary entries that were lost with it.
+		 */
+		void testWriteFailure()
+		{
+			LogString fileName(LOG4CXX_STR("output/journal-failure.bin"));
+			auto stream = std::make_shared<FailingOutputStream>(fileName);
+			auto journal = std::make_shared<StreamJournalAppender>();
+			Pool p;
+			journal->setOutputStream(stream, p);
+			logger->addAppender(journal);
+			stream->failNext = true;
+			LOG4CXX_INFO(logger, "Lost");
+			LOG4CXX_WARN(logger, "Kept");
+			logger->removeAppender(journal);
+			journal->close();
+
+			BinaryJournalReader reader(File().setPath(fileName));
+			assertSame(vectorAppender->getVector()[1], reader.read());
+			LOGUNIT_ASSERT(!reader.read());
+		}
+};
+
+LOGUNIT_TEST_SUITE_REGISTRATION(BinaryJournalAppenderTestCase);
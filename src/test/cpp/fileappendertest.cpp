@@ -15,9 +15,19 @@
  * limitations under the License.
  */
 #include <log4cxx/helpers/pool.h>
+#include <log4cxx/helpers/stringhelper.h>
+#include <log4cxx/helpers/threadutility.h>
 #include <log4cxx/fileappender.h>
 #include <log4cxx/patternlayout.h>
+#include <log4cxx/logger.h>
+#include <log4cxx/private/groupcommit.h>
 #include "logunit.h"
+#include <atomic>
+#include <cerrno>
+#include <condition_variable>
+#include <fstream>
+#include <thread>
+#include <vector>
 
 using namespace log4cxx;
 using namespace log4cxx::helpers;
@@ -33,6 +43,11 @@ LOGUNIT_CLASS(FileAppenderTest)
 	LOGUNIT_TEST(testDirectoryCreation);
 	LOGUNIT_TEST(testgetSetThreshold);
 	LOGUNIT_TEST(testIsAsSevereAsThreshold);
+	LOGUNIT_TEST(testSyncLevel);
+	LOGUNIT_TEST(testSyncSize);
+	LOGUNIT_TEST(testGroupCommit);
+	LOGUNIT_TEST(testGroupCommitFailure);
+	LOGUNIT_TEST(testMaxFlushDelay);
 	LOGUNIT_TEST_SUITE_END();
 public:
 	/**
@@ -81,6 +96,218 @@ public:
 		LevelPtr debug = Level::getDebug();
 		LOGUNIT_ASSERT(appender->isAsSevereAsThreshold(debug));
 	}
+
+	/**
+	 * Tests events at or above SyncLevel wait for a sync.
+	 */
+	void testSyncLevel()
+	{
+		Pool p;
+		FileAppenderPtr appender(new FileAppender());
+		appender->setFile(LOG4CXX_STR("output/synclevel.log"));
+		appender->setAppend(false);
+		appender->setLayout(PatternLayoutPtr(new PatternLayout(LOG4CXX_STR("%m%n"))));
+		appender->setSyncLevel(Level::getWarn());
+		appender->activateOptions(p);
+		LoggerPtr logger = Logger::getLogger(LOG4CXX_STR("FileAppenderTest.testSyncLevel"));
+		logger->removeAllAppenders();
+		logger->setAdditivity(false);
+		logger->addAppender(appender);
+
+		LOG4CXX_INFO(logger, "not waiting");
+		LOGUNIT_ASSERT_EQUAL((uint64_t) 0, appender->getSyncStatistics().waitCount);
+
+		const int threadCount = 4;
+		const int eventCount = 25;
+		std::vector<std::thread> threads;
+
+		for (int i = 0; i < threadCount; ++i)
+		{
+			threads.emplace_back([logger]()
+			{
+				for (int j = 0; j < eventCount; ++j)
+				{
+					LOG4CXX_WARN(logger, "durable");
+				}
+			});
+		}
+
+		for (auto& t : threads)
+		{
+			t.join();
+		}
+
+		auto stats = appender->getSyncStatistics();
+		LOGUNIT_ASSERT(0 < stats.syncCount);
+		LOGUNIT_ASSERT(stats.syncCount <= stats.waitCount);
+		LOGUNIT_ASSERT(stats.waitCount <= (uint64_t) (threadCount * eventCount));
+		logger->removeAllAppenders();
+		appender->close();
+
+		std::ifstream in("output/synclevel.log");
+		std::string line;
+		int lineCount = 0;
+
+		while (std::getline(in, line))
+		{
+			++lineCount;
+		}
+
+		LOGUNIT_ASSERT_EQUAL(1 + threadCount * eventCount, lineCount);
+	}
+
+	/**
+	 * Tests the file is synchronized after SyncSize bytes are written.
+	 */
+	void testSyncSize()
+	{
+		Pool p;
+		FileAppenderPtr appender(new FileAppender());
+		appender->setFile(LOG4CXX_STR("output/syncsize.log"));
+		appender->setAppend(false);
+		appender->setLayout(PatternLayoutPtr(new PatternLayout(LOG4CXX_STR("%m%n"))));
+		appender->setSyncSize(1024);
+		appender->activateOptions(p);
+		LoggerPtr logger = Logger::getLogger(LOG4CXX_STR("FileAppenderTest.testSyncSize"));
+		logger->removeAllAppenders();
+		logger->setAdditivity(false);
+		logger->addAppender(appender);
+
+		for (int i = 0; i < 100; ++i)
+		{
+			LOG4CXX_INFO(logger, "Twenty byte message");
+		}
+
+		for (int i = 0; i < 500 && appender->getSyncStatistics().syncCount == 0; ++i)
+		{
+			std::this_thread::sleep_for(std::chrono::milliseconds(10));
+		}
+
+		LOGUNIT_ASSERT(0 < appender->getSyncStatistics().syncCount);
+		LOGUNIT_ASSERT_EQUAL((uint64_t) 0, appender->getSyncStatistics().waitCount);
+		logger->removeAllAppenders();
+	}
+
+	/**
+	 * Tests threads waiting during a sync share the next sync.
+	 */
+	void testGroupCommit()
+	{
+		std::mutex mutex;
+		std::condition_variable released;
+		bool release = false;
+		int syncCount = 0;
+		GroupCommit commit(0, 0);
+		commit.attach([&]()
+		{
+			std::unique_lock<std::mutex> lock(mutex);
+			++syncCount;
+			released.wait(lock, [&release] { return release; });
+			return 0;
+		});
+
+		commit.written(10);
+		std::vector<std::thread> threads;
+		threads.emplace_back([&commit]() { commit.waitDurable(10); });
+
+		for (int i = 0; i < 5000 && commit.getStatistics().waitCount < 1; ++i)
+		{
+			std::this_thread::sleep_for(std::chrono::milliseconds(1));
+		}
+
+		const int laterCount = 8;
+
+		for (int i = 0; i < laterCount; ++i)
+		{
+			threads.emplace_back([&commit]()
+			{
+				commit.written(10);
+				commit.waitDurable(commit.getPosition());
+			});
+		}
+
+		for (int i = 0; i < 5000 && commit.getStatistics().waitCount < 1 + laterCount; ++i)
+		{
+			std::this_thread::sleep_for(std::chrono::milliseconds(1));
+		}
+
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			release = true;
+			released.notify_all();
+		}
+
+		for (auto& t : threads)
+		{
+			t.join();
+		}
+
+		LOGUNIT_ASSERT_EQUAL(2, syncCount);
+		LOGUNIT_ASSERT_EQUAL((uint64_t) 2, commit.getStatistics().syncCount);
+		LOGUNIT_ASSERT_EQUAL((uint64_t) (1 + laterCount), commit.getStatistics().waitCount);
+		commit.detach();
+		LOGUNIT_ASSERT_EQUAL(2, syncCount);
+	}
+
+	/**
+	 * Tests bytes whose sync failed are not reported durable.
+	 */
+	void testGroupCommitFailure()
+	{
+		std::atomic<int> syncCount(0);
+		GroupCommit commit(0, 0);
+		commit.attach([&syncCount]()
+		{
+			return ++syncCount == 1 ? EIO : 0;
+		});
+
+		commit.written(10);
+		LOGUNIT_ASSERT_EQUAL((log4cxx_status_t) EIO, commit.waitDurable(10));
+		commit.written(10);
+		LOGUNIT_ASSERT_EQUAL((log4cxx_status_t) 0, commit.waitDurable(20));
+		LOGUNIT_ASSERT_EQUAL((log4cxx_status_t) EIO, commit.waitDurable(10));
+		LOGUNIT_ASSERT_EQUAL(2, syncCount.load());
+		commit.detach();
+	}
+
+	/**
+	 * Tests buffered events are written within MaxFlushDelay.
+	 */
+	void testMaxFlushDelay()
+	{
+		Pool p;
+		FileAppenderPtr appender(new FileAppender());
+		appender->setFile(LOG4CXX_STR("output/maxflushdelay.log"));
+		appender->setAppend(false);
+		appender->setLayout(PatternLayoutPtr(new PatternLayout(LOG4CXX_STR("%m%n"))));
+		appender->setBufferedIO(true);
+		appender->setMaxFlushDelay(20);
+		appender->activateOptions(p);
+		LoggerPtr logger = Logger::getLogger(LOG4CXX_STR("FileAppenderTest.testMaxFlushDelay"));
+		logger->removeAllAppenders();
+		logger->setAdditivity(false);
+		logger->addAppender(appender);
+
+		File file(LOG4CXX_STR("output/maxflushdelay.log"));
+		LOG4CXX_INFO(logger, "Buffered message");
+		auto start = std::chrono::steady_clock::now();
+
+		for (int i = 0; i < 500 && file.length(p) == 0; ++i)
+		{
+			std::this_thread::sleep_for(std::chrono::milliseconds(1));
+		}
+
+		auto elapsed = std::chrono::steady_clock::now() - start;
+		LOGUNIT_ASSERT_EQUAL((size_t) 17, file.length(p));
+		LOGUNIT_ASSERT(elapsed < std::chrono::milliseconds(400));
+
+		LogString taskName(LOG4CXX_STR("FlushFileAppender "));
+		StringHelper::toString((int64_t) reinterpret_cast<intptr_t>(appender.get()), p, taskName);
+		LOGUNIT_ASSERT(ThreadUtility::instance()->hasPeriodicTask(taskName));
+		appender->close();
+		LOGUNIT_ASSERT(!ThreadUtility::instance()->hasPeriodicTask(taskName));
+		logger->removeAllAppenders();
+	}
 };
 
 LOGUNIT_TEST_SUITE_REGISTRATION(FileAppenderTest);
@@ -17,11 +17,73 @@
 
 #include "fileappendertestcase.h"
 #include <log4cxx/fileappender.h>
+#include <log4cxx/simplelayout.h>
+#include <log4cxx/helpers/writer.h>
+#include <log4cxx/spi/loggingevent.h>
+#include <log4cxx/spi/location/locationinfo.h>
 #include "insertwide.h"
+#include "vectorappender.h"
+#include <fstream>
 
 using namespace log4cxx;
 using namespace log4cxx::helpers;
 
+/**
+ * Passes output to another writer while counting calls to write.
+ */
+class CountingWriter : public Writer
+{
+	public:
+		CountingWriter(const WriterPtr& out) : out(out), writeCount(0)
+		{
+		}
+
+		void close(Pool& p) override
+		{
+			out->close(p);
+		}
+
+		void flush(Pool& p) override
+		{
+			out->flush(p);
+		}
+
+		void write(const LogString& str, Pool& p) override
+		{
+			++writeCount;
+			out->write(str, p);
+		}
+
+		WriterPtr out;
+		int writeCount;
+};
+
+/**
+ * A FileAppender that counts the events passed to subAppend.
+ * It does not override the group subAppend, so must see each event.
+ */
+class SubAppendCountingAppender : public FileAppender
+{
+	public:
+		SubAppendCountingAppender() : subAppendCount(0)
+		{
+		}
+
+		int subAppendCount;
+
+	protected:
+		void subAppend(const spi::LoggingEventPtr& event, Pool& p) override
+		{
+			++subAppendCount;
+			FileAppender::subAppend(event, p);
+		}
+
+		bool isGroupWritable() const override
+		{
+			return false;
+		}
+};
+
 WriterAppender* FileAppenderAbstractTestCase::createWriterAppender() const
 {
 	return createFileAppender();
@@ -43,6 +105,9 @@ class FileAppenderTestCase : public FileAppenderAbstractTestCase
 		//  tests defined here
 		LOGUNIT_TEST(testSetDoubleBackslashes);
 		LOGUNIT_TEST(testStripDuplicateBackslashes);
+		LOGUNIT_TEST(testBatchAppend);
+		LOGUNIT_TEST(testBatchSubAppendOverride);
+		LOGUNIT_TEST(testBatchAppendOverride);
 
 		LOGUNIT_TEST_SUITE_END();
 
@@ -110,6 +175,87 @@ class FileAppenderTestCase : public FileAppenderAbstractTestCase
 				FileAppender::stripDuplicateBackslashes(LOG4CXX_STR("\\\\\\\\foo.log")));
 		}
 
+		/**
+		 * Tests a group of events is written with a single write.
+		 */
+		void testBatchAppend()
+		{
+			FileAppender appender;
+			appender.setLayout(std::make_shared<SimpleLayout>());
+			appender.setFile(LOG4CXX_STR("output/batchAppend.log"));
+			appender.setAppend(false);
+			appender.setThreshold(Level::getInfo());
+			Pool p;
+			appender.activateOptions(p);
+			auto writer = std::make_shared<CountingWriter>(appender.getWriter());
+			appender.setWriter(writer);
+
+			spi::LoggingEventList events;
+			events.push_back(std::make_shared<spi::LoggingEvent>(LOG4CXX_STR("batch"),
+				Level::getInfo(), LOG4CXX_STR("first"), spi::LocationInfo::getLocationUnavailable()));
+			events.push_back(std::make_shared<spi::LoggingEvent>(LOG4CXX_STR("batch"),
+				Level::getDebug(), LOG4CXX_STR("below threshold"), spi::LocationInfo::getLocationUnavailable()));
+			events.push_back(std::make_shared<spi::LoggingEvent>(LOG4CXX_STR("batch"),
+				Level::getWarn(), LOG4CXX_STR("second"), spi::LocationInfo::getLocationUnavailable()));
+			appender.doAppend(events, p);
+			LOGUNIT_ASSERT_EQUAL(1, writer->writeCount);
+			appender.close();
+
+			std::ifstream in("output/batchAppend.log");
+			std::string line1, line2, line3;
+			std::getline(in, line1);
+			std::getline(in, line2);
+			LOGUNIT_ASSERT_EQUAL(std::string("INFO - first"), line1);
+			LOGUNIT_ASSERT_EQUAL(std::string("WARN - second"), line2);
+			LOGUNIT_ASSERT(!std::getline(in, line3));
+		}
+
+		static spi::LoggingEventList createBatch()
+		{
+			spi::LoggingEventList events;
+			events.push_back(std::make_shared<spi::LoggingEvent>(LOG4CXX_STR("batch"),
+				Level::getInfo(), LOG4CXX_STR("first"), spi::LocationInfo::getLocationUnavailable()));
+			events.push_back(std::make_shared<spi::LoggingEvent>(LOG4CXX_STR("batch"),
+				Level::getWarn(), LOG4CXX_STR("second"), spi::LocationInfo::getLocationUnavailable()));
+			return events;
+		}
+
+		/**
+		 * Tests a group of events is passed to an overridden single event subAppend.
+		 */
+		void testBatchSubAppendOverride()
+		{
+			SubAppendCountingAppender appender;
+			appender.setLayout(std::make_shared<SimpleLayout>());
+			appender.setFile(LOG4CXX_STR("output/batchAppend.log"));
+			appender.setAppend(false);
+			Pool p;
+			appender.activateOptions(p);
+			appender.doAppend(createBatch(), p);
+			LOGUNIT_ASSERT_EQUAL(2, appender.subAppendCount);
+			appender.close();
+
+			std::ifstream in("output/batchAppend.log");
+			std::string line1, line2;
+			std::getline(in, line1);
+			std::getline(in, line2);
+			LOGUNIT_ASSERT_EQUAL(std::string("INFO - first"), line1);
+			LOGUNIT_ASSERT_EQUAL(std::string("WARN - second"), line2);
+		}
+
+		/**
+		 * Tests a group of events is passed to an appender
+		 * which only implements the single event append.
+		 */
+		void testBatchAppendOverride()
+		{
+			VectorAppender appender;
+			Pool p;
+			appender.doAppend(createBatch(), p);
+			LOGUNIT_ASSERT_EQUAL((size_t) 2, appender.getVector().size());
+			LOGUNIT_ASSERT(appender.getVector()[1]->getMessage() == LOG4CXX_STR("second"));
+		}
+
 };
 
 LOGUNIT_TEST_SUITE_REGISTRATION(FileAppenderTestCase);
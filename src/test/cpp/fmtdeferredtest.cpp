@@ -0,0 +1,172 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <log4cxx/logger.h>
+#include <log4cxx/spi/loggingevent.h>
+#include "logunit.h"
+#include "testchar.h"
+#include "vectorappender.h"
+#include <fmt/format.h>
+#include <fmt/ranges.h>
+#include <atomic>
+#include <string.h>
+#include <vector>
+
+using namespace log4cxx;
+using namespace log4cxx::helpers;
+
+namespace
+{
+std::atomic<int> formatCount(0);
+
+/**
+ * A value which counts the number of times it is formatted.
+ */
+struct Counted
+{
+	int value;
+};
+
+/**
+ * A value which cannot be formatted later.
+ */
+struct NotCopyable
+{
+	NotCopyable(int value1) : value(value1) {}
+	NotCopyable(const NotCopyable& other) : value(other.value) {}
+	int value;
+};
+}
+
+template <>
+struct log4cxx::helpers::DeferredArgument<Counted>
+{
+	typedef Counted type;
+	static constexpr bool deferrable = true;
+};
+
+template <>
+struct fmt::formatter<Counted> : fmt::formatter<int>
+{
+	template <typename FormatContext>
+	auto format(const Counted& c, FormatContext& ctx) const -> decltype(ctx.out())
+	{
+		++formatCount;
+		return fmt::formatter<int>::format(c.value, ctx);
+	}
+};
+
+template <>
+struct fmt::formatter<NotCopyable> : fmt::formatter<int>
+{
+	template <typename FormatContext>
+	auto format(const NotCopyable& c, FormatContext& ctx) const -> decltype(ctx.out())
+	{
+		++formatCount;
+		return fmt::formatter<int>::format(c.value, ctx);
+	}
+};
+
+/**
+ * Checks the message of a LOG4CXX_[level]_FMT request
+ * is formatted when first requested.
+ */
+LOGUNIT_CLASS(FMTDeferredTestCase)
+{
+	LOGUNIT_TEST_SUITE(FMTDeferredTestCase);
+	LOGUNIT_TEST(testFormatOnFirstUse);
+	LOGUNIT_TEST(testStringArguments);
+	LOGUNIT_TEST(testNotDeferrable);
+	LOGUNIT_TEST(testJoin);
+	LOGUNIT_TEST_SUITE_END();
+
+	LoggerPtr logger;
+	VectorAppenderPtr appender;
+
+public:
+	void setUp()
+	{
+		logger = Logger::getLogger(LOG4CXX_TEST_STR("FMTDeferredTestCase"));
+		appender = VectorAppenderPtr(new VectorAppender());
+		logger->addAppender(appender);
+		formatCount = 0;
+	}
+
+	void tearDown()
+	{
+		logger->getLoggerRepository()->resetConfiguration();
+	}
+
+	void testFormatOnFirstUse()
+	{
+		Counted c{ 42 };
+		LOG4CXX_INFO_FMT(logger, "value {} of {:.1f}", c, 99.25);
+		LOGUNIT_ASSERT_EQUAL(0, (int) formatCount);
+
+		auto events = appender->getVector();
+		LOGUNIT_ASSERT_EQUAL((size_t) 1, events.size());
+		LOGUNIT_ASSERT_EQUAL((LogString) LOG4CXX_STR("value 42 of 99.2"), events[0]->getMessage());
+		LOGUNIT_ASSERT_EQUAL(1, (int) formatCount);
+		LOGUNIT_ASSERT_EQUAL((LogString) LOG4CXX_STR("value 42 of 99.2"), events[0]->getRenderedMessage());
+		LOGUNIT_ASSERT_EQUAL(1, (int) formatCount);
+	}
+
+	void testStringArguments()
+	{
+		char buffer[32];
+		strcpy(buffer, "first");
+		std::string str("a string longer than the small string buffer");
+		LOG4CXX_WARN_FMT(logger, "{} {}", buffer, str);
+		strcpy(buffer, "second");
+		str.clear();
+
+		auto events = appender->getVector();
+		LOGUNIT_ASSERT_EQUAL((size_t) 1, events.size());
+		LOGUNIT_ASSERT_EQUAL((LogString) LOG4CXX_STR("first a string longer than the small string buffer"), events[0]->getMessage());
+	}
+
+	void testNotDeferrable()
+	{
+		NotCopyable value(7);
+		LOG4CXX_INFO_FMT(logger, "value {}", value);
+		LOGUNIT_ASSERT_EQUAL(1, (int) formatCount);
+
+		auto events = appender->getVector();
+		LOGUNIT_ASSERT_EQUAL((size_t) 1, events.size());
+		LOGUNIT_ASSERT_EQUAL((LogString) LOG4CXX_STR("value 7"), events[0]->getMessage());
+		LOGUNIT_ASSERT_EQUAL(1, (int) formatCount);
+	}
+
+	/**
+	 * A fmt::join result is trivially copyable but refers to the caller's range,
+	 * so it must be formatted before the request returns.
+	 */
+	void testJoin()
+	{
+		{
+			std::vector<int> values{ 1, 2, 3 };
+			LOG4CXX_INFO_FMT(logger, "values {}", fmt::join(values, ","));
+			values.assign(1000, 9);
+		}
+
+		auto events = appender->getVector();
+		LOGUNIT_ASSERT_EQUAL((size_t) 1, events.size());
+		LOGUNIT_ASSERT_EQUAL((LogString) LOG4CXX_STR("values 1,2,3"), events[0]->getMessage());
+	}
+};
+
+LOGUNIT_TEST_SUITE_REGISTRATION(FMTDeferredTestCase);
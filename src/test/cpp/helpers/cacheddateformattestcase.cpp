@@ -26,6 +26,10 @@
 #include <apr.h>
 #include <apr_time.h>
 #include "localechanger.h"
+#include <log4cxx/helpers/simpledateformat.h>
+#include <log4cxx/helpers/datetimedateformat.h>
+#include <thread>
+#include <vector>
 
 using namespace log4cxx;
 using namespace log4cxx::helpers;
@@ -78,6 +82,9 @@ LOGUNIT_CLASS(CachedDateFormatTestCase)
 	LOGUNIT_TEST(test20);
 	LOGUNIT_TEST(test21);
 	LOGUNIT_TEST(test22);
+	LOGUNIT_TEST(test23);
+	LOGUNIT_TEST(test24);
+	LOGUNIT_TEST(test25);
 	LOGUNIT_TEST_SUITE_END();
 
 #define MICROSECONDS_PER_DAY APR_INT64_C(86400000000)
@@ -696,6 +703,115 @@ public:
 		LOGUNIT_ASSERT_EQUAL(LOG4CXX_STR("1970-01-01 00:00:01,999"), formatted);
 	}
 
+	/**
+	 * Check that a microsecond field is updated from the cache.
+	 */
+	void test23()
+	{
+		LogString pattern(LOG4CXX_STR("HH:mm:ss.SSSSSS"));
+		LOGUNIT_ASSERT_EQUAL(1000000, CachedDateFormat::getMaximumCacheValidity(pattern));
+		DateFormatPtr baseFormatter(new SimpleDateFormat(pattern));
+		CachedDateFormat microFormat(baseFormatter, 1000000);
+		microFormat.setTimeZone(TimeZone::getGMT());
+
+		Pool p;
+		LogString formatted;
+		microFormat.format(formatted, 12000000 + 123456, p);
+		LOGUNIT_ASSERT_EQUAL(LOG4CXX_STR("00:00:12.123456"), formatted);
+
+		formatted.clear();
+		microFormat.format(formatted, 12000000 + 987001, p);
+		LOGUNIT_ASSERT_EQUAL(LOG4CXX_STR("00:00:12.987001"), formatted);
+
+		formatted.clear();
+		microFormat.format(formatted, 12000000 + 42, p);
+		LOGUNIT_ASSERT_EQUAL(LOG4CXX_STR("00:00:12.000042"), formatted);
+	}
+
+	/**
+	 * Check that threads sharing a CachedDateFormat get the same text
+	 * as the underlying format.
+	 */
+	void test24()
+	{
+		DateFormatPtr baseFormatter(new ISO8601DateFormat());
+		baseFormatter->setTimeZone(TimeZone::getGMT());
+		auto cachedFormat = std::make_shared<CachedDateFormat>(baseFormatter, 1000000);
+		const int threadCount = 4;
+		std::vector<int> failures(threadCount, 0);
+		std::vector<std::thread> threads;
+
+		for (int i = 0; i < threadCount; ++i)
+		{
+			threads.emplace_back([&, i]()
+			{
+				Pool p;
+				log4cxx_time_t start = MICROSECONDS_PER_DAY * 12601L;
+
+				for (int j = 0; j < 20000; ++j)
+				{
+					log4cxx_time_t now = start + (j * 7919 + i * 104729) % 5000000;
+					LogString cached;
+					cachedFormat->format(cached, now, p);
+					LogString expected;
+					baseFormatter->format(expected, now, p);
+
+					if (cached != expected)
+					{
+						++failures[i];
+					}
+				}
+			});
+		}
+
+		for (auto& thread : threads)
+		{
+			thread.join();
+		}
+
+		for (int i = 0; i < threadCount; ++i)
+		{
+			LOGUNIT_ASSERT_EQUAL(0, failures[i]);
+		}
+	}
+
+	/**
+	 * Check that the ISO8601, ABSOLUTE and DATE formats are unchanged.
+	 */
+	void test25()
+	{
+		std::vector<DateFormatPtr> formats =
+			{ std::make_shared<ISO8601DateFormat>()
+			, std::make_shared<AbsoluteTimeDateFormat>()
+			, std::make_shared<DateTimeDateFormat>()
+			};
+		std::vector<LogString> patterns =
+			{ LOG4CXX_STR("yyyy-MM-dd HH:mm:ss,SSS ")
+			, LOG4CXX_STR("HH:mm:ss,SSS ")
+			, LOG4CXX_STR("dd MMM yyyy HH:mm:ss,SSS ")
+			};
+		Pool p;
+
+		for (size_t i = 0; i < formats.size(); ++i)
+		{
+			formats[i]->setTimeZone(TimeZone::getGMT());
+			SimpleDateFormat tokenFormat(patterns[i]);
+			tokenFormat.setTimeZone(TimeZone::getGMT());
+
+			for (log4cxx_time_t t : { log4cxx_time_t(0), log4cxx_time_t(999999)
+				, MICROSECONDS_PER_DAY * 12601L + 45296789000L
+				, MICROSECONDS_PER_DAY * -1000000L })
+			{
+				LogString actual;
+				formats[i]->format(actual, t, p);
+				actual.append(1, 0x20);
+				LogString expected;
+				tokenFormat.format(expected, t, p);
+				LOGUNIT_ASSERT_EQUAL(expected, actual);
+			}
+		}
+	}
+
 };
 
 LOGUNIT_TEST_SUITE_REGISTRATION(CachedDateFormatTestCase);
@@ -0,0 +1,205 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <log4cxx/helpers/iouringfileoutputstream.h>
+#include <log4cxx/helpers/bytebuffer.h>
+#include <log4cxx/helpers/pool.h>
+#include "../logunit.h"
+#include <fstream>
+#include <sstream>
+#include <thread>
+#if !defined(_WIN32)
+	#include <sys/stat.h>
+	#include <fcntl.h>
+	#include <unistd.h>
+#endif
+
+using namespace log4cxx;
+using namespace log4cxx::helpers;
+
+/**
+ * Tests for IOUringFileOutputStream.
+ */
+LOGUNIT_CLASS(IOUringFileOutputStreamTestCase)
+{
+	LOGUNIT_TEST_SUITE(IOUringFileOutputStreamTestCase);
+	LOGUNIT_TEST(testWriteSeveralBuffers);
+	LOGUNIT_TEST(testAppend);
+	LOGUNIT_TEST(testPipeOrder);
+	LOGUNIT_TEST(testSharedFile);
+	LOGUNIT_TEST(testAppendSharedFile);
+	LOGUNIT_TEST_SUITE_END();
+
+public:
+	/**
+	 * Content larger than all the buffers is written in order.
+	 */
+	void testWriteSeveralBuffers()
+	{
+		if (!IOUringFileOutputStream::isSupported())
+		{
+			return;
+		}
+		Pool p;
+		IOUringFileOutputStream out(LOG4CXX_STR("output/iouring-test1.log"), false, 2);
+		std::string expected = writeLines(out, 20000, p);
+		out.flush(p);
+		LOGUNIT_ASSERT_EQUAL(expected, readFile("output/iouring-test1.log"));
+		out.close(p);
+		LOGUNIT_ASSERT_EQUAL(expected, readFile("output/iouring-test1.log"));
+	}
+
+	/**
+	 * Bytes are added to the end of an existing file.
+	 */
+	void testAppend()
+	{
+		if (!IOUringFileOutputStream::isSupported())
+		{
+			return;
+		}
+		Pool p;
+		std::string expected;
+		{
+			IOUringFileOutputStream out(LOG4CXX_STR("output/iouring-test2.log"));
+			expected = writeLines(out, 100, p);
+			out.close(p);
+		}
+		{
+			IOUringFileOutputStream out(LOG4CXX_STR("output/iouring-test2.log"), true);
+			expected += writeLines(out, 100, p);
+			out.close(p);
+		}
+		LOGUNIT_ASSERT_EQUAL(expected, readFile("output/iouring-test2.log"));
+	}
+
+	/**
+	 * Bytes written to a slowly read pipe arrive in order.
+	 */
+	void testPipeOrder()
+	{
+#if !defined(_WIN32)
+		if (!IOUringFileOutputStream::isSupported())
+		{
+			return;
+		}
+		const char* fifoName = "output/iouring-test3.fifo";
+		unlink(fifoName);
+		LOGUNIT_ASSERT_EQUAL(0, mkfifo(fifoName, 0600));
+		std::string received;
+		std::thread reader([fifoName, &received]()
+		{
+			int fd = open(fifoName, O_RDONLY);
+			char buf[4096];
+			ssize_t n;
+			while (0 < (n = read(fd, buf, sizeof (buf))))
+			{
+				received.append(buf, n);
+				std::this_thread::sleep_for(std::chrono::microseconds(50));
+			}
+			close(fd);
+		});
+		Pool p;
+		std::string expected;
+		{
+			IOUringFileOutputStream out(LOG4CXX_STR("output/iouring-test3.fifo"));
+			expected = writeLines(out, 50000, p);
+			out.close(p);
+		}
+		reader.join();
+		unlink(fifoName);
+		LOGUNIT_ASSERT_EQUAL(expected.size(), received.size());
+		LOGUNIT_ASSERT(expected == received);
+#endif
+	}
+
+	/**
+	 * With a queue depth of one, bytes written by another writer are not overwritten.
+	 */
+	void testSharedFile()
+	{
+		if (!IOUringFileOutputStream::isSupported())
+		{
+			return;
+		}
+		Pool p;
+		IOUringFileOutputStream out(LOG4CXX_STR("output/iouring-test4.log"), false, 1);
+		std::string expected = writeLines(out, 10, p);
+		out.flush(p);
+		{
+			std::ofstream other("output/iouring-test4.log", std::ios::binary | std::ios::app);
+			other << "Other writer\n";
+		}
+		expected += "Other writer\n";
+		expected += writeLines(out, 10, p);
+		out.close(p);
+		LOGUNIT_ASSERT_EQUAL(expected, readFile("output/iouring-test4.log"));
+	}
+
+	/**
+	 * When appending, bytes written by another writer are not overwritten at any queue depth.
+	 */
+	void testAppendSharedFile()
+	{
+		if (!IOUringFileOutputStream::isSupported())
+		{
+			return;
+		}
+		Pool p;
+		std::string expected;
+		{
+			IOUringFileOutputStream out(LOG4CXX_STR("output/iouring-test5.log"));
+			expected = writeLines(out, 10, p);
+			out.close(p);
+		}
+		IOUringFileOutputStream out(LOG4CXX_STR("output/iouring-test5.log"), true);
+		expected += writeLines(out, 10, p);
+		out.flush(p);
+		{
+			std::ofstream other("output/iouring-test5.log", std::ios::binary | std::ios::app);
+			other << "Other writer\n";
+		}
+		expected += "Other writer\n";
+		expected += writeLines(out, 10, p);
+		out.close(p);
+		LOGUNIT_ASSERT_EQUAL(expected, readFile("output/iouring-test5.log"));
+	}
+
+private:
+	static std::string writeLines(OutputStream& out, int count, Pool& p)
+	{
+		std::string result;
+		for (int i = 0; i < count; ++i)
+		{
+			std::string line = "Line " + std::to_string(i) + " of the test output\n";
+			ByteBuffer buf(&line[0], line.size());
+			out.write(buf, p);
+			result += line;
+		}
+		return result;
+	}
+
+	static std::string readFile(const char* fileName)
+	{
+		std::ifstream in(fileName, std::ios::binary);
+		std::ostringstream content;
+		content << in.rdbuf();
+		return content.str();
+	}
+};
+
+LOGUNIT_TEST_SUITE_REGISTRATION(IOUringFileOutputStreamTestCase);
@@ -22,6 +22,7 @@
 #include <log4cxx/patternlayout.h>
 #include <log4cxx/fileappender.h>
 #include <log4cxx/logmanager.h>
+#include <atomic>
 
 using namespace log4cxx;
 using namespace log4cxx::helpers;
@@ -33,6 +34,7 @@ LOGUNIT_CLASS(ThreadUtilityTest)
 	LOGUNIT_TEST(testNullFunctions);
 	LOGUNIT_TEST(testCustomFunctions);
 	LOGUNIT_TEST(testDefaultFunctions);
+	LOGUNIT_TEST(testPeriodicTasks);
 #if LOG4CXX_HAS_PTHREAD_SETNAME || defined(WIN32)
 	LOGUNIT_TEST(testThreadNameLogging);
 #endif
@@ -102,6 +104,33 @@ public:
 		t.join();
 	}
 
+	void testPeriodicTasks()
+	{
+		auto thrUtil = ThreadUtility::instance();
+		std::atomic<int> fastCount(0);
+		std::atomic<int> slowCount(0);
+		thrUtil->addPeriodicTask(LOG4CXX_STR("fast"), [&fastCount]() { ++fastCount; }, std::chrono::milliseconds(5));
+		thrUtil->addPeriodicTask(LOG4CXX_STR("slow"), [&slowCount]() { ++slowCount; }, std::chrono::milliseconds(1000));
+		LOGUNIT_ASSERT(thrUtil->hasPeriodicTask(LOG4CXX_STR("fast")));
+
+		for (int i = 0; i < 1000 && fastCount < 5; ++i)
+		{
+			std::this_thread::sleep_for(std::chrono::milliseconds(1));
+		}
+
+		LOGUNIT_ASSERT(5 <= fastCount);
+		LOGUNIT_ASSERT_EQUAL(0, slowCount.load());
+
+		thrUtil->removePeriodicTask(LOG4CXX_STR("fast"));
+		LOGUNIT_ASSERT(!thrUtil->hasPeriodicTask(LOG4CXX_STR("fast")));
+		int count = fastCount;
+		std::this_thread::sleep_for(std::chrono::milliseconds(20));
+		LOGUNIT_ASSERT_EQUAL(count, fastCount.load());
+
+		thrUtil->removeAllPeriodicTasks();
+		LOGUNIT_ASSERT(!thrUtil->hasPeriodicTask(LOG4CXX_STR("slow")));
+	}
+
 	void testThreadNameLogging()
 	{
 		auto layout = std::make_shared<PatternLayout>(LOG4CXX_STR("%T %m%n"));
@@ -19,6 +19,8 @@
 #include "../insertwide.h"
 #include "../logunit.h"
 #include <apr_time.h>
+#include <stdlib.h>
+#include <time.h>
 
 using namespace log4cxx;
 using namespace log4cxx::helpers;
@@ -42,6 +44,8 @@ LOGUNIT_CLASS(TimeZoneTestCase)
 	LOGUNIT_TEST(test4);
 	LOGUNIT_TEST(test5);
 	LOGUNIT_TEST(test6);
+	LOGUNIT_TEST(test7);
+	LOGUNIT_TEST(test8);
 	LOGUNIT_TEST_SUITE_END();
 
 #define MICROSECONDS_PER_DAY APR_INT64_C(86400000000)
@@ -124,6 +128,99 @@ public:
 		LOGUNIT_ASSERT_EQUAL((LogString) LOG4CXX_STR("GMT"), tz->getID());
 	}
 
+	/**
+	 * Checks the default timezone against the C library
+	 * over several years, including daylight saving transitions.
+	 */
+	void test7()
+	{
+		checkLocalTime();
+#if !defined(_WIN32)
+		const char* savedTZ = getenv("TZ");
+		std::string saved(savedTZ ? savedTZ : "");
+		const char* zones[] = { "America/New_York", "Australia/Lord_Howe", "Europe/London" };
+
+		for (auto zone : zones)
+		{
+			setenv("TZ", zone, 1);
+			tzset();
+			checkLocalTime();
+		}
+
+		if (savedTZ)
+		{
+			setenv("TZ", saved.c_str(), 1);
+		}
+		else
+		{
+			unsetenv("TZ");
+		}
+		tzset();
+#endif
+	}
+
+	/**
+	 * Checks the current time follows a change of the default timezone.
+	 */
+	void test8()
+	{
+#if !defined(_WIN32)
+		const char* savedTZ = getenv("TZ");
+		std::string saved(savedTZ ? savedTZ : "");
+		const char* zones[] = { "America/New_York", "Asia/Tokyo", "Europe/London" };
+		apr_time_t now = apr_time_now();
+
+		for (auto zone : zones)
+		{
+			setenv("TZ", zone, 1);
+			tzset();
+			checkLocalTime(now);
+		}
+
+		if (savedTZ)
+		{
+			setenv("TZ", saved.c_str(), 1);
+		}
+		else
+		{
+			unsetenv("TZ");
+		}
+		tzset();
+#endif
+	}
+
+private:
+	void checkLocalTime()
+	{
+		apr_time_t begin = MICROSECONDS_PER_DAY * 18262; // 01.01.2020
+		apr_time_t end = MICROSECONDS_PER_DAY * 19723; // 01.01.2024
+		apr_time_t step = APR_INT64_C(3600000001); // Transitions occur on the hour
+
+		for (apr_time_t t = begin; t < end; t += step)
+		{
+			checkLocalTime(t);
+		}
+	}
+
+	void checkLocalTime(apr_time_t t)
+	{
+		TimeZonePtr tz(TimeZone::getDefault());
+		apr_time_exp_t expected;
+		apr_time_exp_t actual;
+		LOGUNIT_ASSERT_EQUAL(APR_SUCCESS, apr_time_exp_lt(&expected, t));
+		LOGUNIT_ASSERT_EQUAL(APR_SUCCESS, tz->explode(&actual, t));
+		LOGUNIT_ASSERT_EQUAL(expected.tm_usec, actual.tm_usec);
+		LOGUNIT_ASSERT_EQUAL(expected.tm_sec, actual.tm_sec);
+		LOGUNIT_ASSERT_EQUAL(expected.tm_min, actual.tm_min);
+		LOGUNIT_ASSERT_EQUAL(expected.tm_hour, actual.tm_hour);
+		LOGUNIT_ASSERT_EQUAL(expected.tm_mday, actual.tm_mday);
+		LOGUNIT_ASSERT_EQUAL(expected.tm_mon, actual.tm_mon);
+		LOGUNIT_ASSERT_EQUAL(expected.tm_year, actual.tm_year);
+		LOGUNIT_ASSERT_EQUAL(expected.tm_wday, actual.tm_wday);
+		LOGUNIT_ASSERT_EQUAL(expected.tm_yday, actual.tm_yday);
+		LOGUNIT_ASSERT_EQUAL(expected.tm_isdst, actual.tm_isdst);
+		LOGUNIT_ASSERT_EQUAL(expected.tm_gmtoff, actual.tm_gmtoff);
+	}
 
 };
 
@@ -63,6 +63,10 @@ LOGUNIT_CLASS(TranscoderTestCase)
 	LOGUNIT_TEST(testDecodeUTF8_2);
 	LOGUNIT_TEST(testDecodeUTF8_3);
 	LOGUNIT_TEST(testDecodeUTF8_4);
+	LOGUNIT_TEST(testDecodeUTF8_5);
+#if LOG4CXX_WCHAR_T_API
+	LOGUNIT_TEST(testLongMixedWide);
+#endif
 #if LOG4CXX_UNICHAR_API
 	LOGUNIT_TEST(udecode2);
 	LOGUNIT_TEST(udecode4);
@@ -312,6 +316,65 @@ public:
 		LOGUNIT_ASSERT_EQUAL(true, iter == out.end());
 	}
 
+	/**
+	 * Strings with ASCII runs of every length up to several vector blocks
+	 * followed by non-ASCII characters.
+	 */
+	void testDecodeUTF8_5()
+	{
+		for (size_t runLength = 0; runLength < 100; ++runLength)
+		{
+			std::string src;
+
+			for (size_t i = 0; i < runLength; ++i)
+			{
+				src.append(1, static_cast<char>('!' + i % 90));
+			}
+
+			src.append("\xC2\xA9");
+			src.append(runLength % 37, 'x');
+			src.append("\xE2\x82\xAC");
+			LogString out;
+			Transcoder::decodeUTF8(src, out);
+			std::string encoded;
+			Transcoder::encodeUTF8(out, encoded);
+			LOGUNIT_ASSERT_EQUAL(src, encoded);
+			LogString::const_iterator iter = out.begin() + runLength;
+			LOGUNIT_ASSERT_EQUAL((unsigned int) 0xA9, Transcoder::decode(out, iter));
+		}
+	}
+
+#if LOG4CXX_WCHAR_T_API
+	void testLongMixedWide()
+	{
+		for (size_t runLength = 0; runLength < 100; ++runLength)
+		{
+			std::wstring src;
+
+			for (size_t i = 0; i < runLength; ++i)
+			{
+				src.append(1, static_cast<wchar_t>(L'!' + i % 90));
+			}
+
+			src.append(1, 0x0605);
+			src.append(runLength % 37, L'x');
+			src.append(1, 0x40E3);
+			LogString decoded;
+			Transcoder::decode(src, decoded);
+			LogString expected;
+
+			for (std::wstring::const_iterator i = src.begin(); i != src.end(); ++i)
+			{
+				Transcoder::encode(*i, expected);
+			}
+
+			LOGUNIT_ASSERT_EQUAL(expected, decoded);
+			std::wstring encoded;
+			Transcoder::encode(decoded, encoded);
+			LOGUNIT_ASSERT_EQUAL(src, encoded);
+		}
+	}
+#endif
 
 #if LOG4CXX_UNICHAR_API
 	void udecode2()
@@ -50,6 +50,7 @@ LOGUNIT_CLASS(JSONLayoutTest), public JSONLayout
 	LOGUNIT_TEST(testIgnoresThrowable);
 	LOGUNIT_TEST(testAppendQuotedEscapedStringWithPrintableChars);
 	LOGUNIT_TEST(testAppendQuotedEscapedStringWithControlChars);
+	LOGUNIT_TEST(testAppendQuotedEscapedLongString);
 	LOGUNIT_TEST(testAppendSerializedMDC);
 	LOGUNIT_TEST(testAppendSerializedMDCWithPrettyPrint);
 	LOGUNIT_TEST(testAppendSerializedNDC);
@@ -59,6 +60,7 @@ LOGUNIT_CLASS(JSONLayoutTest), public JSONLayout
 	LOGUNIT_TEST(testFormat);
 	LOGUNIT_TEST(testFormatWithPrettyPrint);
 	LOGUNIT_TEST(testGetSetLocationInfo);
+	LOGUNIT_TEST(testSetPrettyPrintAfterFormat);
 	LOGUNIT_TEST_SUITE_END();
 
 
@@ -165,6 +167,36 @@ public:
 		LOGUNIT_ASSERT_EQUAL(cr_expected, cr_escaped);
 	}
 
+	/**
+	 * Tests appendQuotedEscapedString with special characters at every position
+	 * of strings longer than a vector register.
+	 */
+	void testAppendQuotedEscapedLongString()
+	{
+		const logchar special[] = { 0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x22, 0x5c };
+		const logchar* escaped[] =
+			{ LOG4CXX_STR("\\b"), LOG4CXX_STR("\\t"), LOG4CXX_STR("\\n"), LOG4CXX_STR("\x0b")
+			, LOG4CXX_STR("\\f"), LOG4CXX_STR("\\r"), LOG4CXX_STR("\\\""), LOG4CXX_STR("\\\\")
+			};
+
+		for (size_t position = 0; position < 70; ++position)
+		{
+			for (size_t i = 0; i < sizeof(special) / sizeof(special[0]); ++i)
+			{
+				LogString input(70, LOG4CXX_STR('a'));
+				input[position] = special[i];
+				input[69 - position] = 0x7F;
+				LogString expected(input);
+				expected.replace(position, 1, escaped[i]);
+				expected.insert(0, 1, 0x22);
+				expected.append(1, 0x22);
+				LogString output;
+				appendQuotedEscapedString(output, input);
+				LOGUNIT_ASSERT_EQUAL(expected, output);
+			}
+		}
+	}
+
 	/**
 	 * Tests appendSerializedMDC.
 	 */
@@ -478,6 +510,35 @@ public:
 		layout.setPrettyPrint(false);
 		LOGUNIT_ASSERT_EQUAL(false, layout.getPrettyPrint());
 	}
+
+	/**
+	 * Tests the output changes when PrettyPrint is set after formatting.
+	 */
+	void testSetPrettyPrintAfterFormat()
+	{
+		Pool p;
+		LoggingEventPtr event = LoggingEventPtr(new LoggingEvent(LOG4CXX_STR("Logger"),
+					Level::getInfo(),
+					LOG4CXX_STR("A message goes here."),
+					spi::LocationInfo::getLocationUnavailable()));
+		JSONLayout layout;
+		LogString compact;
+		layout.format(compact, event, p);
+		layout.setPrettyPrint(true);
+		LogString pretty;
+		layout.format(pretty, event, p);
+		LOGUNIT_ASSERT_EQUAL((LogString) LOG4CXX_STR("{ \"timestamp\": "), compact.substr(0, 15));
+		LogString prettyStart(LOG4CXX_STR("{"));
+		prettyStart.append(LOG4CXX_EOL);
+		prettyStart.append(ppIndentL1);
+		prettyStart.append(LOG4CXX_STR("\"timestamp\": "));
+		LOGUNIT_ASSERT_EQUAL(prettyStart, pretty.substr(0, prettyStart.size()));
+		LogString prettyMessage(LOG4CXX_STR(","));
+		prettyMessage.append(LOG4CXX_EOL);
+		prettyMessage.append(ppIndentL1);
+		prettyMessage.append(LOG4CXX_STR("\"message\": \"A message goes here.\""));
+		LOGUNIT_ASSERT(pretty.find(prettyMessage) != LogString::npos);
+	}
 };
 
 
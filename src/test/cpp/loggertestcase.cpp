@@ -19,6 +19,7 @@
 #include <log4cxx/logger.h>
 #include <log4cxx/fileappender.h>
 #include <log4cxx/appenderskeleton.h>
+#include <log4cxx/patternlayout.h>
 #include <log4cxx/basicconfigurator.h>
 #include <log4cxx/logmanager.h>
 #include <log4cxx/level.h>
@@ -30,6 +31,7 @@
 #include "logunit.h"
 #include <log4cxx/helpers/locale.h>
 #include "vectorappender.h"
+#include <thread>
 
 using namespace log4cxx;
 using namespace log4cxx::spi;
@@ -60,14 +62,33 @@ class CountingAppender : public AppenderSkeleton
 		}
 };
 
+/**
+ * An appender which detaches itself from a logger when it receives an event.
+ */
+class DetachingAppender : public CountingAppender
+{
+	public:
+		LoggerPtr logger;
+
+		void append(const spi::LoggingEventPtr& event, Pool& p) override
+		{
+			CountingAppender::append(event, p);
+			logger->removeAppender(this->getName());
+		}
+};
+
 LOGUNIT_CLASS(LoggerTestCase)
 {
 	LOGUNIT_TEST_SUITE(LoggerTestCase);
 	LOGUNIT_TEST(testAppender1);
 	LOGUNIT_TEST(testAppender2);
+	LOGUNIT_TEST(testRemoveAppenderWhileAppending);
 	LOGUNIT_TEST(testAdditivity1);
 	LOGUNIT_TEST(testAdditivity2);
 	LOGUNIT_TEST(testAdditivity3);
+	LOGUNIT_TEST(testAdditivity4);
+	LOGUNIT_TEST(testRemovedAppenderReleased);
+	LOGUNIT_TEST(testSharedFormattedText);
 	LOGUNIT_TEST(testDisable1);
 	//    LOGUNIT_TEST(testRB1);
 	//    LOGUNIT_TEST(testRB2);  //TODO restore
@@ -76,6 +97,8 @@ LOGUNIT_CLASS(LoggerTestCase)
 	LOGUNIT_TEST(testHierarchy1);
 	LOGUNIT_TEST(testTrace);
 	LOGUNIT_TEST(testIsTraceEnabled);
+	LOGUNIT_TEST(testEnabledForThreshold);
+	LOGUNIT_TEST(testEventOutlivesThread);
 	LOGUNIT_TEST_SUITE_END();
 
 public:
@@ -128,6 +151,31 @@ public:
 		LOGUNIT_ASSERT(list.size() == 1);
 	}
 
+	/**
+	Remove an appender while an event is being appended and check
+	the event still reaches the remaining appenders.
+	*/
+	void testRemoveAppenderWhileAppending()
+	{
+		logger = Logger::getLogger(LOG4CXX_TEST_STR("test"));
+		auto detaching = std::make_shared<DetachingAppender>();
+		detaching->setName(LOG4CXX_STR("detaching"));
+		detaching->logger = logger;
+		CountingAppenderPtr counting = CountingAppenderPtr(new CountingAppender());
+		logger->addAppender(detaching);
+		logger->addAppender(counting);
+
+		logger->info(LOG4CXX_STR("first"));
+		LOGUNIT_ASSERT_EQUAL(1, detaching->counter);
+		LOGUNIT_ASSERT_EQUAL(1, counting->counter);
+		LOGUNIT_ASSERT_EQUAL((size_t) 1, logger->getAllAppenders().size());
+
+		logger->info(LOG4CXX_STR("second"));
+		LOGUNIT_ASSERT_EQUAL(1, detaching->counter);
+		LOGUNIT_ASSERT_EQUAL(2, counting->counter);
+		detaching->logger = 0;
+	}
+
 	/**
 	Test if LoggerPtr a.b inherits its appender from a.
 	*/
@@ -227,6 +275,85 @@ public:
 		LOGUNIT_ASSERT_EQUAL(caABC->counter, 1);
 	}
 
+	/**
+	Check an appender attached to several ancestors receives each event once
+	and that loggers created later are routed to their appenders.
+	*/
+	void testAdditivity4()
+	{
+		LoggerPtr root = Logger::getRootLogger();
+		LoggerPtr abcdef = Logger::getLogger(LOG4CXX_TEST_STR("a.b.c.d.e.f"));
+
+		CountingAppenderPtr shared = CountingAppenderPtr(new CountingAppender());
+		CountingAppenderPtr caABC = CountingAppenderPtr(new CountingAppender());
+
+		root->addAppender(shared);
+		abcdef->debug(MSG);
+		LOGUNIT_ASSERT_EQUAL(shared->counter, 1);
+
+		LoggerPtr abc = Logger::getLogger(LOG4CXX_TEST_STR("a.b.c"));
+		abc->addAppender(shared);
+		abc->addAppender(caABC);
+		abcdef->debug(MSG);
+		LOGUNIT_ASSERT_EQUAL(shared->counter, 2);
+		LOGUNIT_ASSERT_EQUAL(caABC->counter, 1);
+
+		abc->setAdditivity(false);
+		root->removeAppender(shared);
+		abcdef->debug(MSG);
+		root->debug(MSG);
+		LOGUNIT_ASSERT_EQUAL(shared->counter, 3);
+		LOGUNIT_ASSERT_EQUAL(caABC->counter, 2);
+	}
+
+	/**
+	Check a removed appender is not kept alive by
+	a logger which logged to it and has not logged since.
+	*/
+	void testRemovedAppenderReleased()
+	{
+		LoggerPtr root = Logger::getRootLogger();
+		LoggerPtr abc = Logger::getLogger(LOG4CXX_TEST_STR("a.b.c"));
+		CountingAppenderPtr counting = CountingAppenderPtr(new CountingAppender());
+		std::weak_ptr<CountingAppender> weak = counting;
+
+		root->addAppender(counting);
+		abc->debug(MSG);
+		LOGUNIT_ASSERT_EQUAL(counting->counter, 1);
+
+		root->removeAllAppenders();
+		counting.reset();
+		LOGUNIT_ASSERT(weak.expired());
+	}
+
+	/**
+	Check formatted text is kept only for a layout
+	used by more than one appender of the logger.
+	*/
+	void testSharedFormattedText()
+	{
+		LoggerPtr logger = Logger::getLogger(LOG4CXX_TEST_STR("shared.text"));
+		logger->setAdditivity(false);
+		auto layout1 = std::make_shared<PatternLayout>(LOG4CXX_STR("%m%n"));
+		auto layout2 = std::make_shared<PatternLayout>(LOG4CXX_STR("%m%n"));
+		auto va1 = std::make_shared<VectorAppender>();
+		va1->setLayout(layout1);
+		logger->addAppender(va1);
+
+		logger->info(MSG);
+		LOGUNIT_ASSERT(!va1->getVector().back()->isFormattedEventShared(layout1->getFormatKey()));
+
+		auto va2 = std::make_shared<VectorAppender>();
+		va2->setLayout(layout2);
+		logger->addAppender(va2);
+
+		logger->info(MSG);
+		LOGUNIT_ASSERT(va1->getVector().back()->isFormattedEventShared(layout1->getFormatKey()));
+
+		logger->removeAllAppenders();
+		logger->setAdditivity(true);
+	}
+
 	void testDisable1()
 	{
 		CountingAppenderPtr caRoot = CountingAppenderPtr(new CountingAppender());
@@ -488,6 +615,68 @@ public:
 		LOGUNIT_ASSERT_EQUAL(true, Logger::isErrorEnabledFor(root));
 	}
 
+	/**
+	Check enablement follows ancestor level changes and the hierarchy threshold.
+	*/
+	void testEnabledForThreshold()
+	{
+		LoggerPtr root = Logger::getRootLogger();
+		root->setLevel(Level::getInfo());
+		LoggerPtr abc = Logger::getLogger(LOG4CXX_TEST_STR("a.b.c"));
+		LOGUNIT_ASSERT_EQUAL(false, Logger::isDebugEnabledFor(abc));
+		LOGUNIT_ASSERT_EQUAL(false, abc->isEnabledFor(Level::getDebug()));
+
+		LoggerPtr a = Logger::getLogger(LOG4CXX_TEST_STR("a"));
+		a->setLevel(Level::getDebug());
+		LOGUNIT_ASSERT_EQUAL(true, Logger::isDebugEnabledFor(abc));
+		LOGUNIT_ASSERT_EQUAL(true, abc->isEnabledFor(Level::getDebug()));
+
+		auto h = LogManager::getLoggerRepository();
+		h->setThreshold(Level::getWarn());
+		LOGUNIT_ASSERT_EQUAL(false, Logger::isInfoEnabledFor(abc));
+		LOGUNIT_ASSERT_EQUAL(false, abc->isEnabledFor(Level::getInfo()));
+		LOGUNIT_ASSERT_EQUAL(false, root->isInfoEnabled());
+		LOGUNIT_ASSERT_EQUAL(true, Logger::isWarnEnabledFor(abc));
+
+		h->setThreshold(Level::getAll());
+		LOGUNIT_ASSERT_EQUAL(true, Logger::isDebugEnabledFor(abc));
+		LOGUNIT_ASSERT_EQUAL(true, Logger::isInfoEnabledFor(root));
+
+		a->setLevel(Level::getOff());
+		LOGUNIT_ASSERT_EQUAL(false, abc->isEnabledFor(Level::getFatal()));
+		LOGUNIT_ASSERT_EQUAL(true, abc->isEnabledFor(Level::getOff()));
+
+		// A logger outside a hierarchy enables nothing
+		Pool p;
+		auto detached = std::make_shared<Logger>(p, LOG4CXX_STR("detached"));
+		detached->setLevel(Level::getAll());
+		LOGUNIT_ASSERT_EQUAL(false, detached->isEnabledFor(Level::getFatal()));
+		LOGUNIT_ASSERT_EQUAL(false, detached->isEnabledFor(Level::getOff()));
+	}
+
+	/**
+	 * The names referenced by an event remain valid after its thread has ended.
+	 */
+	void testEventOutlivesThread()
+	{
+		LoggerPtr a = Logger::getLogger(LOG4CXX_TEST_STR("a.thread.ended"));
+		VectorAppenderPtr appender = VectorAppenderPtr(new VectorAppender());
+		a->addAppender(appender);
+		std::thread t([a]()
+			{
+				LOG4CXX_INFO(a, "Message");
+			});
+		t.join();
+		LOG4CXX_INFO(a, "Message");
+
+		std::vector<LoggingEventPtr> events = appender->getVector();
+		LOGUNIT_ASSERT_EQUAL((size_t) 2, events.size());
+		LOGUNIT_ASSERT(!events[0]->getThreadName().empty());
+		LOGUNIT_ASSERT(events[0]->getThreadName() != events[1]->getThreadName());
+		LOGUNIT_ASSERT_EQUAL((LogString) LOG4CXX_STR("a.thread.ended"), events[0]->getLoggerName());
+		a->removeAppender(appender);
+	}
+
 protected:
 	static LogString MSG;
 	LoggerPtr logger;
@@ -0,0 +1,196 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <log4cxx/mappedfileappender.h>
+#include <log4cxx/patternlayout.h>
+#include <log4cxx/logger.h>
+#include <log4cxx/helpers/pool.h>
+#include <log4cxx/helpers/mappedfileoutputstream.h>
+#include <log4cxx/helpers/transcoder.h>
+#include <log4cxx/helpers/bytebuffer.h>
+#include <log4cxx/spi/loggingevent.h>
+#include "logunit.h"
+#include <fstream>
+#include <sstream>
+#if !defined(_WIN32)
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+using namespace log4cxx;
+using namespace log4cxx::helpers;
+using namespace log4cxx::spi;
+
+/**
+ * MappedFileAppender tests.
+ */
+LOGUNIT_CLASS(MappedFileAppenderTestCase)
+{
+	LOGUNIT_TEST_SUITE(MappedFileAppenderTestCase);
+	LOGUNIT_TEST(testWriteSeveralExtents);
+	LOGUNIT_TEST(testAppend);
+	LOGUNIT_TEST(testAppendAfterAbnormalTermination);
+	LOGUNIT_TEST(testAppendKeepsTrailingZeros);
+	LOGUNIT_TEST_SUITE_END();
+
+public:
+	/**
+	 * Events written across several extents are in the file,
+	 * which is truncated to the length written when closed.
+	 */
+	void testWriteSeveralExtents()
+	{
+		if (!MappedFileOutputStream::isSupported())
+		{
+			return;
+		}
+		LogString fileName(LOG4CXX_STR("output/mapped-test1.log"));
+		MappedFileAppenderPtr appender = std::make_shared<MappedFileAppender>();
+		appender->setLayout(std::make_shared<PatternLayout>(LOG4CXX_STR("%m%n")));
+		appender->setFile(fileName);
+		appender->setAppend(false);
+		appender->setMappedExtentSize(4096);
+		Pool p;
+		appender->activateOptions(p);
+
+		std::string expected;
+		for (int i = 0; i < 2000; ++i)
+		{
+			std::string msg = "Message " + std::to_string(i);
+			expected += msg + "\n";
+			appender->doAppend(makeEvent(msg), p);
+		}
+		LOGUNIT_ASSERT(expected.size() < File(fileName).length(p));
+		appender->close();
+
+		LOGUNIT_ASSERT_EQUAL(expected, readFile("output/mapped-test1.log"));
+	}
+
+	/**
+	 * Events are added to the end of an existing file.
+	 */
+	void testAppend()
+	{
+		if (!MappedFileOutputStream::isSupported())
+		{
+			return;
+		}
+		writeFile("output/mapped-test2.log", std::string("Existing\n"));
+		MappedFileAppenderPtr appender = std::make_shared<MappedFileAppender>
+			( std::make_shared<PatternLayout>(LOG4CXX_STR("%m%n"))
+			, LOG4CXX_STR("output/mapped-test2.log")
+			);
+		Pool p;
+		appender->doAppend(makeEvent("Added"), p);
+		appender->close();
+
+		LOGUNIT_ASSERT_EQUAL(std::string("Existing\nAdded\n"), readFile("output/mapped-test2.log"));
+	}
+
+	/**
+	 * The preallocated space left in a file that was not closed is reused,
+	 * and the bytes written before the last flush are kept.
+	 */
+	void testAppendAfterAbnormalTermination()
+	{
+#if !defined(_WIN32)
+		if (!MappedFileOutputStream::isSupported())
+		{
+			return;
+		}
+		std::string before("Before\n\0", 8);
+		pid_t child = fork();
+
+		if (child == 0)
+		{
+			// Terminate without closing the stream
+			MappedFileOutputStream out(LOG4CXX_STR("output/mapped-test3.log"), false, 4096);
+			Pool p;
+			ByteBuffer buf(const_cast<char*>(before.data()), before.size());
+			out.write(buf, p);
+			out.flush(p);
+			_exit(0);
+		}
+
+		int status = -1;
+		LOGUNIT_ASSERT_EQUAL(child, waitpid(child, &status, 0));
+		LOGUNIT_ASSERT_EQUAL(0, status);
+		LOGUNIT_ASSERT(before.size() < readFile("output/mapped-test3.log").size());
+
+		MappedFileAppenderPtr appender = std::make_shared<MappedFileAppender>
+			( std::make_shared<PatternLayout>(LOG4CXX_STR("%m%n"))
+			, LOG4CXX_STR("output/mapped-test3.log")
+			);
+		Pool p;
+		appender->doAppend(makeEvent("After"), p);
+		appender->close();
+
+		LOGUNIT_ASSERT_EQUAL(before + "After\n", readFile("output/mapped-test3.log"));
+#endif
+	}
+
+	/**
+	 * Zero bytes at the end of a closed file are not removed.
+	 */
+	void testAppendKeepsTrailingZeros()
+	{
+		if (!MappedFileOutputStream::isSupported())
+		{
+			return;
+		}
+		std::string existing("a\0\n\0", 4); // UTF-16LE
+		existing.append(4092, '\0');
+		writeFile("output/mapped-test4.log", existing);
+		MappedFileAppenderPtr appender = std::make_shared<MappedFileAppender>
+			( std::make_shared<PatternLayout>(LOG4CXX_STR("%m%n"))
+			, LOG4CXX_STR("output/mapped-test4.log")
+			);
+		Pool p;
+		appender->doAppend(makeEvent("Added"), p);
+		appender->close();
+
+		LOGUNIT_ASSERT_EQUAL(existing + "Added\n", readFile("output/mapped-test4.log"));
+	}
+
+private:
+	static LoggingEventPtr makeEvent(const std::string& msg)
+	{
+		LOG4CXX_DECODE_CHAR(lsMsg, msg);
+		return std::make_shared<LoggingEvent>
+			( LOG4CXX_STR("org.apache.log4j.MappedFileAppenderTestCase")
+			, Level::getInfo()
+			, lsMsg
+			, LocationInfo::getLocationUnavailable()
+			);
+	}
+
+	static std::string readFile(const char* fileName)
+	{
+		std::ifstream in(fileName, std::ios::binary);
+		std::ostringstream content;
+		content << in.rdbuf();
+		return content.str();
+	}
+
+	static void writeFile(const char* fileName, const std::string& content)
+	{
+		std::ofstream out(fileName, std::ios::binary | std::ios::trunc);
+		out << content;
+	}
+};
+
+LOGUNIT_TEST_SUITE_REGISTRATION(MappedFileAppenderTestCase);
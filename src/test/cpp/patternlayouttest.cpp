@@ -19,6 +19,7 @@
 #include <log4cxx/propertyconfigurator.h>
 #include <log4cxx/mdc.h>
 #include <log4cxx/patternlayout.h>
+#include <log4cxx/simplelayout.h>
 #include <log4cxx/fileappender.h>
 
 #include "util/compare.h"
@@ -32,6 +33,8 @@
 #include "util/linenumberfilter.h"
 #include "util/filenamefilter.h"
 #include <iostream>
+#include <fstream>
+#include <iterator>
 #include <log4cxx/helpers/transcoder.h>
 #include <log4cxx/helpers/pool.h>
 #include <apr_strings.h>
@@ -60,6 +63,33 @@
 using namespace log4cxx;
 using namespace log4cxx::helpers;
 
+#if !LOG4CXX_LOGCHAR_IS_UTF8
+namespace
+{
+/**
+ * A layout with a format key whose output shows which format function was used.
+ */
+class KeyedLayout : public SimpleLayout
+{
+	public:
+		void format(LogString& output, const spi::LoggingEventPtr&, Pool&) const override
+		{
+			output.append(LOG4CXX_STR("formatted "));
+		}
+
+		void formatUTF8(std::string& output, const spi::LoggingEventPtr&, Pool&) const override
+		{
+			output.append("direct ");
+		}
+
+		const void* getFormatKey() const override
+		{
+			return this;
+		}
+};
+}
+#endif
+
 LOGUNIT_CLASS(PatternLayoutTest)
 {
 	LOGUNIT_TEST_SUITE(PatternLayoutTest);
@@ -79,6 +109,14 @@ LOGUNIT_CLASS(PatternLayoutTest)
 	LOGUNIT_TEST(test14);
 	LOGUNIT_TEST(testMDC1);
 	LOGUNIT_TEST(testMDC2);
+	LOGUNIT_TEST(testSharedOutput);
+	LOGUNIT_TEST(testSharedField);
+	LOGUNIT_TEST(testSharedUTF8Writer);
+#if !LOG4CXX_LOGCHAR_IS_UTF8
+	LOGUNIT_TEST(testDirectUTF8Writer);
+#endif
+	LOGUNIT_TEST(testFormatUTF8);
+	LOGUNIT_TEST(testCompiledFields);
 	LOGUNIT_TEST_SUITE_END();
 
 	LoggerPtr root;
@@ -533,6 +571,210 @@ public:
 		return msg;
 	}
 
+	/**
+	 * Layouts with the same pattern reuse the text produced for an event.
+	 */
+	void testSharedOutput()
+	{
+		auto layout1 = std::make_shared<PatternLayout>(LOG4CXX_STR("%d %-5p %c - %m%n"));
+		auto layout2 = std::make_shared<PatternLayout>(LOG4CXX_STR("%d %-5p %c - %m%n"));
+		auto layout3 = std::make_shared<PatternLayout>(LOG4CXX_STR("%-5p %c - %m%n"));
+		LOGUNIT_ASSERT(layout1->getFormatKey() != 0);
+		LOGUNIT_ASSERT_EQUAL(layout1->getFormatKey(), layout2->getFormatKey());
+		LOGUNIT_ASSERT(layout1->getFormatKey() != layout3->getFormatKey());
+
+		auto event = std::make_shared<spi::LoggingEvent>
+			( LOG4CXX_STR("org.example.shared")
+			, Level::getInfo()
+			, LOG4CXX_LOCATION
+			, LogString(LOG4CXX_STR("Hello"))
+			);
+		Pool p;
+		LogString expected;
+		layout1->format(expected, event, p);
+
+		// Text is not kept unless other appenders may use it
+		LogString direct, notKept;
+		layout1->formatShared(direct, event, p);
+		LOGUNIT_ASSERT_EQUAL(expected, direct);
+		LOGUNIT_ASSERT(!event->getFormattedEvent(layout1->getFormatKey(), notKept));
+
+		event->shareFormattedText({layout1->getFormatKey(), layout3->getFormatKey()});
+		LogString text1, text3;
+		layout1->formatShared(text1, event, p);
+		layout3->formatShared(text3, event, p);
+		LOGUNIT_ASSERT_EQUAL(expected, text1);
+		LOGUNIT_ASSERT_EQUAL(LogString(LOG4CXX_STR("INFO  org.example.shared - Hello")) + LOG4CXX_EOL, text3);
+
+		LogString kept1, kept2, kept3;
+		LOGUNIT_ASSERT(event->getFormattedEvent(layout1->getFormatKey(), kept1));
+		LOGUNIT_ASSERT_EQUAL(text1, kept1);
+		LOGUNIT_ASSERT(event->getFormattedEvent(layout3->getFormatKey(), kept3));
+		LOGUNIT_ASSERT_EQUAL(text3, kept3);
+
+		// layout2 uses the text kept for layout1 instead of formatting
+		auto event2 = std::make_shared<spi::LoggingEvent>
+			( LOG4CXX_STR("org.example.shared")
+			, Level::getInfo()
+			, LOG4CXX_LOCATION
+			, LogString(LOG4CXX_STR("Hello"))
+			);
+		event2->shareFormattedText({layout1->getFormatKey()});
+		event2->keepFormattedEvent(layout1->getFormatKey(), LOG4CXX_STR("kept"), 4);
+		layout2->formatShared(kept2, event2, p);
+		LOGUNIT_ASSERT_EQUAL(LogString(LOG4CXX_STR("kept")), kept2);
+	}
+
+	/**
+	 * Short converter output is kept with the event.
+	 */
+	void testSharedField()
+	{
+		auto event = std::make_shared<spi::LoggingEvent>
+			( LOG4CXX_STR("org.example.shared")
+			, Level::getInfo()
+			, LOG4CXX_LOCATION
+			, LogString(LOG4CXX_STR("Hello"))
+			);
+		event->shareFormattedText({});
+		int key1, key2;
+		LogString field(LOG4CXX_STR("2024-02-29 23:59:59,999"));
+		LogString longField(200, 0x41 /* 'A' */);
+		event->keepFormattedField(&key1, field.data(), field.size());
+		event->keepFormattedField(&key2, longField.data(), longField.size());
+
+		LogString dest(LOG4CXX_STR(">"));
+		LOGUNIT_ASSERT(event->getFormattedField(&key1, dest));
+		LOGUNIT_ASSERT_EQUAL(LOG4CXX_STR(">") + field, dest);
+		LOGUNIT_ASSERT(!event->getFormattedField(&key2, dest));
+
+		auto layout1 = std::make_shared<PatternLayout>(LOG4CXX_STR("%d{yyyy-MM-dd HH:mm:ss} %m"));
+		auto layout2 = std::make_shared<PatternLayout>(LOG4CXX_STR("[%d{yyyy-MM-dd HH:mm:ss}]"));
+		Pool p;
+		LogString text1, text2;
+		layout1->format(text1, event, p);
+		layout2->format(text2, event, p);
+		LOGUNIT_ASSERT_EQUAL(text1.substr(0, 19), text2.substr(1, 19));
+	}
+
+	/**
+	 * An appender writing UTF-8 uses the text kept for an event.
+	 */
+	void testSharedUTF8Writer()
+	{
+		auto layout = std::make_shared<PatternLayout>(LOG4CXX_STR("%-5p %c - %m%n"));
+		auto appender = std::make_shared<FileAppender>();
+		appender->setFile(LOG4CXX_STR("output/patternLayoutShared.log"));
+		appender->setAppend(false);
+		appender->setEncoding(LOG4CXX_STR("UTF-8"));
+		appender->setLayout(layout);
+		Pool p;
+		appender->activateOptions(p);
+
+		auto event = std::make_shared<spi::LoggingEvent>
+			( LOG4CXX_STR("org.example.shared")
+			, Level::getInfo()
+			, LOG4CXX_LOCATION
+			, LogString(LOG4CXX_STR("Hello"))
+			);
+		event->shareFormattedText({layout->getFormatKey()});
+		event->keepFormattedEvent(layout->getFormatKey(), LOG4CXX_STR("kept"), 4);
+		appender->doAppend(event, p);
+		appender->close();
+
+		std::ifstream in("output/patternLayoutShared.log", std::ios::binary);
+		std::string content((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+		LOGUNIT_ASSERT_EQUAL(std::string("kept"), content);
+	}
+
+#if !LOG4CXX_LOGCHAR_IS_UTF8
+	/**
+	 * An appender writing UTF-8 formats directly to bytes
+	 * unless the text of the event is shared with other appenders.
+	 */
+	void testDirectUTF8Writer()
+	{
+		auto layout = std::make_shared<KeyedLayout>();
+		auto appender = std::make_shared<FileAppender>();
+		appender->setFile(LOG4CXX_STR("output/patternLayoutDirect.log"));
+		appender->setAppend(false);
+		appender->setEncoding(LOG4CXX_STR("UTF-8"));
+		appender->setLayout(layout);
+		Pool p;
+		appender->activateOptions(p);
+
+		auto event = std::make_shared<spi::LoggingEvent>
+			( LOG4CXX_STR("org.example.direct")
+			, Level::getInfo()
+			, LOG4CXX_LOCATION
+			, LogString(LOG4CXX_STR("Hello"))
+			);
+		appender->doAppend(event, p);
+
+		auto sharedEvent = std::make_shared<spi::LoggingEvent>
+			( LOG4CXX_STR("org.example.direct")
+			, Level::getInfo()
+			, LOG4CXX_LOCATION
+			, LogString(LOG4CXX_STR("Hello"))
+			);
+		sharedEvent->shareFormattedText({layout->getFormatKey()});
+		appender->doAppend(sharedEvent, p);
+		appender->close();
+
+		std::ifstream in("output/patternLayoutDirect.log", std::ios::binary);
+		std::string content((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+		LOGUNIT_ASSERT_EQUAL(std::string("direct formatted "), content);
+	}
+#endif
+
+	/**
+	 * Formatting directly to UTF-8 matches encoding the formatted text.
+	 */
+	void testFormatUTF8()
+	{
+		auto layout = std::make_shared<PatternLayout>(LOG4CXX_STR("%-8c|%.3p|caf\u00e9 %m [%t]%n"));
+		auto event = std::make_shared<spi::LoggingEvent>
+			( LOG4CXX_STR("abc")
+			, Level::getInfo()
+			, LOG4CXX_LOCATION
+			, LogString(LOG4CXX_STR("d\u00e9j\u00e0 vu"))
+			);
+		Pool p;
+		LogString text;
+		layout->format(text, event, p);
+		std::string expected("prefix");
+		Transcoder::encodeUTF8(text, expected);
+
+		std::string bytes("prefix");
+		layout->formatUTF8(bytes, event, p);
+		LOGUNIT_ASSERT_EQUAL(expected, bytes);
+		LOGUNIT_ASSERT_EQUAL(std::string("prefixabc     |NFO|caf\xC3\xA9 d\xC3\xA9j\xC3\xA0 vu ["), bytes.substr(0, 36));
+	}
+
+	void testCompiledFields()
+	{
+		auto layout = std::make_shared<PatternLayout>
+			(LOG4CXX_STR("[%5n]%-6p|%.2t|%c{1}|%8c|%m|%.3m%n"));
+		auto event = std::make_shared<spi::LoggingEvent>
+			( LOG4CXX_STR("org.example")
+			, Level::getWarn()
+			, LOG4CXX_LOCATION
+			, LogString(LOG4CXX_STR("message"))
+			);
+		Pool p;
+		LogString text(LOG4CXX_STR("prefix"));
+		layout->format(text, event, p);
+		LogString threadName = event->getThreadName();
+		LogString expected(LOG4CXX_STR("prefix["));
+		expected.append(5 - LogString(LOG4CXX_EOL).size(), 0x20);
+		expected.append(LOG4CXX_EOL);
+		expected.append(LOG4CXX_STR("]WARN  |"));
+		expected.append(threadName.substr(threadName.size() < 2 ? 0 : threadName.size() - 2));
+		expected.append(LOG4CXX_STR("|example|org.example|message|age"));
+		expected.append(LOG4CXX_EOL);
+		LOGUNIT_ASSERT_EQUAL(expected, text);
+	}
+
 	void common()
 	{
 		int i = -1;
@@ -33,6 +33,8 @@
 #include <log4cxx/consoleappender.h>
 #include <log4cxx/helpers/exception.h>
 #include <log4cxx/helpers/fileoutputstream.h>
+#include <log4cxx/helpers/writer.h>
+#include <log4cxx/spi/loggingevent.h>
 
 
 using namespace log4cxx;
@@ -41,6 +43,59 @@ using namespace log4cxx::filter;
 using namespace log4cxx::helpers;
 using namespace log4cxx::rolling;
 
+namespace
+{
+/**
+ * Passes output to another writer while counting the non-empty writes.
+ */
+class CountingWriter : public Writer
+{
+	public:
+		CountingWriter(const WriterPtr& out, int& writeCount) : out(out), writeCount(writeCount)
+		{
+		}
+
+		void close(Pool& p) override
+		{
+			out->close(p);
+		}
+
+		void flush(Pool& p) override
+		{
+			out->flush(p);
+		}
+
+		void write(const LogString& str, Pool& p) override
+		{
+			if (!str.empty())
+			{
+				++writeCount;
+			}
+
+			out->write(str, p);
+		}
+
+	private:
+		WriterPtr out;
+		int& writeCount;
+};
+
+/**
+ * A RollingFileAppender which counts the writes to each of its files.
+ */
+class CountingRollingFileAppender : public RollingFileAppender
+{
+	public:
+		int writeCount = 0;
+
+	protected:
+		WriterPtr createWriter(OutputStreamPtr& os) override
+		{
+			return std::make_shared<CountingWriter>(RollingFileAppender::createWriter(os), writeCount);
+		}
+};
+}
+
 /**
  *
  * Do not forget to call activateOptions when configuring programatically.
@@ -57,6 +112,8 @@ LOGUNIT_CLASS(SizeBasedRollingTest)
 	LOGUNIT_TEST(test4);
 	LOGUNIT_TEST(test5);
 	LOGUNIT_TEST(test6);
+	LOGUNIT_TEST(testMemoryMapped);
+	LOGUNIT_TEST(testBatch);
 	LOGUNIT_TEST_SUITE_END();
 
 	LoggerPtr root;
@@ -363,6 +420,86 @@ public:
 		LOGUNIT_ASSERT_EQUAL(true, Compare::compare(File("output/sbr-test6.log"),  File("witness/rolling/sbr-test3.log")));
 	}
 
+	/**
+	 * Test rolling of memory mapped files, which must be truncated to the length written.
+	 */
+	void testMemoryMapped()
+	{
+		PatternLayoutPtr layout = PatternLayoutPtr(new PatternLayout(LOG4CXX_STR("%m\n")));
+		RollingFileAppenderPtr rfa = RollingFileAppenderPtr(new RollingFileAppender());
+		rfa->setName(LOG4CXX_STR("ROLLING"));
+		rfa->setAppend(false);
+		rfa->setLayout(layout);
+		rfa->setMemoryMapped(true);
+		rfa->setMappedExtentSize(4096);
+		rfa->setFile(LOG4CXX_STR("output/sbr-testMapped.log"));
+
+		FixedWindowRollingPolicyPtr fwrp = FixedWindowRollingPolicyPtr(new FixedWindowRollingPolicy());
+		SizeBasedTriggeringPolicyPtr sbtp = SizeBasedTriggeringPolicyPtr(new SizeBasedTriggeringPolicy());
+
+		sbtp->setMaxFileSize(100);
+		fwrp->setMinIndex(0);
+		fwrp->setFileNamePattern(LOG4CXX_STR("output/sbr-testMapped.%i"));
+		Pool p;
+		fwrp->activateOptions(p);
+
+		rfa->setRollingPolicy(fwrp);
+		rfa->setTriggeringPolicy(sbtp);
+		rfa->activateOptions(p);
+		root->addAppender(rfa);
+
+		common(logger, 0);
+		rfa->close();
+
+		LOGUNIT_ASSERT_EQUAL(true, Compare::compare(File("output/sbr-testMapped.log"),
+				File("witness/rolling/sbr-test2.log")));
+		LOGUNIT_ASSERT_EQUAL(true, Compare::compare(File("output/sbr-testMapped.0"),
+				File("witness/rolling/sbr-test2.0")));
+		LOGUNIT_ASSERT_EQUAL(true, Compare::compare(File("output/sbr-testMapped.1"),
+				File("witness/rolling/sbr-test2.1")));
+	}
+
+	/**
+	 * Tests the events of a group before and after a rollover are each written with a single write.
+	 */
+	void testBatch()
+	{
+		auto rfa = std::make_shared<CountingRollingFileAppender>();
+		rfa->setAppend(false);
+		rfa->setLayout(std::make_shared<PatternLayout>(LOG4CXX_STR("%m\n")));
+		auto swrp = std::make_shared<FixedWindowRollingPolicy>();
+		auto sbtp = std::make_shared<SizeBasedTriggeringPolicy>();
+		sbtp->setMaxFileSize(100);
+		swrp->setMinIndex(0);
+		rfa->setFile(LOG4CXX_STR("output/sbr-testBatch.log"));
+		swrp->setFileNamePattern(LOG4CXX_STR("output/sbr-testBatch.%i"));
+		Pool p;
+		swrp->activateOptions(p);
+		rfa->setRollingPolicy(swrp);
+		rfa->setTriggeringPolicy(sbtp);
+		rfa->activateOptions(p);
+
+		// Each event is 10 bytes
+		spi::LoggingEventList events;
+
+		for (int i = 0; i < 10; i++)
+		{
+			events.push_back(std::make_shared<spi::LoggingEvent>(LOG4CXX_STR("batch"),
+				Level::getInfo(), LOG4CXX_STR("Hello----"),
+				spi::LocationInfo::getLocationUnavailable()));
+		}
+
+		rfa->doAppend(events, p);
+		LOGUNIT_ASSERT_EQUAL(1, rfa->writeCount);
+		events.resize(5);
+		rfa->doAppend(events, p);
+		LOGUNIT_ASSERT_EQUAL(2, rfa->writeCount);
+		rfa->close();
+
+		LOGUNIT_ASSERT_EQUAL((size_t) 50, File(LOG4CXX_STR("output/sbr-testBatch.log")).length(p));
+		LOGUNIT_ASSERT_EQUAL((size_t) 100, File(LOG4CXX_STR("output/sbr-testBatch.0")).length(p));
+	}
+
 };
 
 
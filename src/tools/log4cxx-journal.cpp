@@ -0,0 +1,133 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * Renders the events in files written by BinaryJournalAppender.
+ */
+#include <log4cxx/helpers/binaryjournalreader.h>
+#include <log4cxx/helpers/transcoder.h>
+#include <log4cxx/helpers/exception.h>
+#include <log4cxx/patternlayout.h>
+#include <log4cxx/jsonlayout.h>
+#include <iostream>
+#include <string.h>
+
+using namespace log4cxx;
+using namespace log4cxx::helpers;
+
+namespace
+{
+void usage(const char* program)
+{
+	std::cerr << "Usage: " << program << " [options] file..." << std::endl
+		<< "Writes the events in each BinaryJournalAppender file to standard output." << std::endl
+		<< "Options:" << std::endl
+		<< "  -p, --pattern PATTERN  use a PatternLayout with PATTERN" << std::endl
+		<< "                         (default \"%d [%t] %-5p %c - %m%n\")" << std::endl
+		<< "  -j, --json             use a JSONLayout" << std::endl
+		<< "  -l, --location         include location information in JSON output" << std::endl
+		<< "  -h, --help             show this message" << std::endl;
+}
+
+void render(const LayoutPtr& layout, const LogString& fileName)
+{
+	Pool p;
+	BinaryJournalReader reader(File().setPath(fileName));
+
+	while (auto event = reader.read())
+	{
+		LogString text;
+		layout->format(text, event, p);
+		LOG4CXX_ENCODE_CHAR(output, text);
+		std::cout << output;
+	}
+}
+}
+
+int main(int argc, char** argv)
+{
+	LogString pattern(LOG4CXX_STR("%d [%t] %-5p %c - %m%n"));
+	bool json = false;
+	bool locationInfo = false;
+	std::vector<LogString> fileNames;
+
+	for (int i = 1; i < argc; ++i)
+	{
+		const char* arg = argv[i];
+
+		if ((strcmp(arg, "-p") == 0 || strcmp(arg, "--pattern") == 0) && i + 1 < argc)
+		{
+			pattern = Transcoder::decode(argv[++i]);
+		}
+		else if (strcmp(arg, "-j") == 0 || strcmp(arg, "--json") == 0)
+		{
+			json = true;
+		}
+		else if (strcmp(arg, "-l") == 0 || strcmp(arg, "--location") == 0)
+		{
+			locationInfo = true;
+		}
+		else if (arg[0] == '-')
+		{
+			usage(argv[0]);
+			return strcmp(arg, "-h") == 0 || strcmp(arg, "--help") == 0 ? 0 : 1;
+		}
+		else
+		{
+			fileNames.push_back(Transcoder::decode(arg));
+		}
+	}
+
+	if (fileNames.empty())
+	{
+		usage(argv[0]);
+		return 1;
+	}
+
+	LayoutPtr layout;
+
+	if (json)
+	{
+		auto jsonLayout = std::make_shared<JSONLayout>();
+		jsonLayout->setLocationInfo(locationInfo);
+		Pool p;
+		jsonLayout->activateOptions(p);
+		layout = jsonLayout;
+	}
+	else
+	{
+		layout = std::make_shared<PatternLayout>(pattern);
+	}
+
+	int result = 0;
+
+	for (auto& fileName : fileNames)
+	{
+		try
+		{
+			render(layout, fileName);
+		}
+		catch (std::exception& e)
+		{
+			std::cout.flush();
+			std::cerr << argv[0] << ": " << e.what() << std::endl;
+			result = 1;
+		}
+	}
+
+	return result;
+}